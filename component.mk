@@ -4,5 +4,10 @@ COMPONENT_DEPENDS := \
 COMPONENT_SRCDIRS := \
 	src
 
+ifeq ($(SMING_ARCH),Host)
+COMPONENT_SRCDIRS += \
+	src/Emulator
+endif
+
 COMPONENT_INCDIRS := \
 	src/include
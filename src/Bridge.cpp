@@ -0,0 +1,251 @@
+#include "include/Graphics/EVE/Bridge.h"
+
+namespace Graphics::EVE
+{
+using namespace BridgeProtocol;
+
+namespace
+{
+const char* toString(Status status)
+{
+	switch(status) {
+	case Status::ok:
+		return "OK";
+	case Status::badFrame:
+		return "Bad frame";
+	case Status::badAddress:
+		return "Bad address";
+	case Status::fifoTimeout:
+		return "FIFO timeout";
+	}
+	return "Error";
+}
+
+} // namespace
+
+Bridge::~Bridge()
+{
+	if(!slots) {
+		return;
+	}
+	for(unsigned i = 0; i < window; ++i) {
+		if(slots[i].pending) {
+			display.wait(slots[i].request);
+		}
+	}
+}
+
+void Bridge::handleFrame(const uint8_t* data, size_t length)
+{
+	if(!slots) {
+		const unsigned slotWords = maxPayload / 4;
+		slots.reset(new Slot[window]{});
+		buffer.reset(new uint32_t[(window + 1) * slotWords + 3]);
+		for(unsigned i = 0; i < window; ++i) {
+			slots[i].data = &buffer[i * slotWords];
+		}
+		readBuffer = &buffer[window * slotWords];
+	}
+
+	uint32_t hdr[4]{};
+	memcpy(hdr, data, std::min(length, sizeof(hdr)));
+
+	switch(hdr[0]) {
+	case magicWrite:
+		if(length >= 12 && hdr[2] == length - 12) {
+			legacyWrite(hdr[1], data + 12, hdr[2]);
+			return;
+		}
+		break;
+
+	case magicRead:
+		if(length == 12) {
+			read(magicRead, 0, hdr[1], hdr[2]);
+			return;
+		}
+		break;
+
+	case magicHello:
+		hello();
+		return;
+
+	case magicSeqWrite:
+		if(length >= 16 && hdr[3] == length - 16) {
+			seqWrite(hdr[1], hdr[2], data + 16, hdr[3]);
+		} else {
+			sendAck(hdr[1], Status::badFrame);
+		}
+		return;
+
+	case magicSeqRead:
+		if(length == 16) {
+			read(magicSeqRead, hdr[1], hdr[2], hdr[3]);
+		} else {
+			sendAck(hdr[1], Status::badFrame);
+		}
+		return;
+	}
+
+	debug_w("[EVE] Bridge: bad frame, %u bytes", unsigned(length));
+	auto msg = toString(Status::badFrame);
+	send(msg, strlen(msg), false);
+}
+
+void Bridge::reset()
+{
+	if(slots) {
+		drain();
+	}
+	ackDue = false;
+}
+
+void Bridge::hello()
+{
+	reset();
+	const uint32_t reply[]{magicHello, version, window, maxPayload};
+	sendWords(reply, ARRAY_SIZE(reply));
+}
+
+Bridge::Status Bridge::checkRange(uint32_t address, size_t length) const
+{
+	if(length > maxPayload) {
+		return Status::badFrame;
+	}
+	if(length != 0 && !EveDisplay::addrValid(address + length - 1)) {
+		return Status::badAddress;
+	}
+	if(address == REG_CMDB_WRITE && (length % 4) != 0) {
+		return Status::badAddress;
+	}
+	return Status::ok;
+}
+
+bool Bridge::writeCommands(const uint8_t* data, size_t length)
+{
+	// Called with no writes in flight, so any slot can be used to align the data
+	auto& slot = slots[head];
+	memcpy(slot.data, data, length);
+	return display.sendCommands(slot.data, length / 4);
+}
+
+void Bridge::seqWrite(uint32_t seq, uint32_t address, const uint8_t* data, size_t length)
+{
+	auto status = checkRange(address, length);
+	if(status != Status::ok) {
+		sendAck(seq, status);
+		return;
+	}
+
+	if(address == REG_CMDB_WRITE) {
+		drain();
+		if(!writeCommands(data, length)) {
+			sendAck(seq, Status::fifoTimeout);
+			return;
+		}
+		completedSeq = seq;
+		sendAck(seq, Status::ok);
+		return;
+	}
+
+	auto& slot = slots[head];
+	if(slot.pending) {
+		// Client has exceeded the window
+		display.wait(slot.request);
+		retire();
+	}
+	memcpy(slot.data, data, length);
+	slot.seq = seq;
+	slot.pending = true;
+	head = (head + 1) % window;
+	++inFlight;
+	display.write(slot.request, address, slot.data, length, writeComplete, this);
+}
+
+void Bridge::legacyWrite(uint32_t address, const uint8_t* data, size_t length)
+{
+	auto status = checkRange(address, length);
+	if(status == Status::ok) {
+		drain();
+		if(address == REG_CMDB_WRITE) {
+			if(!writeCommands(data, length)) {
+				status = Status::fifoTimeout;
+			}
+		} else {
+			display.write(address, data, length);
+		}
+	}
+	auto msg = toString(status);
+	send(msg, strlen(msg), false);
+}
+
+void Bridge::read(uint32_t magic, uint32_t seq, uint32_t address, uint32_t length)
+{
+	auto status = checkRange(address, length);
+	if(status == Status::ok) {
+		drain();
+		display.read(address, &readBuffer[3], length);
+	}
+
+	if(magic == magicRead) {
+		if(status == Status::ok) {
+			send(&readBuffer[3], length, true);
+		} else {
+			auto msg = toString(status);
+			send(msg, strlen(msg), false);
+		}
+		return;
+	}
+
+	readBuffer[0] = magicData;
+	readBuffer[1] = seq;
+	readBuffer[2] = uint32_t(status);
+	send(readBuffer, 12 + (status == Status::ok ? length : 0), true);
+}
+
+bool Bridge::writeComplete(HSPI::Request& request)
+{
+	// May be in interrupt context
+	static_cast<Bridge*>(request.param)->task.queue();
+	return true;
+}
+
+void Bridge::retire()
+{
+	while(inFlight != 0) {
+		auto& slot = slots[tail];
+		if(slot.request.busy) {
+			break;
+		}
+		slot.pending = false;
+		completedSeq = slot.seq;
+		ackDue = true;
+		tail = (tail + 1) % window;
+		--inFlight;
+	}
+	if(ackDue) {
+		sendAck(completedSeq, Status::ok);
+	}
+}
+
+void Bridge::drain()
+{
+	for(unsigned i = 0; i < window; ++i) {
+		if(slots[i].pending) {
+			display.wait(slots[i].request);
+		}
+	}
+	retire();
+}
+
+void Bridge::sendAck(uint32_t seq, Status status)
+{
+	if(status == Status::ok) {
+		ackDue = false;
+	} else {
+		debug_w("[EVE] Bridge: frame %u failed, %s", seq, toString(status));
+	}
+	const uint32_t reply[]{magicAck, seq, uint32_t(status)};
+	sendWords(reply, ARRAY_SIZE(reply));
+}
+
+} // namespace Graphics::EVE
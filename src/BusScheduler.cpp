@@ -0,0 +1,322 @@
+#include "include/Graphics/EVE/BusScheduler.h"
+#include <Clock.h>
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Interval before retrying frames blocked on FIFO space
+constexpr unsigned retryIntervalMs{1};
+
+bool before(uint32_t a, uint32_t b)
+{
+	return int32_t(a - b) < 0;
+}
+
+} // namespace
+
+BusScheduler::~BusScheduler()
+{
+	timer.stop();
+	if(current != nullptr) {
+		current->device->display->wait(request);
+	}
+	for(auto& dev : devices) {
+		if(dev.display != nullptr && dev.framePending) {
+			dev.display->lockCommands(false);
+		}
+	}
+}
+
+bool BusScheduler::attach(EveDisplay& display, uint8_t frameRate)
+{
+	if(frameRate == 0 || findDevice(display) != nullptr) {
+		return false;
+	}
+	if(chunkSize == 0 || chunkSize % 4 != 0) {
+		debug_e("[EVE] BusScheduler: chunk size must be a non-zero multiple of 4");
+		return false;
+	}
+	for(auto& dev : devices) {
+		if(dev.display != nullptr) {
+			continue;
+		}
+		dev = Device{};
+		dev.display = &display;
+		dev.period = 1000000U / frameRate;
+		dev.nextFrame = micros() + dev.period;
+		timer.initializeMs(
+			retryIntervalMs,
+			[](void* param) {
+				auto self = static_cast<BusScheduler*>(param);
+				for(unsigned i = 0; i < self->maxJobs; ++i) {
+					self->jobs[i].blocked = false;
+				}
+				self->schedule();
+			},
+			this);
+		return true;
+	}
+	debug_e("[EVE] BusScheduler: too many displays");
+	return false;
+}
+
+void BusScheduler::detach(EveDisplay& display)
+{
+	auto dev = findDevice(display);
+	if(dev == nullptr) {
+		return;
+	}
+	if(current != nullptr && current->device == dev) {
+		display.wait(request);
+		current = nullptr;
+		state = State::idle;
+	}
+	for(unsigned i = 0; i < maxJobs; ++i) {
+		if(jobs[i].kind != Kind::none && jobs[i].device == dev) {
+			finish(jobs[i], false);
+		}
+	}
+	dev->display = nullptr;
+	schedule();
+}
+
+bool BusScheduler::isFrameDue(EveDisplay& display)
+{
+	auto dev = findDevice(display);
+	return dev != nullptr && !dev->framePending && !before(micros(), dev->nextFrame - dev->period);
+}
+
+bool BusScheduler::sendFrame(EveDisplay& display, const CommandList& list, Callback callback)
+{
+	auto dev = findDevice(display);
+	if(dev == nullptr || dev->framePending || list.length() == 0) {
+		return false;
+	}
+	if(addJob(*dev, Kind::frame, list.data(), list.length() * sizeof(uint32_t), dev->nextFrame, callback) == nullptr) {
+		return false;
+	}
+	dev->framePending = true;
+	schedule();
+	return true;
+}
+
+bool BusScheduler::upload(EveDisplay& display, uint32_t address, const void* data, size_t length, Callback callback,
+						  unsigned deadlineMs)
+{
+	auto dev = findDevice(display);
+	if(dev == nullptr || length == 0) {
+		return false;
+	}
+	auto job = addJob(*dev, Kind::upload, data, length, micros() + deadlineMs * 1000, callback);
+	if(job == nullptr) {
+		return false;
+	}
+	job->address = address;
+	schedule();
+	return true;
+}
+
+BusScheduler::Device* BusScheduler::findDevice(EveDisplay& display)
+{
+	for(auto& dev : devices) {
+		if(dev.display == &display) {
+			return &dev;
+		}
+	}
+	return nullptr;
+}
+
+BusScheduler::Job* BusScheduler::addJob(Device& device, Kind kind, const void* data, size_t length, uint32_t deadline,
+										Callback callback)
+{
+	for(unsigned i = 0; i < maxJobs; ++i) {
+		auto& job = jobs[i];
+		if(job.kind != Kind::none) {
+			continue;
+		}
+		job = Job{&device, static_cast<const uint8_t*>(data), 0, uint32_t(length), 0, deadline, callback, kind, false};
+		return &job;
+	}
+	debug_e("[EVE] BusScheduler: job table full");
+	return nullptr;
+}
+
+BusScheduler::Job* BusScheduler::select()
+{
+	Job* next{nullptr};
+	for(unsigned i = 0; i < maxJobs; ++i) {
+		auto& job = jobs[i];
+		if(job.kind == Kind::none || job.blocked) {
+			continue;
+		}
+		if(next == nullptr || before(job.deadline, next->deadline)) {
+			next = &job;
+		}
+	}
+	return next;
+}
+
+void BusScheduler::schedule()
+{
+	if(state != State::idle) {
+		return;
+	}
+	current = select();
+	if(current == nullptr) {
+		return;
+	}
+	if(current->kind == Kind::frame) {
+		// Nothing else may take FIFO space between reading REG_CMDB_SPACE and the write
+		current->device->display->lockCommands(true);
+		state = State::space;
+		current->device->display->read(request, REG_CMDB_SPACE, &space, sizeof(space), requestComplete, this);
+		return;
+	}
+	writeChunk(chunkSize);
+}
+
+void BusScheduler::writeChunk(uint16_t maxLength)
+{
+	auto& job = *current;
+	auto& display = *job.device->display;
+	lastChunk = std::min(job.length - job.offset, uint32_t(std::min(chunkSize, maxLength)));
+	state = State::writing;
+	++job.device->stats.chunks;
+	job.device->stats.bytes += lastChunk;
+	if(job.kind == Kind::frame) {
+		display.writeCommands(request, reinterpret_cast<const uint32_t*>(job.data + job.offset),
+							  lastChunk / sizeof(uint32_t), requestComplete, this);
+	} else {
+		display.write(request, job.address + job.offset, job.data + job.offset, lastChunk, requestComplete, this);
+	}
+}
+
+bool BusScheduler::requestComplete(HSPI::Request& request)
+{
+	// May be in interrupt context
+	static_cast<BusScheduler*>(request.param)->task.queue();
+	return true;
+}
+
+void BusScheduler::process()
+{
+	switch(state) {
+	case State::idle:
+		// Job abandoned
+		return;
+
+	case State::space:
+		space &= 0x0ffc;
+		if(space == 0) {
+			// Let other jobs use the bus until the co-processor catches up
+			current->blocked = true;
+			state = State::idle;
+			schedule();
+			timer.startOnce();
+			return;
+		}
+		writeChunk(space);
+		return;
+
+	case State::writing: {
+		state = State::idle;
+		auto& job = *current;
+		current = nullptr;
+		job.offset += lastChunk;
+		if(job.offset >= job.length) {
+			finish(job, true);
+		}
+		schedule();
+		return;
+	}
+	}
+}
+
+void BusScheduler::finish(Job& job, bool success)
+{
+	auto& dev = *job.device;
+	if(job.kind == Kind::frame) {
+		dev.framePending = false;
+		dev.display->lockCommands(false);
+		auto now = micros();
+		if(success) {
+			++dev.stats.frames;
+			if(before(job.deadline, now)) {
+				++dev.stats.lateFrames;
+			}
+		}
+		dev.nextFrame += dev.period;
+		if(!before(now, dev.nextFrame)) {
+			// Fell behind, so re-synchronise rather than sending a burst of frames
+			dev.nextFrame = now + dev.period;
+		}
+	} else if(success) {
+		++dev.stats.uploads;
+	}
+
+	auto callback = job.callback;
+	job.callback = nullptr;
+	job.kind = Kind::none;
+	if(callback) {
+		callback(success);
+	}
+}
+
+Stats::Transfer BusScheduler::getTotal() const
+{
+	Stats::Transfer total{};
+	for(auto& dev : devices) {
+		if(dev.display == nullptr) {
+			continue;
+		}
+		auto& stats = dev.display->getStats();
+		for(auto& t : {stats.spi, stats.dual, stats.quad}) {
+			total.transactions += t.transactions;
+			total.bytes += t.bytes;
+		}
+	}
+	return total;
+}
+
+size_t BusScheduler::printTo(Print& p) const
+{
+	size_t n{0};
+	char sep{'{'};
+
+	auto field = [&](const char* name, uint32_t value) {
+		n += p.print(sep);
+		n += p.print('"');
+		n += p.print(name);
+		n += p.print("\":");
+		n += p.print(value);
+		sep = ',';
+	};
+
+	auto total = getTotal();
+	field("transactions", total.transactions);
+	field("bytes", total.bytes);
+	n += p.print(",\"devices\":[");
+	bool first{true};
+	for(auto& dev : devices) {
+		if(dev.display == nullptr) {
+			continue;
+		}
+		if(!first) {
+			n += p.print(',');
+		}
+		first = false;
+		sep = '{';
+		field("frames", dev.stats.frames);
+		field("late_frames", dev.stats.lateFrames);
+		field("uploads", dev.stats.uploads);
+		field("chunks", dev.stats.chunks);
+		field("bytes", dev.stats.bytes);
+		n += p.print('}');
+	}
+	n += p.print("]}");
+
+	return n;
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,152 @@
+#include "include/Graphics/EVE/Calibration.h"
+#include "include/Graphics/EVE/CommandList.h"
+#include "include/Graphics/EVE/Crc.h"
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Interval between checks whilst waiting for the user
+constexpr unsigned pollIntervalMs{50};
+
+constexpr uint32_t recordMagic{0x43545645}; // "EVTC"
+
+constexpr unsigned promptFont{27};
+
+} // namespace
+
+struct Calibration::Record {
+	uint32_t magic;
+	uint32_t displaySize; ///< REG_HSIZE | REG_VSIZE << 16
+	Transform transform;
+	uint32_t crc; ///< Over preceding fields
+};
+
+uint32_t Calibration::getDisplaySize()
+{
+	return display.read16(REG_HSIZE) | (uint32_t(display.read16(REG_VSIZE)) << 16);
+}
+
+bool Calibration::begin(Callback callback, bool force)
+{
+	if(!force && restore()) {
+		return true;
+	}
+	if(!calibrate(callback) && callback) {
+		// Caller expects a callback whenever stored values weren't used
+		callback(false);
+	}
+	return false;
+}
+
+bool Calibration::restore()
+{
+	Transform transform;
+	if(!load(transform)) {
+		return false;
+	}
+	write(transform);
+	return true;
+}
+
+bool Calibration::load(Transform& transform)
+{
+	Record rec{};
+	if(!partition || !partition.read(offset, &rec, sizeof(rec))) {
+		return false;
+	}
+	if(rec.magic != recordMagic || rec.crc != crc32(&rec, offsetof(Record, crc))) {
+		debug_w("[EVE] No stored calibration");
+		return false;
+	}
+	if(rec.displaySize != getDisplaySize()) {
+		debug_w("[EVE] Stored calibration is for a different display size");
+		return false;
+	}
+	transform = rec.transform;
+	return true;
+}
+
+bool Calibration::save(const Transform& transform)
+{
+	Record rec{recordMagic, getDisplaySize(), transform, 0};
+	rec.crc = crc32(&rec, offsetof(Record, crc));
+	if(!clear() || !partition.write(offset, &rec, sizeof(rec))) {
+		debug_e("[EVE] Failed to store calibration");
+		return false;
+	}
+	return true;
+}
+
+bool Calibration::clear()
+{
+	return partition && partition.erase_range(offset, partition.getBlockSize());
+}
+
+bool Calibration::calibrate(Callback callback, const char* prompt)
+{
+	if(isBusy()) {
+		debug_e("[EVE] Calibration already in progress");
+		return false;
+	}
+
+	auto size = getDisplaySize();
+	CommandList list(64);
+	list.addCommand(CMD_DLSTART);
+	list.add(CLEAR(true, true, true));
+	if(prompt != nullptr) {
+		list.addCommand(CMD_TEXT, MAKE_COPROC_PARAM16((size & 0xffff) / 2, (size >> 16) / 4),
+						MAKE_COPROC_PARAM16(promptFont, EVE_OPT_CENTER));
+		list.addString(prompt);
+	}
+	list.addCommand(CMD_CALIBRATE, 0);
+	if(!display.sendCommands(list)) {
+		return false;
+	}
+
+	this->callback = callback;
+	fifoMark = display.getFifoPosition() & EVE_CMDFIFO_MASK;
+	timer.initializeMs(
+		pollIntervalMs, [](void* param) { static_cast<Calibration*>(param)->poll(); }, this);
+	timer.startOnce();
+	return true;
+}
+
+void Calibration::poll()
+{
+	switch(display.getFifoProgress(fifoMark)) {
+	case EveDisplay::FifoProgress::pending:
+		timer.startOnce();
+		return;
+	case EveDisplay::FifoProgress::fault:
+		debug_e("[EVE] Calibration: co-processor fault");
+		display.checkFault();
+		complete(false);
+		return;
+	case EveDisplay::FifoProgress::passed:
+		break;
+	}
+
+	// Result replaces the CMD_CALIBRATE parameter, zero on failure
+	auto result = display.readResult(fifoMark);
+	if(result == 0) {
+		debug_e("[EVE] Calibration failed");
+		complete(false);
+		return;
+	}
+
+	Transform transform;
+	read(transform);
+	complete(save(transform));
+}
+
+void Calibration::complete(bool success)
+{
+	timer.stop();
+	fifoMark = -1;
+	if(callback) {
+		callback(success);
+	}
+}
+
+} // namespace Graphics::EVE
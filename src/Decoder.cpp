@@ -0,0 +1,433 @@
+#include "include/Graphics/EVE/Decoder.h"
+#include "include/Graphics/EVE/EVE.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+#ifdef ARCH_HOST
+#include "Emulator/Inflate.h"
+#endif
+
+namespace Graphics::EVE
+{
+using namespace Schema;
+
+namespace
+{
+struct Region {
+	uint32_t start;
+	uint32_t size;
+};
+
+constexpr Region memoryMap[]{
+	{EVE_RAM_G, EVE_RAM_G_SIZE},
+	{EVE_ROM_FONT, EVE_RAM_DL - EVE_ROM_FONT},
+	{EVE_RAM_DL, EVE_RAM_DL_SIZE},
+	{EVE_RAM_REG, 0x1000},
+	{EVE_RAM_CMD, EVE_CMDFIFO_SIZE},
+};
+
+constexpr uint32_t maxListWords{EVE_RAM_DL_SIZE / 4};
+
+constexpr uint32_t align4(uint32_t value)
+{
+	return (value + 3) & ~3U;
+}
+
+bool validRange(uint32_t address, uint32_t length)
+{
+	for(auto& r : memoryMap) {
+		if(address >= r.start && address - r.start < r.size) {
+			return length <= r.size - (address - r.start);
+		}
+	}
+	return false;
+}
+
+class Writer
+{
+public:
+	Writer(char* buffer, size_t size) : buffer(buffer), size(size)
+	{
+		if(size != 0) {
+			buffer[0] = '\0';
+		}
+	}
+
+	void print(const char* fmt, ...) __attribute__((format(printf, 2, 3)))
+	{
+		va_list args;
+		va_start(args, fmt);
+		int n = vsnprintf(buffer + std::min(length, size), length < size ? size - length : 0, fmt, args);
+		va_end(args);
+		if(n > 0) {
+			length += n;
+		}
+	}
+
+	size_t getLength() const
+	{
+		return length;
+	}
+
+private:
+	char* buffer;
+	size_t size;
+	size_t length{0};
+};
+
+} // namespace
+
+int32_t Decoder::Command::getValue(unsigned paramIndex) const
+{
+	auto& param = def->params[paramIndex];
+	uint32_t value;
+	if(coprocessor) {
+		auto d = data + param.offset;
+		value = d[0] | (d[1] << 8);
+		if(param.bitcount > 16) {
+			value |= (d[2] << 16) | (uint32_t(d[3]) << 24);
+		}
+	} else {
+		value = word() >> param.offset;
+	}
+	if(param.bitcount < 32) {
+		const unsigned shift = 32 - param.bitcount;
+		value <<= shift;
+		return (param.flags & flagSigned) ? int32_t(value) >> shift : int32_t(value >> shift);
+	}
+	return value;
+}
+
+Decoder::Decoder(Source source, Handler* handler) : source(source), handler(handler)
+{
+}
+
+Decoder::~Decoder() = default;
+
+void Decoder::reset()
+{
+	stats = Stats{};
+	streamOffset = 0;
+	pending = 0;
+	startList();
+}
+
+void Decoder::startList()
+{
+	listWords = 0;
+	primitive = false;
+	overflow = false;
+}
+
+void Decoder::report(const Command* cmd, uint32_t offset, Issue issue)
+{
+	++stats.issues;
+	if(handler != nullptr) {
+		handler->issue(cmd, offset, issue);
+	}
+}
+
+size_t Decoder::decode(const void* data, size_t length)
+{
+	auto start = static_cast<const uint8_t*>(data);
+	auto end = start + length;
+	auto ptr = start;
+	while(end - ptr >= 4) {
+		Command cmd{};
+		cmd.data = ptr;
+		cmd.offset = streamOffset + (ptr - start);
+		if(!decodeCommand(cmd, end)) {
+			break;
+		}
+		if(handler != nullptr) {
+			handler->command(cmd);
+		}
+		check(cmd);
+		ptr += cmd.length;
+	}
+
+	const size_t consumed = ptr - start;
+	streamOffset += consumed;
+	stats.bytes += consumed;
+	pending = length - consumed;
+	return consumed;
+}
+
+void Decoder::finish()
+{
+	if(pending != 0) {
+		report(nullptr, streamOffset, pending < 4 ? Issue::misaligned : Issue::truncated);
+		pending = 0;
+	}
+	if(primitive) {
+		report(nullptr, streamOffset, Issue::missingEnd);
+		primitive = false;
+	}
+}
+
+bool Decoder::decodeCommand(Command& cmd, const uint8_t* end)
+{
+	const uint32_t word = cmd.word();
+	cmd.length = 4;
+
+	if(source == Source::commands && (word >> 8) == 0x00ffffff) {
+		cmd.coprocessor = true;
+		auto index = coprocessorIndex[word & 0xff];
+		if(index == 0xff) {
+			return true;
+		}
+		cmd.def = &coprocessorCommands[index];
+		cmd.length = cmd.def->size;
+		if(end - cmd.data < cmd.length) {
+			return false;
+		}
+		if(cmd.def->paramCount == 0) {
+			return true;
+		}
+		// Variable-length content is always the last parameter
+		auto& last = cmd.def->params[cmd.def->paramCount - 1];
+		if(last.type == Type::cstring || last.type == Type::dataBlock) {
+			return coprocessorPayload(cmd, last, end);
+		}
+		return true;
+	}
+
+	auto index = displayListIndex[word >> 24];
+	if(index != 0xff) {
+		cmd.def = &displayListCommands[index];
+	}
+	return true;
+}
+
+bool Decoder::coprocessorPayload(Command& cmd, const Param& param, const uint8_t* end)
+{
+	cmd.payload = cmd.data + param.offset;
+	const size_t available = end - cmd.payload;
+
+	if(param.type == Type::cstring) {
+		auto nul = static_cast<const uint8_t*>(memchr(cmd.payload, '\0', available));
+		if(nul == nullptr) {
+			return false;
+		}
+		cmd.payloadLength = nul - cmd.payload;
+		cmd.length = align4(param.offset + cmd.payloadLength + 1);
+		return cmd.length <= size_t(end - cmd.data);
+	}
+
+	if(param.lengthParam >= 0) {
+		cmd.payloadLength = cmd.getValue(param.lengthParam);
+		// Padded length, calculated in 64 bits as the length parameter comes from the stream
+		const uint64_t length = (uint64_t(param.offset) + cmd.payloadLength + 3) & ~uint64_t(3);
+		if(length > uint64_t(end - cmd.data)) {
+			return false;
+		}
+		cmd.length = length;
+		return true;
+	}
+
+	// CMD_INFLATE: length known only by decompressing
+#ifdef ARCH_HOST
+	if(!inflateBuffer) {
+		inflateBuffer.reset(new uint8_t[EVE_RAM_G_SIZE]);
+	}
+	Inflate inflater;
+	auto res = inflater.run(cmd.payload, available, inflateBuffer.get(), EVE_RAM_G_SIZE);
+	if(res == Inflate::Result::needInput) {
+		return false;
+	}
+	if(res == Inflate::Result::ok) {
+		cmd.payloadLength = inflater.getInputUsed();
+		cmd.length = align4(param.offset + cmd.payloadLength);
+		inflateOutput = inflater.getOutputLength();
+		return cmd.length <= size_t(end - cmd.data);
+	}
+	badStream = true;
+#endif
+	// Cannot resynchronise, so take everything
+	cmd.payloadLength = available;
+	cmd.length = end - cmd.data;
+	return true;
+}
+
+void Decoder::check(const Command& cmd)
+{
+	if(cmd.def == nullptr) {
+		report(&cmd, cmd.offset, Issue::unknownCommand);
+		return;
+	}
+
+	checkAddresses(cmd);
+	if(!cmd.coprocessor) {
+		displayListWord(cmd);
+		return;
+	}
+
+	++stats.coprocessorCommands;
+	if(badStream) {
+		report(&cmd, cmd.offset, Issue::badData);
+		badStream = false;
+	}
+	for(unsigned i = 0; i < cmd.def->paramCount; ++i) {
+		auto& param = cmd.def->params[i];
+		if((param.flags & flagAligned) && (cmd.getValue(i) & 3) != 0) {
+			report(&cmd, cmd.offset + param.offset, Issue::misaligned);
+		}
+	}
+
+	switch(cmd.def->code) {
+	case CMD_DLSTART:
+		startList();
+		break;
+	case CMD_SWAP:
+		if(primitive) {
+			report(&cmd, cmd.offset, Issue::missingEnd);
+		}
+		primitive = false;
+		break;
+	default:;
+	}
+}
+
+void Decoder::checkAddresses(const Command& cmd)
+{
+	uint32_t length{0};
+	if(cmd.coprocessor) {
+		if(cmd.def->code == CMD_INFLATE) {
+			length = inflateOutput;
+			inflateOutput = 0;
+		}
+		for(unsigned i = 0; i < cmd.def->paramCount; ++i) {
+			if(cmd.def->params[i].type == Type::length) {
+				length = cmd.getValue(i);
+			}
+		}
+	}
+	for(unsigned i = 0; i < cmd.def->paramCount; ++i) {
+		auto& param = cmd.def->params[i];
+		if(param.type == Type::address && !validRange(cmd.getValue(i), length)) {
+			report(&cmd, cmd.offset + (cmd.coprocessor ? param.offset : 0), Issue::badAddress);
+		}
+	}
+}
+
+void Decoder::displayListWord(const Command& cmd)
+{
+	++stats.displayListWords;
+	++listWords;
+	if(listWords > maxListWords && !overflow) {
+		report(&cmd, cmd.offset, Issue::dlOverflow);
+		overflow = true;
+	}
+
+	switch(cmd.def->code) {
+	case DL_BEGIN:
+		if(primitive) {
+			report(&cmd, cmd.offset, Issue::nestedBegin);
+		}
+		primitive = true;
+		break;
+	case DL_END:
+		if(!primitive) {
+			report(&cmd, cmd.offset, Issue::endWithoutBegin);
+		}
+		primitive = false;
+		break;
+	case DL_CALL:
+	case DL_JUMP:
+		if(uint32_t(cmd.getValue(0)) >= maxListWords) {
+			report(&cmd, cmd.offset, Issue::badAddress);
+		}
+		break;
+	case DL_DISPLAY:
+		if(primitive) {
+			report(&cmd, cmd.offset, Issue::missingEnd);
+		}
+		if(source == Source::displayList) {
+			startList();
+		} else {
+			primitive = false;
+		}
+		break;
+	default:;
+	}
+}
+
+size_t Decoder::format(const Command& cmd, char* buffer, size_t bufSize)
+{
+	Writer out(buffer, bufSize);
+
+	if(cmd.def == nullptr) {
+		if(cmd.coprocessor) {
+			out.print("CMD_0x%02x", cmd.data[0]);
+		} else {
+			out.print("0x%08x", cmd.word());
+		}
+		return out.getLength();
+	}
+
+	out.print(cmd.coprocessor ? "CMD_%s(" : "%s(", cmd.def->name);
+	for(unsigned i = 0; i < cmd.def->paramCount; ++i) {
+		auto& param = cmd.def->params[i];
+		out.print(i ? ", %s=" : "%s=", param.name);
+		switch(param.type) {
+		case Type::address:
+			out.print("0x%06x", unsigned(cmd.getValue(i)));
+			break;
+		case Type::color:
+			out.print("0x%06x", unsigned(cmd.getValue(i)) & 0xffffff);
+			break;
+		case Type::cstring: {
+			constexpr unsigned maxChars{64};
+			char s[maxChars + 1];
+			unsigned n = std::min(cmd.payloadLength, maxChars);
+			for(unsigned j = 0; j < n; ++j) {
+				char c = cmd.payload[j];
+				s[j] = (c >= 0x20 && c < 0x7f) ? c : '.';
+			}
+			s[n] = '\0';
+			out.print("\"%s%s\"", s, n < cmd.payloadLength ? "..." : "");
+			break;
+		}
+		case Type::dataBlock:
+			out.print("[%u bytes]", unsigned(cmd.payloadLength));
+			break;
+		default:
+			if(param.flags & flagSigned) {
+				out.print("%d", int(cmd.getValue(i)));
+			} else {
+				out.print("%u", unsigned(cmd.getValue(i)));
+			}
+		}
+	}
+	out.print(")");
+	return out.getLength();
+}
+
+const char* Decoder::toString(Issue issue)
+{
+	switch(issue) {
+	case Issue::unknownCommand:
+		return "unknown command";
+	case Issue::truncated:
+		return "truncated command";
+	case Issue::misaligned:
+		return "misaligned";
+	case Issue::badAddress:
+		return "address out of range";
+	case Issue::badData:
+		return "invalid compressed data";
+	case Issue::nestedBegin:
+		return "BEGIN without END";
+	case Issue::endWithoutBegin:
+		return "END without BEGIN";
+	case Issue::missingEnd:
+		return "primitive not ended";
+	case Issue::dlOverflow:
+		return "display list overflow";
+	}
+	return "?";
+}
+
+} // namespace Graphics::EVE
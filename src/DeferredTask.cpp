@@ -0,0 +1,42 @@
+#include "include/Graphics/EVE/DeferredTask.h"
+#include <Platform/System.h>
+
+namespace Graphics::EVE
+{
+DeferredTask::DeferredTask(Handler handler, void* owner) : token(new Token{handler, owner, false})
+{
+}
+
+DeferredTask::~DeferredTask()
+{
+	if(token->queued) {
+		// Task frees the token when it runs
+		token->owner = nullptr;
+	} else {
+		delete token;
+	}
+}
+
+void DeferredTask::queue()
+{
+	if(token->queued) {
+		return;
+	}
+	token->queued = true;
+	if(!System.queueCallback(run, token)) {
+		token->queued = false;
+	}
+}
+
+void DeferredTask::run(void* param)
+{
+	auto token = static_cast<Token*>(param);
+	token->queued = false;
+	if(token->owner == nullptr) {
+		delete token;
+		return;
+	}
+	token->handler(token->owner);
+}
+
+} // namespace Graphics::EVE
@@ -1,6 +1,8 @@
 #include "include/Graphics/EVE/Display.h"
+#include "include/Graphics/EVE/Trace.h"
 #include <Clock.h>
 #include <Platform/Timers.h>
+#include <algorithm>
 
 namespace Graphics
 {
@@ -11,6 +13,7 @@ bool EveDisplay::begin(HSPI::PinSet pinSet, uint8_t chipSelect, uint32_t spiCloc
 	if(!MemoryDevice::begin(pinSet, chipSelect, spiClockSpeed)) {
 		return false;
 	}
+	resetStats();
 	setBitOrder(MSBFIRST);
 	setClockMode(HSPI::ClockMode::mode0);
 	MemoryDevice::setIoMode(HSPI::IoMode::SPIHD);
@@ -19,6 +22,8 @@ bool EveDisplay::begin(HSPI::PinSet pinSet, uint8_t chipSelect, uint32_t spiCloc
 	cmdWrite(config.extclk ? HostCommand::CLKEXT : HostCommand::CLKINT, 0);
 
 	cmdWrite(HostCommand::RST_PULSE, 0);
+	fifoPosition = 0;
+	interruptMask = 0;
 	cmdWrite(HostCommand::ACTIVE, 0);
 
 	// Set DISP, GPIO2, GPIO3 to output
@@ -29,6 +34,7 @@ bool EveDisplay::begin(HSPI::PinSet pinSet, uint8_t chipSelect, uint32_t spiCloc
 	timer.reset<400>();
 	uint8_t b;
 	while((b = read8(REG_ID)) != 0x7c) {
+		++stats.pollReads;
 		if(b != 0 && b != 0xff) {
 			debug_i("[EVE] GOT 0x%02x", b);
 		}
@@ -41,25 +47,17 @@ bool EveDisplay::begin(HSPI::PinSet pinSet, uint8_t chipSelect, uint32_t spiCloc
 	// Wait for reset complete
 	timer.reset<50>();
 	while((read8(REG_CPURESET) & 0x07) != 0) {
+		++stats.pollReads;
 		if(timer.expired()) {
 			return false;
 		}
 	}
 
 	/* Initialize display parameters */
-	write16(REG_HSIZE, config.hsize);
-	write16(REG_HCYCLE, config.hcycle);
-	write16(REG_HOFFSET, config.hoffset);
-	write16(REG_HSYNC0, config.hsync0);
-	write16(REG_HSYNC1, config.hsync1);
-	write16(REG_VSIZE, config.vsize);
-	write16(REG_VCYCLE, config.vcycle);
-	write16(REG_VOFFSET, config.voffset);
-	write16(REG_VSYNC0, config.vsync0);
-	write16(REG_VSYNC1, config.vsync1);
-	write8(REG_SWIZZLE, config.swizzle);
-	write8(REG_PCLK_POL, config.pclkpol);
-	write8(REG_CSPREAD, config.cspread);
+	writeBurst<REG_HCYCLE, REG_HOFFSET, REG_HSIZE, REG_HSYNC0, REG_HSYNC1, REG_VCYCLE, REG_VOFFSET, REG_VSIZE,
+			   REG_VSYNC0, REG_VSYNC1>(config.hcycle, config.hoffset, config.hsize, config.hsync0, config.hsync1,
+									   config.vcycle, config.voffset, config.vsize, config.vsync0, config.vsync1);
+	writeBurst<REG_SWIZZLE, REG_CSPREAD, REG_PCLK_POL>(config.swizzle, config.cspread, config.pclkpol);
 
 	/* Configure Touch */
 	write8(REG_TOUCH_MODE, EVE_TMODE_CONTINUOUS);
@@ -71,9 +69,8 @@ bool EveDisplay::begin(HSPI::PinSet pinSet, uint8_t chipSelect, uint32_t spiCloc
 #endif
 
 	/* disable Audio for now */
-	write8(REG_VOL_PB, 0);	// turn recorded audio volume down, reset-default is 0xff
-	write8(REG_VOL_SOUND, 0); // turn synthesizer volume down, reset-default is 0xff
-	write16(REG_SOUND, unsigned(Sound::MUTE));
+	// Turn recorded audio and synthesizer volume down, reset-default is 0xff
+	writeBurst<REG_VOL_PB, REG_VOL_SOUND, REG_SOUND>(0, 0, unsigned(Sound::MUTE));
 
 	/* Create initial display list */
 	const uint32_t dl[]{
@@ -134,15 +131,320 @@ bool EveDisplay::setIoMode(HSPI::IoMode mode)
 	return MemoryDevice::setIoMode(mode);
 }
 
+bool EveDisplay::sendCommands(const uint32_t* words, unsigned count)
+{
+	// Restoring state after a fault is allowed as the FIFO has been reset
+	if(commandsLocked && !recovering) {
+		debug_e("[EVE] Command FIFO locked by asynchronous writer");
+		return false;
+	}
+
+	coproStart();
+
+	while(count != 0) {
+		unsigned space = read16(REG_CMDB_SPACE) & 0x0ffc;
+		if(space == 0) {
+			++stats.fifoStalls;
+			if(checkFault()) {
+				return false;
+			}
+			auto stallStart = micros();
+			OneShotFastMs timer;
+			timer.reset<100>();
+			do {
+				if(timer.expired()) {
+					if(!checkFault()) {
+						debug_e("[EVE] Timeout waiting for command FIFO");
+					}
+					return false;
+				}
+				++stats.pollReads;
+				space = read16(REG_CMDB_SPACE) & 0x0ffc;
+			} while(space == 0);
+			stats.fifoStallTime += micros() - stallStart;
+		}
+
+		auto n = std::min(count, space / 4);
+		blockWrite(REG_CMDB_WRITE, words, n);
+		fifoPosition += n * 4;
+		words += n;
+		count -= n;
+
+		uint16_t fill = EVE_CMDFIFO_SIZE - 4 - space + n * 4;
+		stats.cmdHighWater = std::max(stats.cmdHighWater, fill);
+	}
+
+	return true;
+}
+
+void EveDisplay::writeCommands(HSPI::Request& req, const uint32_t* words, unsigned count, HSPI::Callback callback,
+							   void* param)
+{
+	coproStart();
+	write(req, REG_CMDB_WRITE, words, count * sizeof(uint32_t), callback, param);
+	fifoPosition += count * sizeof(uint32_t);
+}
+
+bool EveDisplay::waitCommandsIdle(unsigned timeoutMs)
+{
+	OneShotFastMs timer;
+	timer.reset(timeoutMs);
+	for(;;) {
+		// REG_CMD_READ and REG_CMD_WRITE are adjacent
+		uint32_t regs[2];
+		read(REG_CMD_READ, regs, sizeof(regs));
+		if(regs[0] == EVE_CMDFIFO_FAULT) {
+			recoverCoprocessor();
+			return false;
+		}
+		if((regs[0] & EVE_CMDFIFO_MASK) == (regs[1] & EVE_CMDFIFO_MASK)) {
+			break;
+		}
+		if(timer.expired()) {
+			return false;
+		}
+		++stats.pollReads;
+	}
+	coproIdle();
+	return true;
+}
+
+EveDisplay::FifoProgress EveDisplay::getFifoProgress(uint32_t mark, uint32_t cmdRead, uint32_t cmdWrite)
+{
+	if(cmdRead == EVE_CMDFIFO_FAULT) {
+		return FifoProgress::fault;
+	}
+	const uint16_t pending = (cmdWrite - cmdRead) & EVE_CMDFIFO_MASK;
+	const uint16_t toMark = (mark - cmdRead) & EVE_CMDFIFO_MASK;
+	return (toMark != 0 && toMark <= pending) ? FifoProgress::pending : FifoProgress::passed;
+}
+
+EveDisplay::FifoProgress EveDisplay::getFifoProgress(uint32_t mark)
+{
+	// REG_CMD_READ and REG_CMD_WRITE are adjacent
+	uint32_t regs[2];
+	read(REG_CMD_READ, regs, sizeof(regs));
+	return getFifoProgress(mark, regs[0], regs[1]);
+}
+
+bool EveDisplay::checkFault()
+{
+	if(read16(REG_CMD_READ) != EVE_CMDFIFO_FAULT) {
+		return false;
+	}
+	recoverCoprocessor();
+	return true;
+}
+
+void EveDisplay::recoverCoprocessor()
+{
+	++stats.coproFaults;
+	lastFault.time = micros();
+	lastFault.frames = read32(REG_FRAMES);
+	lastFault.writeOffset = read16(REG_CMD_WRITE) & EVE_CMDFIFO_MASK;
+	lastFault.dlOffset = read16(REG_CMD_DL);
+	// Last few words submitted, which may wrap around the end of the FIFO
+	constexpr uint16_t captureSize{sizeof(lastFault.commands)};
+	uint16_t start = (lastFault.writeOffset - captureSize) & EVE_CMDFIFO_MASK & ~3U;
+	uint16_t len = std::min(captureSize, uint16_t(EVE_CMDFIFO_SIZE - start));
+	read(EVE_RAM_CMD + start, lastFault.commands, len);
+	if(len < captureSize) {
+		read(EVE_RAM_CMD, reinterpret_cast<uint8_t*>(lastFault.commands) + len, captureSize - len);
+	}
+	debug_w("[EVE] Co-processor fault, REG_CMD_WRITE 0x%03x, REG_CMD_DL 0x%04x", lastFault.writeOffset,
+			lastFault.dlOffset);
+
+	// Reset co-processor only, clearing FIFO pointers (REG_CMD_READ, REG_CMD_WRITE, REG_CMD_DL are adjacent)
+	write8(REG_CPURESET, 1);
+	const uint32_t pointers[]{0, 0, 0};
+	writeBlock(REG_CMD_READ, pointers, ARRAY_SIZE(pointers));
+	write8(REG_CPURESET, 0);
+	coproBusy = false;
+	// Keep position in step with REG_CMD_WRITE
+	fifoPosition = (fifoPosition + EVE_CMDFIFO_SIZE) & ~uint32_t(EVE_CMDFIFO_MASK);
+
+	// A fault whilst restoring state must not recurse
+	if(!recovering && recoveryCount != 0) {
+		recovering = true;
+		if(!sendCommands(recoveryCommands, recoveryCount) || !waitCommandsIdle()) {
+			debug_e("[EVE] Failed to restore co-processor state");
+		}
+		recovering = false;
+	}
+
+	if(faultCallback && !recovering) {
+		faultCallback(lastFault);
+	}
+}
+
+bool EveDisplay::waitSwap(unsigned timeoutMs)
+{
+	OneShotFastMs timer;
+	timer.reset(timeoutMs);
+	while(read8(REG_DLSWAP) != EVE_DLSWAP_DONE) {
+		if(timer.expired()) {
+			return false;
+		}
+		++stats.pollReads;
+	}
+	return true;
+}
+
+bool EveDisplay::sendDisplayList(const uint32_t* words, unsigned count, HSPI::Callback callback, void* param)
+{
+	if(count == 0 || count > EVE_RAM_DL_SIZE / 4 || words[count - 1] != DISPLAY()) {
+		debug_e("[EVE] Display list must end with DISPLAY and fit in RAM_DL");
+		return false;
+	}
+	for(unsigned i = 0; i < count; ++i) {
+		if((words[i] & 0xffffff00) == 0xffffff00) {
+			debug_e("[EVE] Display list contains co-processor command at %u", i);
+			return false;
+		}
+	}
+
+	wait(dlRequest);
+	wait(swapRequest);
+	if(!waitCommandsIdle()) {
+		debug_e("[EVE] Timeout waiting for co-processor");
+		return false;
+	}
+	if(!waitSwap()) {
+		debug_e("[EVE] Timeout waiting for DL swap");
+		return false;
+	}
+
+	write(dlRequest, EVE_RAM_DL, words, count * sizeof(uint32_t));
+	write(swapRequest, REG_DLSWAP, &swapCommand, sizeof(swapCommand), callback, param);
+	++stats.directLists;
+	stats.dlHighWater = std::max(stats.dlHighWater, uint16_t(count * sizeof(uint32_t)));
+	return true;
+}
+
+void EveDisplay::flushRegisters()
+{
+	uint32_t address;
+	const uint32_t* values;
+	unsigned count;
+	while((count = registers.nextDirtyRun(address, values)) != 0) {
+		writeBlock(address, values, count);
+	}
+}
+
+void EveDisplay::writeRegisters(uint32_t addr, const uint32_t* values, unsigned count)
+{
+	bool changed{false};
+	for(unsigned i = 0; i < count; ++i) {
+		auto address = addr + i * sizeof(uint32_t);
+		changed |= !RegisterCache::contains(address) || registers.write(address, values[i], sizeof(uint32_t));
+	}
+	if(!changed) {
+		stats.elidedWrites += count;
+		return;
+	}
+	writeBlock(addr, values, count);
+}
+
+bool EveDisplay::writeInBand(uint32_t address, uint32_t value)
+{
+	if(stream == nullptr) {
+		write32(address, value);
+		return true;
+	}
+	uint32_t current;
+	if(RegisterCache::contains(address) && registers.read(address, sizeof(uint32_t), current) && current == value) {
+		++stats.elidedWrites;
+		return true;
+	}
+	if(!stream->addRegisterWrite(address, value)) {
+		return false;
+	}
+	// Value isn't known until the list has been executed, which may never happen
+	registers.invalidate(address, sizeof(uint32_t));
+	return true;
+}
+
+void EveDisplay::coproStart()
+{
+	if(!coproBusy) {
+		coproBusy = true;
+		coproBusyStart = micros();
+	}
+}
+
+void EveDisplay::coproIdle()
+{
+	if(coproBusy) {
+		stats.coproBusyTime += micros() - coproBusyStart;
+		coproBusy = false;
+	}
+}
+
+void EveDisplay::updateFrameStats()
+{
+	++stats.frames;
+
+	uint16_t dl = read16(REG_CMD_DL);
+	stats.dlHighWater = std::max(stats.dlHighWater, dl);
+
+	// Display frames which elapsed since the last call, other than the one we're expecting, were missed
+	auto frameCount = read32(REG_FRAMES);
+	if(lastFrameCount != 0 && frameCount - lastFrameCount > 1) {
+		stats.missedFrames += frameCount - lastFrameCount - 1;
+	}
+	lastFrameCount = frameCount;
+
+	// REG_CMD_READ and REG_CMD_WRITE are adjacent
+	uint32_t regs[2];
+	read(REG_CMD_READ, regs, sizeof(regs));
+	if(regs[0] == EVE_CMDFIFO_FAULT) {
+		recoverCoprocessor();
+	} else if(coproBusy && (regs[0] & EVE_CMDFIFO_MASK) == (regs[1] & EVE_CMDFIFO_MASK)) {
+		coproIdle();
+	}
+}
+
+void EveDisplay::enableInterrupts(uint8_t mask)
+{
+	// REG_INT_MASK resets to 0xff so the hardware value can't be used as a starting point
+	interruptMask |= mask;
+	write8(REG_INT_MASK, interruptMask);
+	write8(REG_INT_EN, 1);
+}
+
+void EveDisplay::disableInterrupts(uint8_t mask)
+{
+	interruptMask &= ~mask;
+	write8(REG_INT_MASK, interruptMask);
+	if(interruptMask == 0) {
+		write8(REG_INT_EN, 0);
+	}
+}
+
+void EveDisplay::executeTraced(HSPI::Request& req)
+{
+	// Asynchronous requests are recorded up-front as they may complete, and be re-used, at any time
+	auto startTime = micros();
+	if(req.async) {
+		trace->record(req, startTime);
+		dispatch(req);
+		return;
+	}
+	dispatch(req);
+	trace->record(req, startTime);
+}
+
 void EveDisplay::cmdWrite(EVE::HostCommand cmd, uint8_t param)
 {
+	// Host commands may reset the chip
+	registers.invalidate();
 	HSPI::Request req;
 	req.setCommand8(uint8_t(cmd));
 	req.out.set16(param);
 	execute(req);
 }
 
-void EveDisplay::blockWrite(uint32_t addr, const uint32_t* values, unsigned count)
+void EveDisplay::writeBlock(uint32_t addr, const uint32_t* values, unsigned count)
 {
 	assert(addrValid(addr) && addrValid(addr + count * 4 - 1));
 	HSPI::Request req;
@@ -0,0 +1,1081 @@
+#include "Coprocessor.h"
+#include "../include/Graphics/EVE/Emulator.h"
+#include "../include/Graphics/EVE/Renderer.h"
+#include "../include/Graphics/EVE/Crc.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Graphics::EVE
+{
+namespace
+{
+constexpr uint32_t fifoMask{EVE_CMDFIFO_SIZE - 1};
+constexpr uint32_t fifoFault{0xfff};
+
+// Font metric block layout
+constexpr uint32_t metricFormat{128};
+constexpr uint32_t metricStride{132};
+constexpr uint32_t metricWidth{136};
+constexpr uint32_t metricHeight{140};
+constexpr uint32_t metricPointer{144};
+
+// ROM fonts 16-31: metrics are synthesised at the same address as FT81x ROM, glyph data is not present
+constexpr uint32_t romFontMetrics{0x201ee0};
+constexpr uint8_t romFontHeights[]{8, 8, 16, 16, 13, 17, 20, 22, 29, 38, 16, 20, 25, 28, 36, 49};
+
+constexpr uint32_t defaultFgColor{0x003870};
+constexpr uint32_t defaultBgColor{0x002040};
+constexpr uint32_t defaultGradColor{0xffffff};
+
+constexpr uint8_t snapshotARGB8{0x20};
+
+constexpr uint32_t align4(uint32_t value)
+{
+	return (value + 3) & ~3U;
+}
+
+uint8_t bitsPerPixel(uint16_t format)
+{
+	switch(format) {
+	case BMF_L1:
+		return 1;
+	case BMF_L2:
+		return 2;
+	case BMF_L4:
+		return 4;
+	case BMF_ARGB1555:
+	case BMF_ARGB4:
+	case BMF_RGB565:
+	case BMF_TEXTVGA:
+		return 16;
+	default:
+		return 8;
+	}
+}
+
+} // namespace
+
+void Coprocessor::initRom(uint8_t* memory)
+{
+	*reinterpret_cast<uint32_t*>(&memory[EVE_ROM_FONTROOT]) = romFontMetrics;
+	for(unsigned i = 0; i < ARRAY_SIZE(romFontHeights); ++i) {
+		auto block = &memory[romFontMetrics + i * EVE_FONT_TABLE_SIZE];
+		const uint8_t height = romFontHeights[i];
+		const bool fixed = (i < 4);
+		const uint8_t width = fixed ? 8 : (height + 1) / 2;
+		std::fill_n(block, EVE_NUMCHAR_PERFONT, width);
+		if(!fixed) {
+			block[' '] = std::max(1, height * 3 / 10);
+		}
+		const bool antialiased = (i >= 10);
+		auto put = [&](uint32_t offset, uint32_t value) { *reinterpret_cast<uint32_t*>(&block[offset]) = value; };
+		put(metricFormat, antialiased ? BMF_L4 : BMF_L1);
+		put(metricStride, antialiased ? (width + 1) / 2 : (width + 7) / 8);
+		put(metricWidth, width);
+		put(metricHeight, height);
+		put(metricPointer, EVE_ROM_FONT);
+	}
+}
+
+void Coprocessor::reset()
+{
+	stream = Stream::none;
+	streamBuffer.clear();
+	fgColor = defaultFgColor;
+	bgColor = defaultBgColor;
+	gradColor = defaultGradColor;
+	const double identity[]{1, 0, 0, 0, 1, 0};
+	std::copy_n(identity, 6, matrix);
+	for(unsigned i = 0; i < ARRAY_SIZE(fonts); ++i) {
+		fonts[i] = (i < 16) ? Font{0, 0} : Font{romFontMetrics + (i - 16) * EVE_FONT_TABLE_SIZE, 0};
+	}
+	trackAreas.clear();
+	resultPtr = 0;
+	numberBase = 10;
+}
+
+uint32_t Coprocessor::fifoByte(uint32_t offset) const
+{
+	return emu.memory[EVE_RAM_CMD + (offset & fifoMask)];
+}
+
+uint32_t Coprocessor::word(unsigned index) const
+{
+	return emu.fifoWord(cmdOffset + 4 + index * 4);
+}
+
+void Coprocessor::result(unsigned index, uint32_t value)
+{
+	auto offset = (cmdOffset + 4 + index * 4) & fifoMask;
+	*reinterpret_cast<uint32_t*>(&emu.memory[EVE_RAM_CMD + offset]) = value;
+}
+
+std::string Coprocessor::string(unsigned index) const
+{
+	std::string s;
+	for(uint32_t offset = cmdOffset + 4 + index * 4;; ++offset) {
+		char c = fifoByte(offset);
+		if(c == '\0') {
+			return s;
+		}
+		s += c;
+	}
+}
+
+uint32_t Coprocessor::read32(uint32_t address) const
+{
+	address &= EVE_MEMORY_SIZE - 4;
+	return *reinterpret_cast<const uint32_t*>(&emu.memory[address]);
+}
+
+int Coprocessor::commandLength(uint8_t cmd, uint32_t available) const
+{
+	int params{0};
+	bool hasString{false};
+	switch(cmd) {
+	case CMD_DLSTART:
+	case CMD_SWAP:
+	case CMD_STOP:
+	case CMD_LOADIDENTITY:
+	case CMD_SETMATRIX:
+	case CMD_SCREENSAVER:
+	case CMD_LOGO:
+	case CMD_COLDSTART:
+	case CMD_SYNC:
+		break;
+	case CMD_INTERRUPT:
+	case CMD_BGCOLOR:
+	case CMD_FGCOLOR:
+	case CMD_GRADCOLOR:
+	case CMD_CALIBRATE:
+	case CMD_SNAPSHOT:
+	case CMD_INFLATE:
+	case CMD_GETPTR:
+	case CMD_ROTATE:
+	case CMD_SETROTATE:
+	case CMD_SETBASE:
+	case CMD_SETSCRATCH:
+		params = 1;
+		break;
+	case CMD_SPINNER:
+	case CMD_REGREAD:
+	case CMD_MEMWRITE:
+	case CMD_MEMZERO:
+	case CMD_APPEND:
+	case CMD_TRANSLATE:
+	case CMD_SCALE:
+	case CMD_SETFONT:
+	case CMD_MEDIAFIFO:
+	case CMD_ROMFONT:
+		params = 2;
+		break;
+	case CMD_MEMCRC:
+	case CMD_MEMSET:
+	case CMD_MEMCPY:
+	case CMD_GETPROPS:
+	case CMD_TRACK:
+	case CMD_DIAL:
+	case CMD_NUMBER:
+	case CMD_SETFONT2:
+	case CMD_SETBITMAP:
+		params = 3;
+		break;
+	case CMD_GRADIENT:
+	case CMD_PROGRESS:
+	case CMD_SLIDER:
+	case CMD_SCROLLBAR:
+	case CMD_GAUGE:
+	case CMD_CLOCK:
+	case CMD_SKETCH:
+	case CMD_SNAPSHOT2:
+		params = 4;
+		break;
+	case CMD_GETMATRIX:
+		params = 6;
+		break;
+	case CMD_TEXT:
+		params = 2;
+		hasString = true;
+		break;
+	case CMD_BUTTON:
+	case CMD_KEYS:
+	case CMD_TOGGLE:
+		params = 3;
+		hasString = true;
+		break;
+	default:
+		// LOADIMAGE and video playback need image / video decoders
+		return -1;
+	}
+
+	uint32_t length = 4 + params * 4;
+	if(length > available) {
+		return 0;
+	}
+	if(!hasString) {
+		return length;
+	}
+	for(uint32_t i = length; i < available; ++i) {
+		if(fifoByte(cmdOffset + i) == '\0') {
+			return align4(i + 1);
+		}
+	}
+	// A string which cannot fit in the FIFO will never complete
+	return (available >= EVE_CMDFIFO_SIZE - 4) ? -1 : 0;
+}
+
+void Coprocessor::run()
+{
+	if(running) {
+		return;
+	}
+	running = true;
+
+	auto& read = emu.reg(REG_CMD_READ);
+	while(read != fifoFault) {
+		const uint32_t available = (emu.reg(REG_CMD_WRITE) - read) & fifoMask & ~3U;
+		if(available == 0) {
+			break;
+		}
+		cmdOffset = read;
+
+		int length;
+		if(stream != Stream::none) {
+			length = runStream(available);
+		} else if(const uint32_t cmdWord = emu.fifoWord(read); (cmdWord >> 8) != 0xffffff) {
+			emu.writeDisplayList(cmdWord);
+			length = 4;
+		} else {
+			const uint8_t cmd = cmdWord;
+			length = commandLength(cmd, available);
+			if(length > 0 && !execute(cmd)) {
+				length = -1;
+			}
+			if(length < 0) {
+				debug_w("[EMU] Co-processor fault, command 0x%02x at 0x%03x", cmd, unsigned(read));
+			}
+		}
+
+		if(length == 0) {
+			break;
+		}
+		if(length < 0) {
+			read = fifoFault;
+			break;
+		}
+		read = (read + length) & fifoMask;
+	}
+
+	running = false;
+}
+
+int Coprocessor::runStream(uint32_t available)
+{
+	if(stream == Stream::memwrite) {
+		const uint32_t count = std::min(available, align4(streamLength) - streamPos);
+		uint8_t buffer[EVE_CMDFIFO_SIZE];
+		for(uint32_t i = 0; i < count; ++i) {
+			buffer[i] = fifoByte(cmdOffset + i);
+		}
+		// Trailing padding is discarded
+		if(streamPos < streamLength) {
+			emu.write(streamAddress + streamPos, buffer, std::min(count, streamLength - streamPos));
+		}
+		streamPos += count;
+		if(streamPos >= align4(streamLength)) {
+			stream = Stream::none;
+		}
+		return count;
+	}
+
+	/*
+	 * Stream length is only known once decoded, so decode everything received so far.
+	 * An incomplete stream has consumed all input, so it can be released from the FIFO.
+	 */
+	const uint32_t previous = streamBuffer.size();
+	for(uint32_t i = 0; i < available; ++i) {
+		streamBuffer.push_back(fifoByte(cmdOffset + i));
+	}
+	const uint32_t address = streamAddress & (EVE_RAM_G_SIZE - 1);
+	auto res = inflater.run(streamBuffer.data(), streamBuffer.size(), &emu.memory[address], EVE_RAM_G_SIZE - address);
+	switch(res) {
+	case Inflate::Result::needInput:
+		return available;
+	case Inflate::Result::ok:
+		resultPtr = address + inflater.getOutputLength();
+		stream = Stream::none;
+		streamBuffer.clear();
+		return align4(inflater.getInputUsed()) - previous;
+	case Inflate::Result::error:
+	default:
+		debug_w("[EMU] CMD_INFLATE data invalid");
+		return -1;
+	}
+}
+
+bool Coprocessor::execute(uint8_t cmd)
+{
+	switch(cmd) {
+	case CMD_DLSTART:
+		emu.reg(REG_CMD_DL) = 0;
+		break;
+	case CMD_SWAP:
+		emu.swap();
+		break;
+	case CMD_INTERRUPT:
+		// Delay is not modelled
+		emu.setInterruptFlags(EVE_INT_CMDFLAG);
+		break;
+	case CMD_BGCOLOR:
+		bgColor = word(0) & 0xffffff;
+		break;
+	case CMD_FGCOLOR:
+		fgColor = word(0) & 0xffffff;
+		break;
+	case CMD_GRADCOLOR:
+		gradColor = word(0) & 0xffffff;
+		break;
+	case CMD_GRADIENT:
+		gradient(s16(0), s16(1), word(1), s16(4), s16(5), word(3));
+		break;
+	case CMD_TEXT:
+		text(s16(0), s16(1), s16(2), u16(3), string(2));
+		break;
+	case CMD_BUTTON:
+		button(s16(0), s16(1), s16(2), s16(3), s16(4), u16(5), string(3));
+		break;
+	case CMD_KEYS:
+		keys(s16(0), s16(1), s16(2), s16(3), s16(4), u16(5), string(3));
+		break;
+	case CMD_PROGRESS:
+		progress(s16(0), s16(1), s16(2), s16(3), u16(4), u16(5), u16(6));
+		break;
+	case CMD_SLIDER:
+		slider(s16(0), s16(1), s16(2), s16(3), u16(4), u16(5), u16(6));
+		break;
+	case CMD_SCROLLBAR:
+		scrollbar(s16(0), s16(1), s16(2), s16(3), u16(4), u16(5), u16(6), u16(7));
+		break;
+	case CMD_TOGGLE:
+		toggle(s16(0), s16(1), s16(2), s16(3), u16(4), u16(5), string(3));
+		break;
+	case CMD_GAUGE:
+		gauge(s16(0), s16(1), s16(2), u16(3), u16(4), u16(5), u16(6), u16(7));
+		break;
+	case CMD_CLOCK:
+		clock(s16(0), s16(1), s16(2), u16(3), u16(4), u16(5), u16(6));
+		break;
+	case CMD_DIAL:
+		dial(s16(0), s16(1), s16(2), u16(3), word(2));
+		break;
+	case CMD_NUMBER:
+		number(s16(0), s16(1), s16(2), u16(3), word(2));
+		break;
+	case CMD_SPINNER:
+		// Draw one frame and complete rather than animating until CMD_STOP
+		spinner(s16(0), s16(1), u16(2), u16(3));
+		break;
+	case CMD_CALIBRATE:
+		// Leave touch co-ordinates untransformed and report success
+		emu.reg(REG_TOUCH_TRANSFORM_A) = 0x10000;
+		emu.reg(REG_TOUCH_TRANSFORM_B) = 0;
+		emu.reg(REG_TOUCH_TRANSFORM_C) = 0;
+		emu.reg(REG_TOUCH_TRANSFORM_D) = 0;
+		emu.reg(REG_TOUCH_TRANSFORM_E) = 0x10000;
+		emu.reg(REG_TOUCH_TRANSFORM_F) = 0;
+		result(0, 1);
+		break;
+	case CMD_STOP:
+	case CMD_SCREENSAVER:
+	case CMD_SKETCH:
+	case CMD_LOGO:
+	case CMD_SYNC:
+	case CMD_SETSCRATCH:
+		break;
+	case CMD_MEMCRC: {
+		const uint32_t ptr = word(0) & (EVE_MEMORY_SIZE - 1);
+		const uint32_t num = std::min(word(1), EVE_MEMORY_SIZE - ptr);
+		result(2, crc32(&emu.memory[ptr], num));
+		break;
+	}
+	case CMD_REGREAD:
+		emu.updateRegisters();
+		result(1, read32(word(0)));
+		break;
+	case CMD_MEMWRITE:
+		streamAddress = word(0) & (EVE_MEMORY_SIZE - 1);
+		streamLength = word(1);
+		streamPos = 0;
+		if(streamLength != 0) {
+			stream = Stream::memwrite;
+		}
+		break;
+	case CMD_MEMSET:
+	case CMD_MEMZERO: {
+		const uint32_t ptr = word(0) & (EVE_MEMORY_SIZE - 1);
+		const uint32_t num = std::min(word(cmd == CMD_MEMSET ? 2 : 1), EVE_MEMORY_SIZE - ptr);
+		std::vector<uint8_t> data(num, cmd == CMD_MEMSET ? uint8_t(word(1)) : 0);
+		emu.write(ptr, data.data(), num);
+		break;
+	}
+	case CMD_MEMCPY: {
+		const uint32_t dest = word(0) & (EVE_MEMORY_SIZE - 1);
+		const uint32_t src = word(1) & (EVE_MEMORY_SIZE - 1);
+		const uint32_t num = std::min({word(2), EVE_MEMORY_SIZE - dest, EVE_MEMORY_SIZE - src});
+		std::vector<uint8_t> data(&emu.memory[src], &emu.memory[src + num]);
+		emu.write(dest, data.data(), num);
+		break;
+	}
+	case CMD_APPEND: {
+		const uint32_t ptr = word(0);
+		const uint32_t num = word(1);
+		for(uint32_t i = 0; i < num; i += 4) {
+			emu.writeDisplayList(read32(ptr + i));
+		}
+		break;
+	}
+	case CMD_SNAPSHOT:
+		snapshot(BMF_ARGB4, word(0), 0, 0, emu.reg(REG_HSIZE), emu.reg(REG_VSIZE));
+		break;
+	case CMD_SNAPSHOT2:
+		snapshot(word(0), word(1), s16(4), s16(5), s16(6), s16(7));
+		break;
+	case CMD_INFLATE:
+		stream = Stream::inflate;
+		streamAddress = word(0);
+		streamBuffer.clear();
+		break;
+	case CMD_GETPTR:
+		result(0, resultPtr);
+		break;
+	case CMD_GETPROPS:
+		result(0, imagePtr);
+		result(1, imageWidth);
+		result(2, imageHeight);
+		break;
+	case CMD_LOADIDENTITY: {
+		const double identity[]{1, 0, 0, 0, 1, 0};
+		std::copy_n(identity, 6, matrix);
+		break;
+	}
+	case CMD_TRANSLATE: {
+		const double m[]{1, 0, int32_t(word(0)) / 65536.0, 0, 1, int32_t(word(1)) / 65536.0};
+		multiply(m);
+		break;
+	}
+	case CMD_SCALE: {
+		const double m[]{int32_t(word(0)) / 65536.0, 0, 0, 0, int32_t(word(1)) / 65536.0, 0};
+		multiply(m);
+		break;
+	}
+	case CMD_ROTATE: {
+		const double angle = (word(0) & 0xffff) * 2 * M_PI / 65536;
+		const double c = cos(angle);
+		const double s = sin(angle);
+		const double m[]{c, -s, 0, s, c, 0};
+		multiply(m);
+		break;
+	}
+	case CMD_SETMATRIX:
+		setMatrix();
+		break;
+	case CMD_GETMATRIX:
+		for(unsigned i = 0; i < 6; ++i) {
+			result(i, int32_t(lround(matrix[i] * 65536)));
+		}
+		break;
+	case CMD_SETFONT:
+		setFont(word(0), word(1), 0, false);
+		break;
+	case CMD_SETFONT2:
+		setFont(word(0), word(1), word(2), true);
+		break;
+	case CMD_ROMFONT: {
+		const uint32_t slot = word(1);
+		if(slot < 16 || slot > 34) {
+			return false;
+		}
+		// Slots 32-34 are the large numeric fonts, not modelled so use largest standard font metrics
+		const uint32_t index = std::min(slot, 31U) - 16;
+		setFont(word(0), romFontMetrics + index * EVE_FONT_TABLE_SIZE, 0, true);
+		break;
+	}
+	case CMD_TRACK: {
+		const uint8_t tag = word(2);
+		trackAreas.erase(std::remove_if(trackAreas.begin(), trackAreas.end(),
+										[tag](const TrackArea& t) { return t.tag == tag; }),
+						 trackAreas.end());
+		if(s16(2) != 0 || s16(3) != 0) {
+			trackAreas.push_back({s16(0), s16(1), s16(2), s16(3), tag});
+		}
+		break;
+	}
+	case CMD_COLDSTART:
+		reset();
+		break;
+	case CMD_SETROTATE:
+		emu.reg(REG_ROTATE) = word(0) & 0x07;
+		break;
+	case CMD_SETBASE:
+		numberBase = std::clamp(word(0), 2U, 36U);
+		break;
+	case CMD_MEDIAFIFO:
+		emu.reg(REG_MEDIAFIFO_READ) = 0;
+		emu.reg(REG_MEDIAFIFO_WRITE) = 0;
+		break;
+	case CMD_SETBITMAP:
+		setBitmap(word(0), u16(2), u16(3), u16(4));
+		break;
+	default:
+		return false;
+	}
+
+	return true;
+}
+
+/* Display list generation */
+
+void Coprocessor::dl(uint32_t word)
+{
+	emu.writeDisplayList(word);
+}
+
+void Coprocessor::beginWidget()
+{
+	dl(SAVE_CONTEXT());
+	dl(VERTEX_FORMAT(4));
+}
+
+void Coprocessor::endWidget()
+{
+	dl(RESTORE_CONTEXT());
+}
+
+void Coprocessor::color(uint32_t rgb)
+{
+	dl(MAKE_CMD_WORD(DL_COLOR_RGB, rgb & 0xffffff));
+}
+
+void Coprocessor::vertex(int x, int y)
+{
+	dl(VERTEX2F(x * 16, y * 16));
+}
+
+void Coprocessor::rect(int x0, int y0, int x1, int y1, int radius)
+{
+	// Vertices are inclusive and expanded by (radius - 1)
+	radius = std::max(1, std::min({radius, (x1 - x0) / 2, (y1 - y0) / 2}));
+	dl(LINE_WIDTH(radius * 16));
+	dl(BEGIN(GP_RECTS));
+	vertex(x0 + radius - 1, y0 + radius - 1);
+	vertex(x1 - radius, y1 - radius);
+	dl(END());
+}
+
+void Coprocessor::circle(int x, int y, int radius)
+{
+	dl(POINT_SIZE(radius * 16));
+	dl(BEGIN(GP_POINTS));
+	vertex(x, y);
+	dl(END());
+}
+
+void Coprocessor::line(int x0, int y0, int x1, int y1, int width)
+{
+	dl(LINE_WIDTH(width * 8));
+	dl(BEGIN(GP_LINES));
+	vertex(x0, y0);
+	vertex(x1, y1);
+	dl(END());
+}
+
+void Coprocessor::radial(int x, int y, int r0, int r1, int angle, int width)
+{
+	// Angle is in units of 1/65536 turn, clockwise from straight down
+	const double a = angle * 2 * M_PI / 65536;
+	const double dx = -sin(a);
+	const double dy = cos(a);
+	line(x + lround(dx * r0), y + lround(dy * r0), x + lround(dx * r1), y + lround(dy * r1), width);
+}
+
+Coprocessor::Font Coprocessor::getFont(uint8_t font) const
+{
+	return (font < ARRAY_SIZE(fonts)) ? fonts[font] : Font{0, 0};
+}
+
+uint8_t Coprocessor::fontHeight(uint8_t font) const
+{
+	auto f = getFont(font);
+	return f.metrics ? read32(f.metrics + metricHeight) : 0;
+}
+
+int Coprocessor::textWidth(uint8_t font, const std::string& s) const
+{
+	auto f = getFont(font);
+	if(f.metrics == 0) {
+		return 0;
+	}
+	int width{0};
+	for(uint8_t c : s) {
+		if(c < EVE_NUMCHAR_PERFONT) {
+			width += emu.memory[f.metrics + c];
+		}
+	}
+	return width;
+}
+
+void Coprocessor::text(int x, int y, uint8_t font, uint16_t options, const std::string& s)
+{
+	auto f = getFont(font);
+	if(f.metrics == 0) {
+		debug_w("[EMU] Font %u not registered", font);
+		return;
+	}
+
+	const int width = textWidth(font, s);
+	if(options & EVE_OPT_RIGHTX) {
+		x -= width;
+	} else if(options & EVE_OPT_CENTERX) {
+		x -= width / 2;
+	}
+	if(options & EVE_OPT_CENTERY) {
+		y -= fontHeight(font) / 2;
+	}
+
+	// VERTEX2II is used where co-ordinates fit, otherwise handle and cell must be set explicitly
+	bool setHandle{true};
+	dl(BEGIN(GP_BITMAPS));
+	for(uint8_t c : s) {
+		if(c < f.firstChar || c >= EVE_NUMCHAR_PERFONT) {
+			continue;
+		}
+		if(x >= 0 && x < 512 && y >= 0 && y < 512) {
+			dl(VERTEX2II(x, y, font, c));
+		} else {
+			if(setHandle) {
+				dl(SAVE_CONTEXT());
+				dl(VERTEX_FORMAT(4));
+				dl(BITMAP_HANDLE(font));
+				setHandle = false;
+			}
+			dl(CELL(c));
+			vertex(x, y);
+		}
+		x += emu.memory[f.metrics + c];
+	}
+	if(!setHandle) {
+		dl(RESTORE_CONTEXT());
+	}
+	dl(END());
+}
+
+/* Widgets */
+
+void Coprocessor::button(int x, int y, int w, int h, uint8_t font, uint16_t options, const std::string& s)
+{
+	beginWidget();
+	color(fgColor);
+	rect(x, y, x + w, y + h, 4);
+	if(!(options & EVE_OPT_FLAT)) {
+		// Highlight upper half to suggest the 3D shading
+		dl(COLOR_A(64));
+		color(gradColor);
+		rect(x + 1, y + 1, x + w - 1, y + h / 2, 3);
+	}
+	endWidget();
+	text(x + w / 2, y + h / 2, font, EVE_OPT_CENTER, s);
+}
+
+void Coprocessor::keys(int x, int y, int w, int h, uint8_t font, uint16_t options, const std::string& s)
+{
+	const int count = s.length();
+	if(count == 0) {
+		return;
+	}
+	constexpr int gap{3};
+	const uint8_t pressed = options & 0xff;
+	const int keyWidth = (w - (count - 1) * gap) / count;
+
+	for(int i = 0; i < count; ++i) {
+		const uint8_t c = s[i];
+		const int kx = x + i * (keyWidth + gap);
+		beginWidget();
+		dl(TAG(c));
+		color(c == pressed ? bgColor : fgColor);
+		rect(kx, y, kx + keyWidth, y + h, 4);
+		endWidget();
+		dl(SAVE_CONTEXT());
+		dl(TAG(c));
+		text(kx + keyWidth / 2, y + h / 2, font, EVE_OPT_CENTER, std::string(1, c));
+		dl(RESTORE_CONTEXT());
+	}
+}
+
+void Coprocessor::progress(int x, int y, int w, int h, uint16_t options, uint16_t val, uint16_t range)
+{
+	const bool vertical = h > w;
+	const int radius = (vertical ? w : h) / 2;
+	const int length = range ? (vertical ? h : w) * std::min(val, range) / range : 0;
+	beginWidget();
+	color(bgColor);
+	rect(x, y, x + w, y + h, radius);
+	endWidget();
+	beginWidget();
+	if(vertical) {
+		rect(x, y, x + w, y + std::max(length, 2 * radius), radius);
+	} else {
+		rect(x, y, x + std::max(length, 2 * radius), y + h, radius);
+	}
+	endWidget();
+}
+
+void Coprocessor::slider(int x, int y, int w, int h, uint16_t options, uint16_t val, uint16_t range)
+{
+	const bool vertical = h > w;
+	const int thickness = vertical ? w : h;
+	const int length = range ? (vertical ? h : w) * std::min(val, range) / range : 0;
+	beginWidget();
+	color(bgColor);
+	rect(x, y, x + w, y + h, thickness / 2);
+	endWidget();
+	beginWidget();
+	if(vertical) {
+		rect(x, y, x + w, y + length, thickness / 2);
+	} else {
+		rect(x, y, x + length, y + h, thickness / 2);
+	}
+	color(fgColor);
+	if(vertical) {
+		circle(x + w / 2, y + length, thickness);
+	} else {
+		circle(x + length, y + h / 2, thickness);
+	}
+	endWidget();
+}
+
+void Coprocessor::scrollbar(int x, int y, int w, int h, uint16_t options, uint16_t val, uint16_t size,
+							uint16_t range)
+{
+	const bool vertical = h > w;
+	const int thickness = vertical ? w : h;
+	const int span = vertical ? h : w;
+	const int start = range ? span * std::min(val, range) / range : 0;
+	const int length = range ? std::max(thickness, span * std::min(size, range) / range) : span;
+	beginWidget();
+	color(bgColor);
+	rect(x, y, x + w, y + h, thickness / 2);
+	color(fgColor);
+	if(vertical) {
+		rect(x, y + start, x + w, std::min(y + start + length, y + h), thickness / 2);
+	} else {
+		rect(x + start, y, std::min(x + start + length, x + w), y + h, thickness / 2);
+	}
+	endWidget();
+}
+
+void Coprocessor::toggle(int x, int y, int w, uint8_t font, uint16_t options, uint16_t state,
+						 const std::string& s)
+{
+	const int h = std::max(2, int(fontHeight(font)));
+	const int knob = x + w * state / 0xffff;
+	beginWidget();
+	color(bgColor);
+	rect(x - h / 2, y, x + w + h / 2, y + h, h / 2);
+	color(fgColor);
+	circle(knob, y + h / 2, h / 2);
+	endWidget();
+
+	// Labels for off and on states are separated by 0xff
+	auto sep = s.find('\xff');
+	auto label = (state < 0x8000) ? s.substr(0, sep) : (sep == s.npos ? "" : s.substr(sep + 1));
+	text(x + w / 2, y + h / 2, font, EVE_OPT_CENTER, label);
+}
+
+void Coprocessor::dial(int x, int y, int r, uint16_t options, uint16_t val)
+{
+	beginWidget();
+	color(fgColor);
+	circle(x, y, r);
+	endWidget();
+	beginWidget();
+	radial(x, y, r / 3, r * 4 / 5, val, std::max(2, r / 10));
+	endWidget();
+}
+
+void Coprocessor::gauge(int x, int y, int r, uint16_t options, uint16_t major, uint16_t minor, uint16_t val,
+						uint16_t range)
+{
+	// 270 degree sweep starting at lower left
+	constexpr int start{0x2000};
+	constexpr int sweep{0xc000};
+
+	beginWidget();
+	if(!(options & EVE_OPT_NOBACK)) {
+		color(bgColor);
+		circle(x, y, r);
+	}
+	endWidget();
+	beginWidget();
+	if(!(options & EVE_OPT_NOTICKS) && major != 0) {
+		const int ticks = major * std::max(1, int(minor));
+		for(int i = 0; i <= ticks; ++i) {
+			const bool isMajor = (i % std::max(1, int(minor))) == 0;
+			radial(x, y, isMajor ? r * 3 / 4 : r * 7 / 8, r * 19 / 20, start + sweep * i / ticks, isMajor ? 2 : 1);
+		}
+	}
+	if(!(options & EVE_OPT_NOPOINTER) && range != 0) {
+		radial(x, y, 0, r * 4 / 5, start + sweep * std::min(val, range) / range, std::max(2, r / 20));
+	}
+	endWidget();
+}
+
+void Coprocessor::clock(int x, int y, int r, uint16_t options, uint16_t h, uint16_t m, uint16_t s)
+{
+	constexpr int top{0x8000};
+
+	beginWidget();
+	if(!(options & EVE_OPT_NOBACK)) {
+		color(bgColor);
+		circle(x, y, r);
+	}
+	endWidget();
+	beginWidget();
+	if(!(options & EVE_OPT_NOTICKS)) {
+		for(int i = 0; i < 12; ++i) {
+			radial(x, y, r * 17 / 20, r * 19 / 20, i * 65536 / 12, 2);
+		}
+	}
+	if(!(options & EVE_OPT_NOHM)) {
+		radial(x, y, 0, r / 2, top + ((h % 12) * 60 + m) * 65536 / 720, std::max(2, r / 16));
+		radial(x, y, 0, r * 3 / 4, top + (m * 60 + s) * 65536 / 3600, std::max(2, r / 20));
+	}
+	if(!(options & EVE_OPT_NOSECS)) {
+		color(gradColor);
+		radial(x, y, 0, r * 4 / 5, top + s * 65536 / 60, 1);
+	}
+	endWidget();
+}
+
+void Coprocessor::spinner(int x, int y, uint16_t style, uint16_t scale)
+{
+	const int r = 24 * (std::min(scale, uint16_t(2)) + 1);
+	beginWidget();
+	for(int i = 0; i < 8; ++i) {
+		const double a = i * M_PI / 4;
+		dl(COLOR_A(255 - i * 28));
+		circle(x + lround(sin(a) * r), y - lround(cos(a) * r), r / 6);
+	}
+	endWidget();
+}
+
+void Coprocessor::gradient(int x0, int y0, uint32_t rgb0, int x1, int y1, uint32_t rgb1)
+{
+	/*
+	 * Approximated by bands perpendicular to the dominant axis, filling the screen.
+	 * Hardware produces a smooth gradient along any direction.
+	 */
+	constexpr int bands{32};
+	const int width = emu.reg(REG_HSIZE) ? int(emu.reg(REG_HSIZE)) : 800;
+	const int height = emu.reg(REG_VSIZE) ? int(emu.reg(REG_VSIZE)) : 480;
+	const bool horizontal = std::abs(x1 - x0) >= std::abs(y1 - y0);
+	const int p0 = horizontal ? x0 : y0;
+	const int p1 = horizontal ? x1 : y1;
+	const int extent = horizontal ? width : height;
+
+	auto mix = [&](int num, int den) {
+		uint32_t rgb{0};
+		for(unsigned shift = 0; shift < 24; shift += 8) {
+			int c0 = (rgb0 >> shift) & 0xff;
+			int c1 = (rgb1 >> shift) & 0xff;
+			rgb |= uint32_t(c0 + (c1 - c0) * num / den) << shift;
+		}
+		return rgb;
+	};
+	auto band = [&](int a, int b, uint32_t rgb) {
+		if(b <= a) {
+			return;
+		}
+		color(rgb);
+		if(horizontal) {
+			rect(a, 0, b, height, 1);
+		} else {
+			rect(0, a, width, b, 1);
+		}
+	};
+
+	beginWidget();
+	const bool forward = p1 >= p0;
+	const int lo = std::min(p0, p1);
+	const int hi = std::max(p0, p1);
+	band(0, lo, forward ? rgb0 : rgb1);
+	for(int i = 0; i < bands && hi > lo; ++i) {
+		const int a = lo + (hi - lo) * i / bands;
+		const int b = lo + (hi - lo) * (i + 1) / bands;
+		const int t = forward ? 2 * i + 1 : 2 * (bands - i) - 1;
+		band(a, b, mix(t, 2 * bands));
+	}
+	band(hi, extent, forward ? rgb1 : rgb0);
+	endWidget();
+}
+
+void Coprocessor::number(int x, int y, uint8_t font, uint16_t options, int32_t n)
+{
+	const bool negative = (options & EVE_OPT_SIGNED) && n < 0;
+	uint32_t value = negative ? -uint32_t(n) : uint32_t(n);
+	std::string digits;
+	do {
+		const unsigned d = value % numberBase;
+		digits.insert(digits.begin(), char(d < 10 ? '0' + d : 'a' + d - 10));
+		value /= numberBase;
+	} while(value != 0);
+	const unsigned minDigits = options & 0xff;
+	if(digits.length() < minDigits) {
+		digits.insert(0, minDigits - digits.length(), '0');
+	}
+	if(negative) {
+		digits.insert(digits.begin(), '-');
+	}
+	text(x, y, font, options, digits);
+}
+
+/* Bitmaps and transforms */
+
+void Coprocessor::setBitmap(uint32_t addr, uint16_t format, uint16_t width, uint16_t height)
+{
+	const uint32_t stride = (width * bitsPerPixel(format) + 7) / 8;
+	dl(BITMAP_SOURCE(addr));
+	dl(BITMAP_LAYOUT(BitmapFormat(format), stride, height));
+	dl(BITMAP_LAYOUT_H(stride, height));
+	dl(BITMAP_SIZE(BitmapFilter::NEAREST, BitmapWrap::BORDER, BitmapWrap::BORDER, width, height));
+	dl(BITMAP_SIZE_H(width, height));
+}
+
+void Coprocessor::setFont(uint8_t font, uint32_t metrics, uint8_t firstChar, bool emitSource)
+{
+	if(font >= ARRAY_SIZE(fonts)) {
+		return;
+	}
+	fonts[font] = Font{metrics & (EVE_MEMORY_SIZE - 1), firstChar};
+	if(!emitSource) {
+		return;
+	}
+
+	// Source is offset so that cell number equals character code
+	const uint32_t format = read32(metrics + metricFormat);
+	const uint32_t stride = read32(metrics + metricStride);
+	const uint32_t width = read32(metrics + metricWidth);
+	const uint32_t height = read32(metrics + metricHeight);
+	const uint32_t ptr = read32(metrics + metricPointer);
+	dl(BITMAP_HANDLE(font));
+	dl(BITMAP_SOURCE(ptr - firstChar * stride * height));
+	dl(BITMAP_LAYOUT(BitmapFormat(format), stride, height));
+	dl(BITMAP_LAYOUT_H(stride, height));
+	dl(BITMAP_SIZE(BitmapFilter::NEAREST, BitmapWrap::BORDER, BitmapWrap::BORDER, width, height));
+	dl(BITMAP_SIZE_H(width, height));
+}
+
+void Coprocessor::multiply(const double (&m)[6])
+{
+	const double a = matrix[0] * m[0] + matrix[1] * m[3];
+	const double b = matrix[0] * m[1] + matrix[1] * m[4];
+	const double c = matrix[0] * m[2] + matrix[1] * m[5] + matrix[2];
+	const double d = matrix[3] * m[0] + matrix[4] * m[3];
+	const double e = matrix[3] * m[1] + matrix[4] * m[4];
+	const double f = matrix[3] * m[2] + matrix[4] * m[5] + matrix[5];
+	matrix[0] = a;
+	matrix[1] = b;
+	matrix[2] = c;
+	matrix[3] = d;
+	matrix[4] = e;
+	matrix[5] = f;
+}
+
+void Coprocessor::setMatrix()
+{
+	// The graphics engine maps screen to bitmap co-ordinates, so needs the inverse
+	const double a = matrix[0];
+	const double b = matrix[1];
+	const double c = matrix[2];
+	const double d = matrix[3];
+	const double e = matrix[4];
+	const double f = matrix[5];
+	const double det = a * e - b * d;
+	if(det == 0) {
+		return;
+	}
+	auto fixed = [](double value, unsigned bits) { return uint32_t(lround(value * 256)) & ((1U << bits) - 1); };
+	dl(MAKE_CMD_WORD(DL_BITMAP_TRANSFORM_A, fixed(e / det, 17)));
+	dl(MAKE_CMD_WORD(DL_BITMAP_TRANSFORM_B, fixed(-b / det, 17)));
+	dl(MAKE_CMD_WORD(DL_BITMAP_TRANSFORM_C, fixed((b * f - e * c) / det, 24)));
+	dl(MAKE_CMD_WORD(DL_BITMAP_TRANSFORM_D, fixed(-d / det, 17)));
+	dl(MAKE_CMD_WORD(DL_BITMAP_TRANSFORM_E, fixed(a / det, 17)));
+	dl(MAKE_CMD_WORD(DL_BITMAP_TRANSFORM_F, fixed((d * c - a * f) / det, 24)));
+}
+
+void Coprocessor::snapshot(uint16_t format, uint32_t ptr, int x, int y, int w, int h)
+{
+	const uint16_t width = emu.reg(REG_HSIZE);
+	const uint16_t height = emu.reg(REG_VSIZE);
+	if(width == 0 || height == 0) {
+		debug_w("[EMU] Snapshot requires REG_HSIZE, REG_VSIZE");
+		return;
+	}
+
+	Renderer renderer(Renderer::Config{width, height});
+	renderer.render(emu.getDisplayList(), emu.memory.get());
+	auto buffer = renderer.getColorBuffer();
+
+	const unsigned bytesPerPixel = (format == snapshotARGB8) ? 4 : 2;
+	std::vector<uint8_t> row(w * bytesPerPixel);
+	for(int j = 0; j < h; ++j) {
+		for(int i = 0; i < w; ++i) {
+			const int px = x + i;
+			const int py = y + j;
+			const uint32_t argb = (px >= 0 && px < width && py >= 0 && py < height) ? buffer[py * width + px] : 0;
+			const uint8_t r = argb >> 16;
+			const uint8_t g = argb >> 8;
+			const uint8_t b = argb;
+			uint32_t value;
+			switch(format) {
+			case BMF_RGB565:
+				value = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+				break;
+			case BMF_ARGB4:
+				value = 0xf000 | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+				break;
+			default:
+				value = argb | 0xff000000;
+			}
+			std::copy_n(reinterpret_cast<const uint8_t*>(&value), bytesPerPixel, &row[i * bytesPerPixel]);
+		}
+		emu.write(ptr + j * row.size(), row.data(), row.size());
+	}
+}
+
+void Coprocessor::track(uint8_t index, int16_t x, int16_t y, uint8_t tag)
+{
+	if(index > 4 || tag == 0) {
+		return;
+	}
+	auto it = std::find_if(trackAreas.begin(), trackAreas.end(), [tag](const TrackArea& t) { return t.tag == tag; });
+	if(it == trackAreas.end()) {
+		return;
+	}
+
+	uint16_t value;
+	if(it->w == 1 && it->h == 1) {
+		// Rotary: angle around centre, clockwise from straight down
+		double angle = atan2(-(x - it->x), y - it->y);
+		if(angle < 0) {
+			angle += 2 * M_PI;
+		}
+		value = uint32_t(angle * 65536 / (2 * M_PI)) & 0xffff;
+	} else if(it->w >= it->h) {
+		value = std::clamp((x - it->x) * 65536 / std::max(1, int(it->w)), 0, 0xffff);
+	} else {
+		value = std::clamp((y - it->y) * 65536 / std::max(1, int(it->h)), 0, 0xffff);
+	}
+	emu.reg(Register(REG_TRACKER + index * 4)) = (uint32_t(value) << 16) | tag;
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../include/Graphics/EVE/EVE.h"
+#include "Inflate.h"
+#include <string>
+#include <vector>
+
+namespace Graphics::EVE
+{
+class Emulator;
+
+/**
+ * @brief Co-processor command interpreter used by Emulator
+ *
+ * Consumes the command FIFO, generating display list words at REG_CMD_DL and writing results
+ * back into the FIFO as the hardware does. A command is only executed once all of its parameters
+ * have arrived; CMD_MEMWRITE and CMD_INFLATE data is consumed as it arrives so streams larger than
+ * the FIFO work as on hardware.
+ *
+ * Memory operations, bitmap setup, matrices and result-returning commands are exact.
+ * Widgets produce display lists with approximately the right geometry and colours but are not
+ * word-for-word what the hardware generates.
+ */
+class Coprocessor
+{
+public:
+	Coprocessor(Emulator& emu) : emu(emu)
+	{
+	}
+
+	/**
+	 * @brief Write synthesised ROM font metrics
+	 *
+	 * Heights match the FT81x ROM fonts; widths are approximate and glyph data is absent.
+	 */
+	static void initRom(uint8_t* memory);
+
+	/**
+	 * @brief Reset to power-on state, equivalent to REG_CPURESET
+	 */
+	void reset();
+
+	/**
+	 * @brief Execute all complete commands in the FIFO
+	 */
+	void run();
+
+	/**
+	 * @brief Update REG_TRACKER for a touch on a tracked control
+	 */
+	void track(uint8_t index, int16_t x, int16_t y, uint8_t tag);
+
+private:
+	enum class Stream {
+		none,
+		memwrite,
+		inflate,
+	};
+
+	struct Font {
+		uint32_t metrics; ///< Address of metric block
+		uint8_t firstChar;
+	};
+
+	struct TrackArea {
+		int16_t x;
+		int16_t y;
+		int16_t w;
+		int16_t h;
+		uint8_t tag;
+	};
+
+	// FIFO access relative to current command
+	uint32_t fifoByte(uint32_t offset) const;
+	uint32_t word(unsigned index) const;
+	int16_t s16(unsigned index) const
+	{
+		return int16_t(word(index / 2) >> ((index % 2) * 16));
+	}
+	uint16_t u16(unsigned index) const
+	{
+		return uint16_t(s16(index));
+	}
+	void result(unsigned index, uint32_t value);
+	std::string string(unsigned index) const;
+
+	int commandLength(uint8_t cmd, uint32_t available) const;
+	bool execute(uint8_t cmd);
+	int runStream(uint32_t available);
+	uint32_t read32(uint32_t address) const;
+
+	// Display list generation
+	void dl(uint32_t word);
+	void beginWidget();
+	void endWidget();
+	void color(uint32_t rgb);
+	void vertex(int x, int y);
+	void rect(int x0, int y0, int x1, int y1, int radius);
+	void circle(int x, int y, int radius);
+	void line(int x0, int y0, int x1, int y1, int width);
+	void radial(int x, int y, int r0, int r1, int angle, int width);
+
+	Font getFont(uint8_t font) const;
+	uint8_t fontHeight(uint8_t font) const;
+	int textWidth(uint8_t font, const std::string& s) const;
+	void text(int x, int y, uint8_t font, uint16_t options, const std::string& s);
+
+	// Widgets
+	void button(int x, int y, int w, int h, uint8_t font, uint16_t options, const std::string& s);
+	void keys(int x, int y, int w, int h, uint8_t font, uint16_t options, const std::string& s);
+	void progress(int x, int y, int w, int h, uint16_t options, uint16_t val, uint16_t range);
+	void slider(int x, int y, int w, int h, uint16_t options, uint16_t val, uint16_t range);
+	void scrollbar(int x, int y, int w, int h, uint16_t options, uint16_t val, uint16_t size, uint16_t range);
+	void toggle(int x, int y, int w, uint8_t font, uint16_t options, uint16_t state, const std::string& s);
+	void dial(int x, int y, int r, uint16_t options, uint16_t val);
+	void gauge(int x, int y, int r, uint16_t options, uint16_t major, uint16_t minor, uint16_t val,
+			   uint16_t range);
+	void clock(int x, int y, int r, uint16_t options, uint16_t h, uint16_t m, uint16_t s);
+	void spinner(int x, int y, uint16_t style, uint16_t scale);
+	void gradient(int x0, int y0, uint32_t rgb0, int x1, int y1, uint32_t rgb1);
+	void number(int x, int y, uint8_t font, uint16_t options, int32_t n);
+
+	// Bitmaps and transforms
+	void setBitmap(uint32_t addr, uint16_t format, uint16_t width, uint16_t height);
+	void setFont(uint8_t font, uint32_t metrics, uint8_t firstChar, bool emitSource);
+	void multiply(const double (&m)[6]);
+	void setMatrix();
+	void snapshot(uint16_t format, uint32_t ptr, int x, int y, int w, int h);
+
+	Emulator& emu;
+	uint32_t cmdOffset{0};
+	Stream stream{Stream::none};
+	uint32_t streamAddress{0};
+	uint32_t streamLength{0};
+	uint32_t streamPos{0};
+	std::vector<uint8_t> streamBuffer;
+	Inflate inflater;
+	uint32_t fgColor;
+	uint32_t bgColor;
+	uint32_t gradColor;
+	double matrix[6]; // a, b, c, d, e, f: forward transform
+	Font fonts[32];
+	std::vector<TrackArea> trackAreas;
+	uint32_t resultPtr{0};
+	uint32_t imagePtr{0};
+	uint32_t imageWidth{0};
+	uint32_t imageHeight{0};
+	uint8_t numberBase{10};
+	bool running{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,277 @@
+#include "../include/Graphics/EVE/Emulator.h"
+#include "Coprocessor.h"
+#include <HSPI/Device.h>
+#include <Clock.h>
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Registers for each touch point: XY (or X), Y (touch 4 only), TAG
+struct TouchRegisters {
+	Register xy;
+	Register y;
+	Register tag;
+};
+
+constexpr TouchRegisters touchRegisters[]{
+	{REG_CTOUCH_TOUCH_XY, Register(0), REG_TOUCH_TAG},	 {REG_CTOUCH_TOUCH1_XY, Register(0), REG_TOUCH_TAG1},
+	{REG_CTOUCH_TOUCH2_XY, Register(0), REG_TOUCH_TAG2}, {REG_CTOUCH_TOUCH3_XY, Register(0), REG_TOUCH_TAG3},
+	{REG_CTOUCH_TOUCH4_X, REG_CTOUCH_TOUCH4_Y, REG_TOUCH_TAG4},
+};
+
+constexpr uint32_t noTouch{0x80008000};
+constexpr uint32_t fifoMask{EVE_CMDFIFO_SIZE - 1};
+constexpr uint32_t fifoFault{0xfff};
+constexpr uint32_t chipId{0x00011308}; // FT813
+constexpr uint32_t systemClock{60000000};
+
+} // namespace
+
+Emulator::Emulator(const Config& config)
+	: config(config), memory(new uint8_t[EVE_MEMORY_SIZE]), displayList(new uint32_t[EVE_RAM_DL_SIZE / 4]),
+	  coprocessor(new Coprocessor(*this))
+{
+	reset();
+}
+
+Emulator::~Emulator() = default;
+
+void Emulator::reset()
+{
+	std::fill_n(memory.get(), EVE_MEMORY_SIZE, 0);
+	std::fill_n(displayList.get(), EVE_RAM_DL_SIZE / 4, 0);
+
+	*reinterpret_cast<uint32_t*>(&memory[EVE_ROM_CHIPID]) = chipId;
+	Coprocessor::initRom(memory.get());
+	coprocessor->reset();
+	reg(REG_ID) = 0x7c;
+	reg(REG_FREQUENCY) = systemClock;
+	reg(REG_INT_MASK) = 0xff;
+	reg(REG_CTOUCH_EXTENDED) = 1;
+	for(auto& t : touchRegisters) {
+		reg(t.xy) = noTouch;
+	}
+	reg(REG_CTOUCH_TOUCH4_X) = 0x8000;
+	reg(REG_CTOUCH_TOUCH4_Y) = 0x8000;
+
+	startTime = micros();
+	swapCount = 0;
+	interruptFlags = 0;
+	updateRegisters();
+}
+
+void Emulator::execute(HSPI::Request& req)
+{
+	req.busy = true;
+
+	if(req.addr.bitCount == 0) {
+		hostCommand(req.cmd.value);
+	} else if(req.addr.value & 0x800000) {
+		write(req.addr.value & (EVE_MEMORY_SIZE - 1), static_cast<const uint8_t*>(req.out.get()), req.out.length);
+	} else {
+		read(req.addr.value & (EVE_MEMORY_SIZE - 1), static_cast<uint8_t*>(req.in.get()), req.in.length);
+	}
+
+	auto time = calculateTransferTime(req);
+	transferTime += time;
+	if(config.realTime) {
+		auto start = micros();
+		while(micros() - start < time / 1000) {
+		}
+	}
+
+	req.busy = false;
+	if(req.async && req.callback) {
+		req.callback(req);
+	}
+}
+
+uint32_t Emulator::calculateTransferTime(const HSPI::Request& req) const
+{
+	auto device = req.device;
+	if(device == nullptr || device->getSpeed() == 0) {
+		return config.transactionOverhead;
+	}
+	const unsigned bitsPerClock = device->getBitsPerClock();
+	const unsigned bits = req.cmd.bitCount + req.addr.bitCount + 8U * (req.out.length + req.in.length);
+	const uint64_t clocks = (bits + bitsPerClock - 1) / bitsPerClock + req.dummyLen;
+	return config.transactionOverhead + clocks * 1000000000ULL / device->getSpeed();
+}
+
+void Emulator::hostCommand(uint8_t cmd)
+{
+	switch(HostCommand(cmd)) {
+	case HostCommand::RST_PULSE:
+		reset();
+		break;
+	default:
+		// Clock and power modes have no effect
+		break;
+	}
+}
+
+void Emulator::write(uint32_t address, const uint8_t* data, size_t length)
+{
+	// Burst writes to REG_CMDB_WRITE all go to the FIFO
+	if(address == REG_CMDB_WRITE) {
+		writeFifo(data, length);
+		return;
+	}
+
+	length = std::min(length, size_t(EVE_MEMORY_SIZE - address));
+	std::copy_n(data, length, &memory[address]);
+
+	auto touches = [&](Register r) { return r + 4 > address && r < address + length; };
+
+	// Read-only registers
+	if(touches(REG_INT_FLAGS) || touches(REG_CMDB_SPACE) || touches(REG_ID)) {
+		updateRegisters();
+		reg(REG_ID) = 0x7c;
+	}
+	if(touches(REG_CPURESET) && (reg(REG_CPURESET) & 0x01)) {
+		coprocessor->reset();
+	}
+	if(touches(REG_CPURESET) || touches(REG_CMD_WRITE)) {
+		runCoprocessor();
+	}
+	if(touches(REG_DLSWAP) && reg(REG_DLSWAP) != EVE_DLSWAP_DONE) {
+		swap();
+	}
+	if(touches(REG_INT_EN) || touches(REG_INT_MASK)) {
+		checkInterrupt();
+	}
+}
+
+void Emulator::read(uint32_t address, uint8_t* buffer, size_t length)
+{
+	length = std::min(length, size_t(EVE_MEMORY_SIZE - address));
+	if(address + length > EVE_RAM_REG && address < EVE_RAM_CMD) {
+		updateRegisters();
+	}
+	std::copy_n(&memory[address], length, buffer);
+
+	// Reading REG_INT_FLAGS clears it
+	if(REG_INT_FLAGS + 4 > address && REG_INT_FLAGS < address + length) {
+		interruptFlags = 0;
+		reg(REG_INT_FLAGS) = 0;
+	}
+}
+
+void Emulator::updateRegisters()
+{
+	const uint64_t elapsed = micros() - startTime;
+	reg(REG_FRAMES) = elapsed * config.frameRate / 1000000;
+	reg(REG_CLOCK) = elapsed * (systemClock / 1000000);
+	reg(REG_INT_FLAGS) = interruptFlags;
+
+	const uint32_t read = reg(REG_CMD_READ);
+	const uint32_t used = (read == fifoFault) ? 0 : (reg(REG_CMD_WRITE) - read) & fifoMask;
+	reg(REG_CMDB_SPACE) = (EVE_CMDFIFO_SIZE - 4 - used) & 0xffc;
+}
+
+void Emulator::writeFifo(const uint8_t* data, size_t length)
+{
+	auto& write = reg(REG_CMD_WRITE);
+	for(size_t i = 0; i < length; ++i) {
+		memory[EVE_RAM_CMD + write] = data[i];
+		write = (write + 1) & fifoMask;
+	}
+	runCoprocessor();
+}
+
+uint32_t Emulator::fifoWord(uint32_t offset) const
+{
+	return reinterpret_cast<const uint32_t*>(&memory[EVE_RAM_CMD])[(offset & fifoMask) / 4];
+}
+
+void Emulator::runCoprocessor()
+{
+	if(reg(REG_CPURESET) & 0x01) {
+		return;
+	}
+
+	coprocessor->run();
+
+	if(reg(REG_CMD_READ) == (reg(REG_CMD_WRITE) & 0xffc)) {
+		setInterruptFlags(EVE_INT_CMDEMPTY);
+	}
+}
+
+void Emulator::writeDisplayList(uint32_t word)
+{
+	auto& offset = reg(REG_CMD_DL);
+	if(offset >= EVE_RAM_DL_SIZE) {
+		debug_w("[EMU] Display list overflow");
+		return;
+	}
+	*reinterpret_cast<uint32_t*>(&memory[EVE_RAM_DL + offset]) = word;
+	offset += 4;
+}
+
+void Emulator::swap()
+{
+	std::copy_n(reinterpret_cast<const uint32_t*>(&memory[EVE_RAM_DL]), EVE_RAM_DL_SIZE / 4, displayList.get());
+	reg(REG_DLSWAP) = EVE_DLSWAP_DONE;
+	++swapCount;
+	setInterruptFlags(EVE_INT_SWAP);
+}
+
+void Emulator::touch(uint8_t index, int16_t x, int16_t y, uint8_t tag)
+{
+	if(index >= ARRAY_SIZE(touchRegisters)) {
+		return;
+	}
+	auto& t = touchRegisters[index];
+	if(t.y == 0) {
+		reg(t.xy) = (uint32_t(uint16_t(x)) << 16) | uint16_t(y);
+	} else {
+		reg(t.xy) = uint16_t(x);
+		reg(t.y) = uint16_t(y);
+	}
+	reg(t.tag) = tag;
+	coprocessor->track(index, x, y, tag);
+	setInterruptFlags(EVE_INT_TOUCH | (tag ? EVE_INT_TAG : 0));
+}
+
+void Emulator::release(uint8_t index)
+{
+	if(index >= ARRAY_SIZE(touchRegisters)) {
+		return;
+	}
+	auto& t = touchRegisters[index];
+	if(t.y == 0) {
+		reg(t.xy) = noTouch;
+	} else {
+		reg(t.xy) = 0x8000;
+		reg(t.y) = 0x8000;
+	}
+	reg(t.tag) = 0;
+	setInterruptFlags(EVE_INT_TOUCH);
+}
+
+void Emulator::setInterruptFlags(uint8_t flags)
+{
+	interruptFlags |= flags;
+	checkInterrupt();
+}
+
+void Emulator::checkInterrupt()
+{
+	if(!(reg(REG_INT_EN) & 0x01) || !(interruptFlags & reg(REG_INT_MASK)) || !interruptCallback) {
+		return;
+	}
+
+	// INT_N is level-triggered, but the application clears it by reading flags so one notification suffices
+	interruptTask.queue();
+}
+
+void Emulator::raiseInterrupt()
+{
+	if(interruptCallback) {
+		interruptCallback();
+	}
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,290 @@
+#include "Inflate.h"
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+namespace
+{
+constexpr uint16_t lengthBase[]{3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23,	27,
+								31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t lengthBits[]{0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t distanceBase[]{1,   2,	3,	4,	5,	7,	 9,	13,	17,	25,	33,	49,	65,	97,	129,
+								  193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t distanceBits[]{0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t codeLengthOrder[]{16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+} // namespace
+
+unsigned Inflate::getBit()
+{
+	if(bitCount == 0) {
+		if(inPos >= inLength) {
+			truncated = true;
+			return 0;
+		}
+		bitBuffer = in[inPos++];
+		bitCount = 8;
+	}
+	unsigned bit = bitBuffer & 0x01;
+	bitBuffer >>= 1;
+	--bitCount;
+	return bit;
+}
+
+unsigned Inflate::getBits(unsigned count, unsigned base)
+{
+	unsigned value{0};
+	for(unsigned i = 0; i < count; ++i) {
+		value |= getBit() << i;
+	}
+	return base + value;
+}
+
+void Inflate::buildTree(Tree& tree, const uint8_t* lengths, unsigned count)
+{
+	std::fill_n(tree.counts, 16, 0);
+	for(unsigned i = 0; i < count; ++i) {
+		++tree.counts[lengths[i]];
+	}
+	tree.counts[0] = 0;
+
+	uint16_t offsets[16];
+	unsigned sum{0};
+	for(unsigned i = 0; i < 16; ++i) {
+		offsets[i] = sum;
+		sum += tree.counts[i];
+	}
+	for(unsigned i = 0; i < count; ++i) {
+		if(lengths[i] != 0) {
+			tree.symbols[offsets[lengths[i]]++] = i;
+		}
+	}
+}
+
+int Inflate::decodeSymbol(const Tree& tree)
+{
+	// Canonical codes of each length are consecutive, so walk down lengths until the code falls in range
+	int sum{0};
+	int cur{0};
+	unsigned len{0};
+	do {
+		cur = 2 * cur + getBit();
+		if(++len > 15) {
+			return -1;
+		}
+		sum += tree.counts[len];
+		cur -= tree.counts[len];
+	} while(cur >= 0);
+	return tree.symbols[sum + cur];
+}
+
+Inflate::Result Inflate::stored()
+{
+	// Discard remaining bits of current byte
+	bitCount = 0;
+	if(inPos + 4 > inLength) {
+		return Result::needInput;
+	}
+	const unsigned len = in[inPos] | (in[inPos + 1] << 8);
+	const unsigned nlen = in[inPos + 2] | (in[inPos + 3] << 8);
+	if(len != (~nlen & 0xffff)) {
+		return Result::error;
+	}
+	inPos += 4;
+	if(inPos + len > inLength) {
+		return Result::needInput;
+	}
+	if(outPos + len > outSize) {
+		return Result::error;
+	}
+	std::copy_n(&in[inPos], len, &out[outPos]);
+	inPos += len;
+	outPos += len;
+	return Result::ok;
+}
+
+Inflate::Result Inflate::dynamicTrees(Tree& lengths, Tree& distances)
+{
+	const unsigned hlit = getBits(5, 257);
+	const unsigned hdist = getBits(5, 1);
+	const unsigned hclen = getBits(4, 4);
+	if(hlit > 286 || hdist > 30) {
+		return Result::error;
+	}
+
+	uint8_t codeLengths[286 + 30]{};
+	for(unsigned i = 0; i < hclen; ++i) {
+		codeLengths[codeLengthOrder[i]] = getBits(3);
+	}
+	if(truncated) {
+		return Result::needInput;
+	}
+	Tree codeTree;
+	buildTree(codeTree, codeLengths, 19);
+
+	std::fill_n(codeLengths, 19, 0);
+	unsigned count{0};
+	while(count < hlit + hdist) {
+		int sym = decodeSymbol(codeTree);
+		if(truncated) {
+			return Result::needInput;
+		}
+		if(sym < 0) {
+			return Result::error;
+		}
+		if(sym < 16) {
+			codeLengths[count++] = sym;
+			continue;
+		}
+		uint8_t value{0};
+		unsigned repeat;
+		if(sym == 16) {
+			if(count == 0) {
+				return Result::error;
+			}
+			value = codeLengths[count - 1];
+			repeat = getBits(2, 3);
+		} else if(sym == 17) {
+			repeat = getBits(3, 3);
+		} else {
+			repeat = getBits(7, 11);
+		}
+		if(count + repeat > hlit + hdist) {
+			return Result::error;
+		}
+		std::fill_n(&codeLengths[count], repeat, value);
+		count += repeat;
+	}
+	if(truncated) {
+		return Result::needInput;
+	}
+
+	buildTree(lengths, codeLengths, hlit);
+	buildTree(distances, &codeLengths[hlit], hdist);
+	return Result::ok;
+}
+
+Inflate::Result Inflate::block(const Tree& lengths, const Tree& distances)
+{
+	for(;;) {
+		int sym = decodeSymbol(lengths);
+		if(truncated) {
+			return Result::needInput;
+		}
+		if(sym < 0) {
+			return Result::error;
+		}
+		if(sym == 256) {
+			return Result::ok;
+		}
+		if(sym < 256) {
+			if(outPos >= outSize) {
+				return Result::error;
+			}
+			out[outPos++] = sym;
+			continue;
+		}
+
+		sym -= 257;
+		if(sym >= int(sizeof(lengthBase) / sizeof(lengthBase[0]))) {
+			return Result::error;
+		}
+		const unsigned len = getBits(lengthBits[sym], lengthBase[sym]);
+		int dsym = decodeSymbol(distances);
+		if(truncated) {
+			return Result::needInput;
+		}
+		if(dsym < 0 || dsym >= 30) {
+			return Result::error;
+		}
+		const unsigned dist = getBits(distanceBits[dsym], distanceBase[dsym]);
+		if(truncated) {
+			return Result::needInput;
+		}
+		if(dist > outPos || outPos + len > outSize) {
+			return Result::error;
+		}
+		// Source and destination may overlap, so copy bytewise
+		for(unsigned i = 0; i < len; ++i, ++outPos) {
+			out[outPos] = out[outPos - dist];
+		}
+	}
+}
+
+Inflate::Result Inflate::run(const uint8_t* input, size_t inputLength, uint8_t* output, size_t outputSize)
+{
+	in = input;
+	inLength = inputLength;
+	inPos = 0;
+	out = output;
+	outSize = outputSize;
+	outPos = 0;
+	bitBuffer = 0;
+	bitCount = 0;
+	truncated = false;
+
+	// zlib header: deflate method, no preset dictionary
+	if(inLength < 2) {
+		return Result::needInput;
+	}
+	const unsigned cmf = in[0];
+	const unsigned flg = in[1];
+	if((cmf & 0x0f) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) {
+		return Result::error;
+	}
+	inPos = 2;
+
+	bool final;
+	do {
+		final = getBit();
+		const unsigned type = getBits(2);
+		if(truncated) {
+			return Result::needInput;
+		}
+
+		Result res;
+		switch(type) {
+		case 0:
+			res = stored();
+			break;
+		case 1: {
+			Tree lengths;
+			Tree distances;
+			uint8_t codeLengths[288];
+			std::fill_n(&codeLengths[0], 144, 8);
+			std::fill_n(&codeLengths[144], 112, 9);
+			std::fill_n(&codeLengths[256], 24, 7);
+			std::fill_n(&codeLengths[280], 8, 8);
+			buildTree(lengths, codeLengths, 288);
+			std::fill_n(codeLengths, 30, 5);
+			buildTree(distances, codeLengths, 30);
+			res = block(lengths, distances);
+			break;
+		}
+		case 2: {
+			Tree lengths;
+			Tree distances;
+			res = dynamicTrees(lengths, distances);
+			if(res == Result::ok) {
+				res = block(lengths, distances);
+			}
+			break;
+		}
+		default:
+			res = Result::error;
+		}
+		if(res != Result::ok) {
+			return res;
+		}
+	} while(!final);
+
+	// Adler-32 trailer follows on a byte boundary; the co-processor does not check it
+	bitCount = 0;
+	if(inPos + 4 > inLength) {
+		return Result::needInput;
+	}
+	inPos += 4;
+	return Result::ok;
+}
+
+} // namespace Graphics::EVE
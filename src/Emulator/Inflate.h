@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Minimal zlib decompressor for CMD_INFLATE emulation
+ *
+ * The co-processor receives compressed data through the command FIFO in arbitrary pieces, so `run()`
+ * is called on everything received so far and reports `needInput` if the stream is not yet complete.
+ * In that case every byte of input has been examined, so all of it belongs to the stream.
+ * On success `getInputUsed()` gives the exact stream length, including zlib header and trailer.
+ */
+class Inflate
+{
+public:
+	enum class Result {
+		ok,
+		needInput,
+		error,
+	};
+
+	Result run(const uint8_t* input, size_t inputLength, uint8_t* output, size_t outputSize);
+
+	size_t getInputUsed() const
+	{
+		return inPos;
+	}
+
+	size_t getOutputLength() const
+	{
+		return outPos;
+	}
+
+private:
+	struct Tree {
+		uint16_t counts[16];
+		uint16_t symbols[288];
+	};
+
+	unsigned getBit();
+	unsigned getBits(unsigned count, unsigned base = 0);
+	int decodeSymbol(const Tree& tree);
+	static void buildTree(Tree& tree, const uint8_t* lengths, unsigned count);
+	Result stored();
+	Result dynamicTrees(Tree& lengths, Tree& distances);
+	Result block(const Tree& lengths, const Tree& distances);
+
+	const uint8_t* in{nullptr};
+	size_t inLength{0};
+	size_t inPos{0};
+	uint8_t* out{nullptr};
+	size_t outSize{0};
+	size_t outPos{0};
+	unsigned bitBuffer{0};
+	unsigned bitCount{0};
+	bool truncated{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,873 @@
+#include "../include/Graphics/EVE/Renderer.h"
+#include "../include/Graphics/EVE/Emulator.h"
+#include "../include/Graphics/EVE/PngWriter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Guard against display lists which JUMP in a loop
+constexpr unsigned maxCommands{65536};
+
+int32_t signExtend(uint32_t value, unsigned bits)
+{
+	const uint32_t sign = 1U << (bits - 1);
+	value &= (sign << 1) - 1;
+	return int32_t(value ^ sign) - int32_t(sign);
+}
+
+uint8_t getA(uint32_t c)
+{
+	return c >> 24;
+}
+
+uint8_t getR(uint32_t c)
+{
+	return c >> 16;
+}
+
+uint8_t getG(uint32_t c)
+{
+	return c >> 8;
+}
+
+uint8_t getB(uint32_t c)
+{
+	return c;
+}
+
+uint32_t makeARGB(unsigned a, unsigned r, unsigned g, unsigned b)
+{
+	return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Scale n-bit component to 8 bits
+unsigned expand(unsigned value, unsigned bits)
+{
+	return value * 255 / ((1U << bits) - 1);
+}
+
+uint32_t fromRGB565(uint16_t v)
+{
+	return makeARGB(255, expand(v >> 11, 5), expand((v >> 5) & 0x3f, 6), expand(v & 0x1f, 5));
+}
+
+uint32_t fromARGB4(uint16_t v)
+{
+	return makeARGB(expand(v >> 12, 4), expand((v >> 8) & 0x0f, 4), expand((v >> 4) & 0x0f, 4), expand(v & 0x0f, 4));
+}
+
+uint32_t luminance(unsigned level)
+{
+	return makeARGB(level, 255, 255, 255);
+}
+
+bool test(TestFunction func, unsigned value, unsigned ref)
+{
+	switch(func) {
+	case TestFunction::NEVER:
+		return false;
+	case TestFunction::LESS:
+		return value < ref;
+	case TestFunction::LEQUAL:
+		return value <= ref;
+	case TestFunction::GREATER:
+		return value > ref;
+	case TestFunction::GEQUAL:
+		return value >= ref;
+	case TestFunction::EQUAL:
+		return value == ref;
+	case TestFunction::NOTEQUAL:
+		return value != ref;
+	case TestFunction::ALWAYS:
+	default:
+		return true;
+	}
+}
+
+uint8_t stencilOp(StencilOp op, uint8_t value, uint8_t ref)
+{
+	switch(op) {
+	case StencilOp::ZERO:
+		return 0;
+	case StencilOp::REPLACE:
+		return ref;
+	case StencilOp::INCR:
+		return (value == 255) ? 255 : value + 1;
+	case StencilOp::DECR:
+		return (value == 0) ? 0 : value - 1;
+	case StencilOp::INVERT:
+		return ~value;
+	case StencilOp::KEEP:
+	default:
+		return value;
+	}
+}
+
+unsigned blendFactor(BlendFunction func, unsigned srcAlpha, unsigned dstAlpha)
+{
+	switch(func) {
+	case BlendFunction::ZERO:
+		return 0;
+	case BlendFunction::ONE:
+		return 255;
+	case BlendFunction::SRC_ALPHA:
+		return srcAlpha;
+	case BlendFunction::DST_ALPHA:
+		return dstAlpha;
+	case BlendFunction::ONE_MINUS_SRC_ALPHA:
+		return 255 - srcAlpha;
+	case BlendFunction::ONE_MINUS_DST_ALPHA:
+		return 255 - dstAlpha;
+	default:
+		return 0;
+	}
+}
+
+// Bits per pixel for each BitmapFormat, 0 where not a simple raster
+unsigned getBitsPerPixel(uint8_t format)
+{
+	switch(format) {
+	case BMF_L1:
+		return 1;
+	case BMF_L2:
+		return 2;
+	case BMF_L4:
+		return 4;
+	case BMF_ARGB1555:
+	case BMF_ARGB4:
+	case BMF_RGB565:
+		return 16;
+	case BMF_TEXT8X8:
+	case BMF_TEXTVGA:
+		return 0;
+	default:
+		return 8;
+	}
+}
+
+float clamp01(float value)
+{
+	return std::clamp(value, 0.0f, 1.0f);
+}
+
+// Distance from point to line segment
+float segmentDistance(float px, float py, float x0, float y0, float x1, float y1)
+{
+	const float dx = x1 - x0;
+	const float dy = y1 - y0;
+	const float len2 = dx * dx + dy * dy;
+	float t = (len2 == 0) ? 0 : ((px - x0) * dx + (py - y0) * dy) / len2;
+	t = clamp01(t);
+	return std::hypot(px - (x0 + t * dx), py - (y0 + t * dy));
+}
+
+} // namespace
+
+Renderer::Renderer(const Config& config)
+	: config(config), color(config.width * config.height), stencil(config.width * config.height),
+	  tag(config.width * config.height)
+{
+}
+
+void Renderer::reset()
+{
+	std::fill(color.begin(), color.end(), 0);
+	std::fill(stencil.begin(), stencil.end(), 0);
+	std::fill(tag.begin(), tag.end(), 0);
+	cost.commands = 0;
+	cost.pixels = 0;
+	cost.maxLineCost = 0;
+	cost.linesOverBudget = 0;
+	cost.primitives.clear();
+	cost.lineCost.assign(config.height, 0);
+	ctx = Context{};
+	contextDepth = 0;
+	std::fill_n(handles, ARRAY_SIZE(handles), BitmapHandle{});
+	primitive = GP_BITMAPS;
+	inPrimitive = false;
+	vertexCount = 0;
+	currentCost = -1;
+}
+
+void Renderer::render(const Emulator& emulator)
+{
+	render(emulator.getDisplayList(), emulator.getMemory());
+}
+
+void Renderer::render(const uint32_t* displayList, const uint8_t* memory)
+{
+	this->memory = memory;
+	reset();
+
+	constexpr unsigned dlWords{EVE_RAM_DL_SIZE / 4};
+	uint16_t callStack[4];
+	unsigned callDepth{0};
+	pc = 0;
+	while(pc < dlWords && cost.commands < maxCommands) {
+		const uint32_t word = displayList[pc++];
+		++cost.commands;
+		if(word >> 30) {
+			execute(word);
+			continue;
+		}
+		switch(word >> 24) {
+		case DL_CALL:
+			if(callDepth < ARRAY_SIZE(callStack)) {
+				callStack[callDepth++] = pc;
+			}
+			pc = word & 0xffff;
+			break;
+		case DL_RETURN:
+			if(callDepth != 0) {
+				pc = callStack[--callDepth];
+			}
+			break;
+		case DL_JUMP:
+			pc = word & 0xffff;
+			break;
+		case DL_MACRO:
+			execute(read32(REG_MACRO_0 + 4 * (word & 0x01)));
+			break;
+		default:
+			if(!execute(word)) {
+				pc = dlWords;
+			}
+		}
+	}
+
+	for(auto lineCost : cost.lineCost) {
+		cost.maxLineCost = std::max(cost.maxLineCost, lineCost);
+		if(lineCost > config.lineBudget) {
+			++cost.linesOverBudget;
+		}
+	}
+}
+
+bool Renderer::execute(uint32_t word)
+{
+	// VERTEX2II
+	if(word >> 30 == 2) {
+		const float x = ((word >> 21) & 0x1ff) + ctx.translateX / 16.0f;
+		const float y = ((word >> 12) & 0x1ff) + ctx.translateY / 16.0f;
+		vertex(Vertex{x, y, uint8_t((word >> 7) & 0x1f), uint8_t(word & 0x7f)});
+		return true;
+	}
+
+	// VERTEX2F
+	if(word >> 30 == 1) {
+		const float scale = 1.0f / (1U << ctx.vertexFormat);
+		const float x = signExtend(word >> 15, 15) * scale + ctx.translateX / 16.0f;
+		const float y = signExtend(word, 15) * scale + ctx.translateY / 16.0f;
+		vertex(Vertex{x, y, ctx.handle, ctx.cell});
+		return true;
+	}
+
+	const uint32_t param = word & 0xffffff;
+	switch(word >> 24) {
+	case DL_DISPLAY:
+		return false;
+	case DL_BITMAP_SOURCE:
+		handles[ctx.handle].source = param & 0x3fffff;
+		break;
+	case DL_CLEAR_COLOR_RGB:
+		ctx.clearColor = (ctx.clearColor & 0xff000000) | param;
+		break;
+	case DL_TAG:
+		ctx.tag = param;
+		break;
+	case DL_COLOR_RGB:
+		ctx.color = (ctx.color & 0xff000000) | param;
+		break;
+	case DL_BITMAP_HANDLE:
+		ctx.handle = param & 0x1f;
+		break;
+	case DL_CELL:
+		ctx.cell = param & 0x7f;
+		break;
+	case DL_BITMAP_LAYOUT: {
+		auto& bmp = handles[ctx.handle];
+		bmp.format = (param >> 19) & 0x1f;
+		bmp.stride = (param >> 9) & 0x3ff;
+		bmp.layoutHeight = param & 0x1ff;
+		break;
+	}
+	case DL_BITMAP_LAYOUT_H: {
+		auto& bmp = handles[ctx.handle];
+		bmp.stride = (bmp.stride & 0x3ff) | (((param >> 2) & 0x03) << 10);
+		bmp.layoutHeight = (bmp.layoutHeight & 0x1ff) | ((param & 0x03) << 9);
+		break;
+	}
+	case DL_BITMAP_SIZE: {
+		auto& bmp = handles[ctx.handle];
+		bmp.bilinear = param & (1 << 20);
+		bmp.repeatX = param & (1 << 19);
+		bmp.repeatY = param & (1 << 18);
+		bmp.width = (param >> 9) & 0x1ff;
+		bmp.height = param & 0x1ff;
+		break;
+	}
+	case DL_BITMAP_SIZE_H: {
+		auto& bmp = handles[ctx.handle];
+		bmp.width = (bmp.width & 0x1ff) | (((param >> 2) & 0x03) << 9);
+		bmp.height = (bmp.height & 0x1ff) | ((param & 0x03) << 9);
+		break;
+	}
+	case DL_ALPHA_FUNC:
+		ctx.alphaFunc = TestFunction((param >> 8) & 0x07);
+		ctx.alphaRef = param;
+		break;
+	case DL_STENCIL_FUNC:
+		ctx.stencilFunc = TestFunction((param >> 16) & 0x07);
+		ctx.stencilRef = param >> 8;
+		ctx.stencilFuncMask = param;
+		break;
+	case DL_BLEND_FUNC:
+		ctx.blendSrc = BlendFunction((param >> 3) & 0x07);
+		ctx.blendDst = BlendFunction(param & 0x07);
+		break;
+	case DL_STENCIL_OP:
+		ctx.stencilFail = StencilOp((param >> 3) & 0x07);
+		ctx.stencilPass = StencilOp(param & 0x07);
+		break;
+	case DL_POINT_SIZE:
+		ctx.pointSize = param & 0x1fff;
+		break;
+	case DL_LINE_WIDTH:
+		ctx.lineWidth = param & 0x0fff;
+		break;
+	case DL_CLEAR_COLOR_A:
+		ctx.clearColor = (ctx.clearColor & 0x00ffffff) | ((param & 0xff) << 24);
+		break;
+	case DL_COLOR_A:
+		ctx.color = (ctx.color & 0x00ffffff) | ((param & 0xff) << 24);
+		break;
+	case DL_CLEAR_STENCIL:
+		ctx.clearStencil = param;
+		break;
+	case DL_CLEAR_TAG:
+		ctx.clearTag = param;
+		break;
+	case DL_STENCIL_MASK:
+		ctx.stencilMask = param;
+		break;
+	case DL_TAG_MASK:
+		ctx.tagMask = param & 0x01;
+		break;
+	case DL_BITMAP_TRANSFORM_A:
+	case DL_BITMAP_TRANSFORM_B:
+	case DL_BITMAP_TRANSFORM_D:
+	case DL_BITMAP_TRANSFORM_E:
+		ctx.transform[(word >> 24) - DL_BITMAP_TRANSFORM_A] = signExtend(param, 17);
+		break;
+	case DL_BITMAP_TRANSFORM_C:
+	case DL_BITMAP_TRANSFORM_F:
+		ctx.transform[(word >> 24) - DL_BITMAP_TRANSFORM_A] = signExtend(param, 24);
+		break;
+	case DL_SCISSOR_XY:
+		ctx.scissorX = (param >> 11) & 0x7ff;
+		ctx.scissorY = param & 0x7ff;
+		break;
+	case DL_SCISSOR_SIZE:
+		ctx.scissorWidth = (param >> 12) & 0xfff;
+		ctx.scissorHeight = param & 0xfff;
+		break;
+	case DL_BEGIN:
+		primitive = GraphicsPrimitive(param & 0x0f);
+		inPrimitive = true;
+		vertexCount = 0;
+		beginCost(primitive);
+		break;
+	case DL_COLOR_MASK:
+		ctx.colorMask = param & 0x0f;
+		break;
+	case DL_END:
+		inPrimitive = false;
+		currentCost = -1;
+		break;
+	case DL_SAVE_CONTEXT:
+		if(contextDepth < ARRAY_SIZE(contextStack)) {
+			contextStack[contextDepth++] = ctx;
+		}
+		break;
+	case DL_RESTORE_CONTEXT:
+		if(contextDepth != 0) {
+			ctx = contextStack[--contextDepth];
+		}
+		break;
+	case DL_CLEAR:
+		clear(param & 0x04, param & 0x02, param & 0x01);
+		break;
+	case DL_VERTEX_FORMAT:
+		ctx.vertexFormat = param & 0x07;
+		break;
+	case DL_PALETTE_SOURCE:
+		ctx.paletteSource = param & 0x3fffff;
+		break;
+	case DL_VERTEX_TRANSLATE_X:
+		ctx.translateX = signExtend(param, 17);
+		break;
+	case DL_VERTEX_TRANSLATE_Y:
+		ctx.translateY = signExtend(param, 17);
+		break;
+	case DL_NOP:
+	default:
+		break;
+	}
+
+	return true;
+}
+
+void Renderer::beginCost(uint8_t prim)
+{
+	currentCost = cost.primitives.size();
+	cost.primitives.push_back(PrimitiveCost{uint16_t(pc - 1), prim, 0, 0});
+}
+
+void Renderer::vertex(const Vertex& v)
+{
+	// Primitive remains in effect after END until the next BEGIN
+	if(currentCost < 0) {
+		beginCost(primitive);
+	}
+	++cost.primitives[currentCost].vertices;
+
+	switch(primitive) {
+	case GP_BITMAPS:
+		drawBitmap(v);
+		break;
+	case GP_POINTS:
+		drawPoint(v);
+		break;
+	case GP_LINES:
+		if(vertexCount & 1) {
+			drawLine(lastVertex, v);
+		}
+		break;
+	case GP_LINE_STRIP:
+		if(vertexCount != 0) {
+			drawLine(lastVertex, v);
+		}
+		break;
+	case GP_EDGE_STRIP_R:
+	case GP_EDGE_STRIP_L:
+	case GP_EDGE_STRIP_A:
+	case GP_EDGE_STRIP_B:
+		if(vertexCount != 0) {
+			drawEdge(lastVertex, v);
+		}
+		break;
+	case GP_RECTS:
+		if(vertexCount & 1) {
+			drawRect(lastVertex, v);
+		}
+		break;
+	default:
+		break;
+	}
+
+	lastVertex = v;
+	++vertexCount;
+}
+
+Renderer::Clip Renderer::getClip() const
+{
+	return Clip{
+		ctx.scissorX,
+		ctx.scissorY,
+		std::min(int(config.width), ctx.scissorX + ctx.scissorWidth),
+		std::min(int(config.height), ctx.scissorY + ctx.scissorHeight),
+	};
+}
+
+void Renderer::clear(bool clearColor, bool clearStencil, bool clearTag)
+{
+	beginCost(0);
+	auto clip = getClip();
+	uint32_t colorMask{0};
+	for(unsigned i = 0; i < 4; ++i) {
+		if(ctx.colorMask & (1 << i)) {
+			colorMask |= 0xff << (i * 8);
+		}
+	}
+	// COLOR_MASK bits are RGBA, buffer is ARGB
+	colorMask = (colorMask >> 8) | (colorMask << 24);
+
+	for(int y = clip.y0; y < clip.y1; ++y) {
+		for(int x = clip.x0; x < clip.x1; ++x) {
+			const unsigned i = y * config.width + x;
+			if(clearColor) {
+				color[i] = (color[i] & ~colorMask) | (ctx.clearColor & colorMask);
+			}
+			if(clearStencil) {
+				stencil[i] = (stencil[i] & ~ctx.stencilMask) | (ctx.clearStencil & ctx.stencilMask);
+			}
+			if(clearTag) {
+				tag[i] = ctx.clearTag;
+			}
+		}
+		// Clears are done in bulk by the hardware so aren't included in line cost
+		if(clip.x1 > clip.x0) {
+			cost.primitives[currentCost].pixels += clip.x1 - clip.x0;
+			cost.pixels += clip.x1 - clip.x0;
+		}
+	}
+	currentCost = -1;
+}
+
+void Renderer::fragment(int x, int y, uint32_t texel, float coverage)
+{
+	++cost.pixels;
+	++cost.lineCost[y];
+	++cost.primitives[currentCost].pixels;
+
+	// Modulate texel by current colour
+	const unsigned c = ctx.color;
+	unsigned a = getA(texel) * getA(c) / 255;
+	a = unsigned(a * coverage + 0.5f);
+	const unsigned r = getR(texel) * getR(c) / 255;
+	const unsigned g = getG(texel) * getG(c) / 255;
+	const unsigned b = getB(texel) * getB(c) / 255;
+
+	if(!test(ctx.alphaFunc, a, ctx.alphaRef)) {
+		return;
+	}
+
+	const unsigned i = y * config.width + x;
+	auto& s = stencil[i];
+	const bool pass = test(ctx.stencilFunc, s & ctx.stencilFuncMask, ctx.stencilRef & ctx.stencilFuncMask);
+	const uint8_t newStencil = stencilOp(pass ? ctx.stencilPass : ctx.stencilFail, s, ctx.stencilRef);
+	s = (s & ~ctx.stencilMask) | (newStencil & ctx.stencilMask);
+	if(!pass) {
+		return;
+	}
+
+	if(ctx.tagMask) {
+		tag[i] = ctx.tag;
+	}
+
+	auto& dst = color[i];
+	const unsigned da = getA(dst);
+	const unsigned sf = blendFactor(ctx.blendSrc, a, da);
+	const unsigned df = blendFactor(ctx.blendDst, a, da);
+	auto blend = [&](unsigned src, unsigned dst) { return std::min((src * sf + dst * df) / 255, 255U); };
+	const unsigned outR = (ctx.colorMask & 0x08) ? blend(r, getR(dst)) : getR(dst);
+	const unsigned outG = (ctx.colorMask & 0x04) ? blend(g, getG(dst)) : getG(dst);
+	const unsigned outB = (ctx.colorMask & 0x02) ? blend(b, getB(dst)) : getB(dst);
+	const unsigned outA = (ctx.colorMask & 0x01) ? blend(a, da) : da;
+	dst = makeARGB(outA, outR, outG, outB);
+}
+
+void Renderer::drawPoint(const Vertex& v)
+{
+	const float radius = ctx.pointSize / 16.0f;
+	auto clip = getClip();
+	const int x0 = std::max(clip.x0, int(floorf(v.x - radius)));
+	const int x1 = std::min(clip.x1, int(ceilf(v.x + radius)));
+	const int y0 = std::max(clip.y0, int(floorf(v.y - radius)));
+	const int y1 = std::min(clip.y1, int(ceilf(v.y + radius)));
+	for(int y = y0; y < y1; ++y) {
+		for(int x = x0; x < x1; ++x) {
+			const float d = std::hypot(x + 0.5f - v.x, y + 0.5f - v.y);
+			const float coverage = clamp01(radius - d + 0.5f);
+			if(coverage > 0) {
+				fragment(x, y, 0xffffffff, coverage);
+			}
+		}
+	}
+}
+
+void Renderer::drawLine(const Vertex& v0, const Vertex& v1)
+{
+	const float radius = ctx.lineWidth / 16.0f;
+	auto clip = getClip();
+	const int x0 = std::max(clip.x0, int(floorf(std::min(v0.x, v1.x) - radius)));
+	const int x1 = std::min(clip.x1, int(ceilf(std::max(v0.x, v1.x) + radius)));
+	const int y0 = std::max(clip.y0, int(floorf(std::min(v0.y, v1.y) - radius)));
+	const int y1 = std::min(clip.y1, int(ceilf(std::max(v0.y, v1.y) + radius)));
+	for(int y = y0; y < y1; ++y) {
+		for(int x = x0; x < x1; ++x) {
+			const float d = segmentDistance(x + 0.5f, y + 0.5f, v0.x, v0.y, v1.x, v1.y);
+			const float coverage = clamp01(radius - d + 0.5f);
+			if(coverage > 0) {
+				fragment(x, y, 0xffffffff, coverage);
+			}
+		}
+	}
+}
+
+void Renderer::drawRect(const Vertex& v0, const Vertex& v1)
+{
+	/*
+	 * Corners are rounded with radius of line width. With the default width of 1 pixel
+	 * the rectangle covers exactly the pixels from v0 to v1 inclusive.
+	 */
+	const float radius = ctx.lineWidth / 16.0f - 0.5f;
+	const float left = std::min(v0.x, v1.x) + 0.5f;
+	const float right = std::max(v0.x, v1.x) + 0.5f;
+	const float top = std::min(v0.y, v1.y) + 0.5f;
+	const float bottom = std::max(v0.y, v1.y) + 0.5f;
+	auto clip = getClip();
+	const int x0 = std::max(clip.x0, int(floorf(left - radius)));
+	const int x1 = std::min(clip.x1, int(ceilf(right + radius)));
+	const int y0 = std::max(clip.y0, int(floorf(top - radius)));
+	const int y1 = std::min(clip.y1, int(ceilf(bottom + radius)));
+	for(int y = y0; y < y1; ++y) {
+		const float py = y + 0.5f;
+		const float dy = std::max({top - py, 0.0f, py - bottom});
+		for(int x = x0; x < x1; ++x) {
+			const float px = x + 0.5f;
+			const float dx = std::max({left - px, 0.0f, px - right});
+			const float coverage = clamp01(radius - std::hypot(dx, dy) + 0.5f);
+			if(coverage > 0) {
+				fragment(x, y, 0xffffffff, coverage);
+			}
+		}
+	}
+}
+
+void Renderer::drawEdge(const Vertex& v0, const Vertex& v1)
+{
+	auto clip = getClip();
+
+	if(primitive == GP_EDGE_STRIP_R || primitive == GP_EDGE_STRIP_L) {
+		// Fill scanlines whose centres lie within the segment's vertical extent
+		const float ymin = std::min(v0.y, v1.y);
+		const float ymax = std::max(v0.y, v1.y);
+		const int y0 = std::max(clip.y0, int(ceilf(ymin - 0.5f)));
+		const int y1 = std::min(clip.y1, int(ceilf(ymax - 0.5f)));
+		for(int y = y0; y < y1; ++y) {
+			const float t = (y + 0.5f - v0.y) / (v1.y - v0.y);
+			const float edge = v0.x + t * (v1.x - v0.x);
+			const int xe = std::clamp(int(ceilf(edge - 0.5f)), clip.x0, clip.x1);
+			const int xa = (primitive == GP_EDGE_STRIP_R) ? xe : clip.x0;
+			const int xb = (primitive == GP_EDGE_STRIP_R) ? clip.x1 : xe;
+			for(int x = xa; x < xb; ++x) {
+				fragment(x, y, 0xffffffff, 1);
+			}
+		}
+		return;
+	}
+
+	const float xmin = std::min(v0.x, v1.x);
+	const float xmax = std::max(v0.x, v1.x);
+	const int x0 = std::max(clip.x0, int(ceilf(xmin - 0.5f)));
+	const int x1 = std::min(clip.x1, int(ceilf(xmax - 0.5f)));
+	for(int x = x0; x < x1; ++x) {
+		const float t = (x + 0.5f - v0.x) / (v1.x - v0.x);
+		const float edge = v0.y + t * (v1.y - v0.y);
+		const int ye = std::clamp(int(ceilf(edge - 0.5f)), clip.y0, clip.y1);
+		const int ya = (primitive == GP_EDGE_STRIP_B) ? ye : clip.y0;
+		const int yb = (primitive == GP_EDGE_STRIP_B) ? clip.y1 : ye;
+		for(int y = ya; y < yb; ++y) {
+			fragment(x, y, 0xffffffff, 1);
+		}
+	}
+}
+
+uint8_t Renderer::read8(uint32_t address) const
+{
+	return memory[address % EVE_MEMORY_SIZE];
+}
+
+uint16_t Renderer::read16(uint32_t address) const
+{
+	return read8(address) | (read8(address + 1) << 8);
+}
+
+uint32_t Renderer::read32(uint32_t address) const
+{
+	return read16(address) | (read16(address + 2) << 16);
+}
+
+uint32_t Renderer::fetchTexel(const BitmapHandle& bmp, uint32_t base, int u, int v) const
+{
+	const unsigned bpp = getBitsPerPixel(bmp.format);
+	if(bpp == 0) {
+		return 0;
+	}
+
+	// BARGRAPH is 256 x 256, looking up the column value in a single row
+	const int texWidth = (bmp.format == BMF_BARGRAPH) ? 256 : bmp.stride * 8 / bpp;
+	const int texHeight = (bmp.format == BMF_BARGRAPH) ? 256 : bmp.layoutHeight;
+	if(texWidth == 0 || texHeight == 0) {
+		return 0;
+	}
+	if(bmp.repeatX) {
+		u = ((u % texWidth) + texWidth) % texWidth;
+	} else if(u < 0 || u >= texWidth) {
+		return 0;
+	}
+	if(bmp.repeatY) {
+		v = ((v % texHeight) + texHeight) % texHeight;
+	} else if(v < 0 || v >= texHeight) {
+		return 0;
+	}
+
+	if(bmp.format == BMF_BARGRAPH) {
+		return (read8(base + u) < v) ? 0xffffffff : 0;
+	}
+
+	const uint32_t row = base + v * bmp.stride;
+	const uint32_t bitOffset = u * bpp;
+	const uint32_t addr = row + bitOffset / 8;
+	switch(bmp.format) {
+	case BMF_ARGB1555: {
+		auto p = read16(addr);
+		return makeARGB((p & 0x8000) ? 255 : 0, expand((p >> 10) & 0x1f, 5), expand((p >> 5) & 0x1f, 5),
+						expand(p & 0x1f, 5));
+	}
+	case BMF_L1:
+		return luminance(((read8(addr) >> (7 - bitOffset % 8)) & 0x01) ? 255 : 0);
+	case BMF_L2:
+		return luminance(expand((read8(addr) >> (6 - bitOffset % 8)) & 0x03, 2));
+	case BMF_L4:
+		return luminance(expand((read8(addr) >> (4 - bitOffset % 8)) & 0x0f, 4));
+	case BMF_L8:
+		return luminance(read8(addr));
+	case BMF_RGB332: {
+		auto p = read8(addr);
+		return makeARGB(255, expand(p >> 5, 3), expand((p >> 2) & 0x07, 3), expand(p & 0x03, 2));
+	}
+	case BMF_ARGB2: {
+		auto p = read8(addr);
+		return makeARGB(expand(p >> 6, 2), expand((p >> 4) & 0x03, 2), expand((p >> 2) & 0x03, 2),
+						expand(p & 0x03, 2));
+	}
+	case BMF_ARGB4:
+		return fromARGB4(read16(addr));
+	case BMF_RGB565:
+		return fromRGB565(read16(addr));
+	case BMF_PALETTED565:
+		return fromRGB565(read16(ctx.paletteSource + 2 * read8(addr)));
+	case BMF_PALETTED4444:
+		return fromARGB4(read16(ctx.paletteSource + 2 * read8(addr)));
+	case BMF_PALETTED8:
+		return read32(ctx.paletteSource + 4 * read8(addr));
+	default:
+		// PALETTED is FT80x only
+		return 0;
+	}
+}
+
+uint32_t Renderer::sampleBitmap(const BitmapHandle& bmp, uint32_t base, float u, float v) const
+{
+	if(!bmp.bilinear) {
+		return fetchTexel(bmp, base, int(floorf(u)), int(floorf(v)));
+	}
+
+	const float fu = u - 0.5f;
+	const float fv = v - 0.5f;
+	const int u0 = int(floorf(fu));
+	const int v0 = int(floorf(fv));
+	const float wu = fu - u0;
+	const float wv = fv - v0;
+	const uint32_t t[4]{
+		fetchTexel(bmp, base, u0, v0),
+		fetchTexel(bmp, base, u0 + 1, v0),
+		fetchTexel(bmp, base, u0, v0 + 1),
+		fetchTexel(bmp, base, u0 + 1, v0 + 1),
+	};
+	const float w[4]{(1 - wu) * (1 - wv), wu * (1 - wv), (1 - wu) * wv, wu * wv};
+	uint32_t result{0};
+	for(unsigned shift = 0; shift < 32; shift += 8) {
+		float sum{0};
+		for(unsigned i = 0; i < 4; ++i) {
+			sum += ((t[i] >> shift) & 0xff) * w[i];
+		}
+		result |= uint32_t(sum + 0.5f) << shift;
+	}
+	return result;
+}
+
+void Renderer::drawBitmap(const Vertex& v)
+{
+	const auto& bmp = handles[v.handle];
+	const uint32_t cellSize = (bmp.format == BMF_BARGRAPH) ? bmp.stride : bmp.stride * bmp.layoutHeight;
+	const uint32_t base = bmp.source + v.cell * cellSize;
+
+	// Size 0 means maximum
+	const int width = bmp.width ? bmp.width : 2048;
+	const int height = bmp.height ? bmp.height : 2048;
+
+	auto clip = getClip();
+	const int x0 = std::max(clip.x0, int(floorf(v.x)));
+	const int x1 = std::min(clip.x1, int(floorf(v.x)) + width);
+	const int y0 = std::max(clip.y0, int(floorf(v.y)));
+	const int y1 = std::min(clip.y1, int(floorf(v.y)) + height);
+
+	// Transform coefficients are 8.8 fixed-point
+	const float a = ctx.transform[0] / 256.0f;
+	const float b = ctx.transform[1] / 256.0f;
+	const float c = ctx.transform[2] / 256.0f;
+	const float d = ctx.transform[3] / 256.0f;
+	const float e = ctx.transform[4] / 256.0f;
+	const float f = ctx.transform[5] / 256.0f;
+
+	for(int y = y0; y < y1; ++y) {
+		const float dy = y + 0.5f - floorf(v.y);
+		for(int x = x0; x < x1; ++x) {
+			const float dx = x + 0.5f - floorf(v.x);
+			const float u = a * dx + b * dy + c;
+			const float tv = d * dx + e * dy + f;
+			fragment(x, y, sampleBitmap(bmp, base, u, tv), 1);
+		}
+	}
+}
+
+bool Renderer::writePng(Print& out) const
+{
+	PngWriter png(out, config.width, config.height);
+	if(!png.begin()) {
+		return false;
+	}
+	std::vector<uint8_t> row(config.width * 3);
+	for(unsigned y = 0; y < config.height; ++y) {
+		for(unsigned x = 0; x < config.width; ++x) {
+			const uint32_t c = color[y * config.width + x];
+			row[x * 3] = getR(c);
+			row[x * 3 + 1] = getG(c);
+			row[x * 3 + 2] = getB(c);
+		}
+		if(!png.writeRow(row.data())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+size_t Renderer::printCost(Print& p) const
+{
+	size_t n{0};
+	n += p.print("{\"commands\":");
+	n += p.print(cost.commands);
+	n += p.print(",\"pixels\":");
+	n += p.print(cost.pixels);
+	n += p.print(",\"max_line_cost\":");
+	n += p.print(cost.maxLineCost);
+	n += p.print(",\"line_budget\":");
+	n += p.print(config.lineBudget);
+	n += p.print(",\"lines_over_budget\":");
+	n += p.print(cost.linesOverBudget);
+	n += p.print(",\"primitives\":[");
+	char sep{' '};
+	for(auto& prim : cost.primitives) {
+		n += p.print(sep);
+		n += p.print("{\"index\":");
+		n += p.print(prim.index);
+		n += p.print(",\"primitive\":");
+		n += p.print(prim.primitive);
+		n += p.print(",\"vertices\":");
+		n += p.print(prim.vertices);
+		n += p.print(",\"pixels\":");
+		n += p.print(prim.pixels);
+		n += p.print('}');
+		sep = ',';
+	}
+	n += p.print("]}");
+	return n;
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,258 @@
+#include "include/Graphics/EVE/Gesture.h"
+#include <cstdlib>
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+namespace
+{
+uint32_t isqrt(uint64_t value)
+{
+	uint64_t result = 0;
+	uint64_t bit = 1ULL << 62;
+	while(bit > value) {
+		bit >>= 2;
+	}
+	while(bit != 0) {
+		if(value >= result + bit) {
+			value -= result + bit;
+			result = (result >> 1) + bit;
+		} else {
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
+	return result;
+}
+
+uint32_t distance(int32_t dx, int32_t dy)
+{
+	// Velocities can be large enough for the squares to overflow 32 bits
+	uint64_t x = std::abs(int64_t(dx));
+	uint64_t y = std::abs(int64_t(dy));
+	return isqrt(x * x + y * y);
+}
+
+} // namespace
+
+int32_t GestureDetector::atan2(int32_t y, int32_t x)
+{
+	if(x == 0 && y == 0) {
+		return 0;
+	}
+
+	// Reduce to first octant with r = min/max in Q15, then atan(r) ~= pi/4 r + 0.273 r (1 - r)
+	const uint32_t ax = abs(x);
+	const uint32_t ay = abs(y);
+	const bool swap = ay > ax;
+	const uint32_t r = swap ? (uint64_t(ax) << 15) / ay : (uint64_t(ay) << 15) / ax;
+	int32_t angle = ((8192 * r) >> 15) + ((uint64_t(2847) * r * (32768 - r)) >> 30);
+
+	if(swap) {
+		angle = 16384 - angle;
+	}
+	if(x < 0) {
+		angle = 32768 - angle;
+	}
+	if(y < 0) {
+		angle = -angle;
+	}
+	return angle;
+}
+
+Gesture GestureDetector::makeGesture(GestureType type, Gesture::Phase phase, const Track& track) const
+{
+	Gesture gesture{};
+	gesture.type = type;
+	gesture.phase = phase;
+	gesture.x = track.x;
+	gesture.y = track.y;
+	gesture.vx = std::clamp(track.vx, -32767, 32767);
+	gesture.vy = std::clamp(track.vy, -32767, 32767);
+	gesture.scale = 0x10000;
+	gesture.tag = track.tag;
+	return gesture;
+}
+
+void GestureDetector::emit(const Gesture& gesture)
+{
+	if(callback) {
+		callback(gesture);
+	}
+}
+
+void GestureDetector::pointDown(Track& track, const TouchPoint& point, uint32_t timestamp)
+{
+	track = Track{};
+	track.startX = track.x = point.x;
+	track.startY = track.y = point.y;
+	track.startTime = timestamp;
+	track.tag = point.tag;
+	track.down = true;
+	// Additional fingers during a two-finger gesture are ignored
+	track.multi = twoFinger;
+}
+
+void GestureDetector::pointMove(Track& track, const TouchPoint& point, uint32_t elapsed)
+{
+	const int16_t dx = point.x - track.x;
+	const int16_t dy = point.y - track.y;
+	track.x = point.x;
+	track.y = point.y;
+
+	if(elapsed != 0) {
+		track.vx = (track.vx + int32_t(int64_t(dx) * 1000000 / elapsed)) / 2;
+		track.vy = (track.vy + int32_t(int64_t(dy) * 1000000 / elapsed)) / 2;
+	}
+
+	if(track.multi) {
+		return;
+	}
+
+	if(!track.dragging) {
+		if(distance(track.x - track.startX, track.y - track.startY) <= config.slop) {
+			return;
+		}
+		track.dragging = true;
+		auto gesture = makeGesture(GestureType::drag, Gesture::Phase::begin, track);
+		gesture.dx = track.x - track.startX;
+		gesture.dy = track.y - track.startY;
+		emit(gesture);
+		return;
+	}
+
+	if(dx != 0 || dy != 0) {
+		auto gesture = makeGesture(GestureType::drag, Gesture::Phase::update, track);
+		gesture.dx = dx;
+		gesture.dy = dy;
+		emit(gesture);
+	}
+}
+
+void GestureDetector::pointUp(Track& track, uint32_t timestamp)
+{
+	track.down = false;
+	if(track.multi) {
+		return;
+	}
+
+	if(track.dragging) {
+		const bool fling = distance(track.vx, track.vy) >= config.flingSpeed;
+		emit(makeGesture(fling ? GestureType::fling : GestureType::drag, Gesture::Phase::end, track));
+		return;
+	}
+
+	if(timestamp - track.startTime <= config.tapTime * 1000U) {
+		emit(makeGesture(GestureType::tap, Gesture::Phase::end, track));
+	}
+}
+
+void GestureDetector::startTwoFinger()
+{
+	unsigned n = 0;
+	for(unsigned i = 0; i < TouchSnapshot::maxPoints; ++i) {
+		auto& track = tracks[i];
+		if(!track.down) {
+			continue;
+		}
+		if(track.dragging) {
+			emit(makeGesture(GestureType::drag, Gesture::Phase::end, track));
+			track.dragging = false;
+		}
+		track.multi = true;
+		(n++ == 0 ? first : second) = i;
+	}
+
+	auto& t1 = tracks[first];
+	auto& t2 = tracks[second];
+	startDistance = std::max(distance(t2.x - t1.x, t2.y - t1.y), 1U);
+	startAngle = atan2(t2.y - t1.y, t2.x - t1.x);
+	midX = (t1.x + t2.x) / 2;
+	midY = (t1.y + t2.y) / 2;
+	twoFinger = true;
+	pinching = false;
+	rotating = false;
+}
+
+void GestureDetector::updateTwoFinger(Gesture::Phase phase)
+{
+	auto& t1 = tracks[first];
+	auto& t2 = tracks[second];
+
+	Gesture gesture{};
+	gesture.phase = phase;
+	gesture.x = (t1.x + t2.x) / 2;
+	gesture.y = (t1.y + t2.y) / 2;
+	gesture.dx = gesture.x - midX;
+	gesture.dy = gesture.y - midY;
+	gesture.vx = std::clamp((t1.vx + t2.vx) / 2, -32767, 32767);
+	gesture.vy = std::clamp((t1.vy + t2.vy) / 2, -32767, 32767);
+	gesture.scale = (uint64_t(distance(t2.x - t1.x, t2.y - t1.y)) << 16) / startDistance;
+	gesture.angle = int16_t(atan2(t2.y - t1.y, t2.x - t1.x) - startAngle);
+	gesture.tag = t1.tag;
+	midX = gesture.x;
+	midY = gesture.y;
+
+	auto check = [&](GestureType type, bool& active, bool start) {
+		gesture.type = type;
+		if(phase == Gesture::Phase::end) {
+			if(active) {
+				emit(gesture);
+				active = false;
+			}
+		} else if(active) {
+			emit(gesture);
+		} else if(start) {
+			active = true;
+			gesture.phase = Gesture::Phase::begin;
+			emit(gesture);
+			gesture.phase = phase;
+		}
+	};
+
+	check(GestureType::pinch, pinching, uint32_t(abs(gesture.scale - 0x10000)) > config.pinchThreshold);
+	check(GestureType::rotate, rotating, uint32_t(abs(gesture.angle)) > config.rotateThreshold);
+}
+
+void GestureDetector::update(const TouchSnapshot& snapshot)
+{
+	const uint32_t now = snapshot.timestamp;
+	const uint32_t elapsed = now - lastTimestamp;
+	lastTimestamp = now;
+
+	if(twoFinger && !(snapshot.points[first].down && snapshot.points[second].down)) {
+		// Use final position of remaining finger for end event
+		for(auto i : {first, second}) {
+			if(snapshot.points[i].down) {
+				tracks[i].x = snapshot.points[i].x;
+				tracks[i].y = snapshot.points[i].y;
+			}
+		}
+		updateTwoFinger(Gesture::Phase::end);
+		twoFinger = false;
+	}
+
+	unsigned downCount = 0;
+	for(unsigned i = 0; i < TouchSnapshot::maxPoints; ++i) {
+		auto& track = tracks[i];
+		auto& point = snapshot.points[i];
+		if(point.down) {
+			++downCount;
+			if(track.down) {
+				pointMove(track, point, elapsed);
+			} else {
+				pointDown(track, point, now);
+			}
+		} else if(track.down) {
+			pointUp(track, now);
+		}
+	}
+
+	if(twoFinger) {
+		updateTwoFinger(Gesture::Phase::update);
+	} else if(downCount == 2) {
+		startTwoFinger();
+	}
+}
+
+} // namespace Graphics::EVE
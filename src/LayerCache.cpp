@@ -0,0 +1,61 @@
+#include "include/Graphics/EVE/LayerCache.h"
+
+namespace Graphics::EVE
+{
+bool LayerCache::beginCapture(CommandList& list) const
+{
+	const uint8_t alpha = (config.format == BMF_ARGB4) ? 0 : 0xff;
+	const uint32_t words[]{
+		MAKE_COPROC_CMD_WORD(CMD_DLSTART),
+		CLEAR_COLOR_RGB(config.background >> 16, config.background >> 8, config.background),
+		CLEAR_COLOR_A(alpha),
+		CLEAR(true, true, true),
+		SCISSOR_XY(config.x, config.y),
+		SCISSOR_SIZE(config.width, config.height),
+	};
+	return list.add(words);
+}
+
+bool LayerCache::endCapture(CommandList& list)
+{
+	const uint32_t words[]{
+		DISPLAY(),
+		MAKE_COPROC_CMD_WORD(CMD_SWAP),
+		// Waits for the swap so the snapshot sees the capture frame
+		MAKE_COPROC_CMD_WORD(CMD_DLSTART),
+		MAKE_COPROC_CMD_WORD(CMD_SNAPSHOT2),
+		config.format,
+		config.address,
+		MAKE_COPROC_PARAM16(config.x, config.y),
+		MAKE_COPROC_PARAM16(config.width, config.height),
+	};
+	if(!list.add(words)) {
+		return false;
+	}
+	valid = true;
+	return true;
+}
+
+bool LayerCache::draw(CommandList& list) const
+{
+	const uint16_t stride = config.width * 2;
+	const uint32_t words[]{
+		SAVE_CONTEXT(),
+		VERTEX_FORMAT(0),
+		BITMAP_HANDLE(config.handle),
+		BITMAP_SOURCE(config.address),
+		BITMAP_LAYOUT(config.format, stride, config.height),
+		BITMAP_LAYOUT_H(stride, config.height),
+		BITMAP_SIZE(BitmapFilter::NEAREST, BitmapWrap::BORDER, BitmapWrap::BORDER, config.width, config.height),
+		BITMAP_SIZE_H(config.width, config.height),
+		COLOR_RGB(0xff, 0xff, 0xff),
+		COLOR_A(0xff),
+		BEGIN(GP_BITMAPS),
+		VERTEX2F(config.x, config.y),
+		END(),
+		RESTORE_CONTEXT(),
+	};
+	return list.add(words);
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,180 @@
+#include "include/Graphics/EVE/LinkTuner.h"
+#include "include/Graphics/EVE/Crc.h"
+#include <cstring>
+
+namespace Graphics::EVE
+{
+namespace
+{
+unsigned bitsPerClock(HSPI::IoMode mode)
+{
+	switch(mode) {
+	case HSPI::IoMode::SQI:
+		return 4;
+	case HSPI::IoMode::SDI:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+} // namespace
+
+bool LinkTuner::tune(const Config& config)
+{
+	if(config.testSize < 4 || config.testSize % 4 != 0 || config.scratchAddress % 4 != 0 ||
+	   config.scratchAddress + config.testSize > EVE_RAM_G_SIZE) {
+		debug_e("[EVE] LinkTuner scratch region invalid");
+		return false;
+	}
+	if(config.minSpeed == 0 || config.step == 0 || config.maxSpeed < config.minSpeed) {
+		debug_e("[EVE] LinkTuner speed range invalid");
+		return false;
+	}
+
+	stopMonitor();
+	this->config = config;
+	pattern.reset(new uint32_t[config.testSize / 4]);
+	readback.reset(new uint32_t[config.testSize / 4]);
+
+	HSPI::IoMode bestMode{HSPI::IoMode::SPIHD};
+	uint32_t bestSpeed{0};
+	uint32_t bestRate{0};
+	for(auto mode : {HSPI::IoMode::SQI, HSPI::IoMode::SDI, HSPI::IoMode::SPIHD}) {
+		if(!config.modes[mode] || !display.isSupported(mode)) {
+			continue;
+		}
+		unsigned passed{0};
+		for(uint32_t speed = config.minSpeed; speed <= config.maxSpeed; speed += config.step) {
+			select(mode, speed);
+			bool ok{true};
+			for(unsigned i = 0; ok && i < config.passes; ++i) {
+				ok = check(nextSeed++);
+			}
+			if(!ok) {
+				break;
+			}
+			++passed;
+		}
+		debug_i("[EVE] Link %s: %u steps passed", toString(mode), passed);
+		if(passed == 0) {
+			continue;
+		}
+		auto steps = (passed > config.margin) ? passed - 1 - config.margin : 0;
+		uint32_t speed = config.minSpeed + steps * config.step;
+		uint32_t rate = speed * bitsPerClock(mode);
+		if(rate > bestRate) {
+			bestMode = mode;
+			bestSpeed = speed;
+			bestRate = rate;
+		}
+	}
+
+	if(bestRate == 0) {
+		select(HSPI::IoMode::SPIHD, config.minSpeed);
+		debug_e("[EVE] Link failed at all settings");
+		return false;
+	}
+
+	select(bestMode, bestSpeed);
+	debug_i("[EVE] Link selected %s @ %u Hz", toString(bestMode), display.getSpeed());
+	return true;
+}
+
+bool LinkTuner::verify()
+{
+	if(!pattern) {
+		debug_e("[EVE] LinkTuner: call tune() first");
+		return false;
+	}
+	return check(nextSeed++);
+}
+
+void LinkTuner::select(HSPI::IoMode mode, uint32_t speed)
+{
+	display.setSpeed(config.minSpeed);
+	display.setIoMode(mode);
+	display.setSpeed(speed);
+}
+
+bool LinkTuner::check(uint32_t seed)
+{
+	// xorshift32, seed must be non-zero
+	uint32_t x = seed | 1;
+	const unsigned count = config.testSize / 4;
+	for(unsigned i = 0; i < count; ++i) {
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		pattern[i] = x;
+	}
+
+	display.blockWrite(config.scratchAddress, pattern.get(), count);
+	uint32_t crc;
+	if(!memcrc(crc) || crc != crc32(pattern.get(), config.testSize)) {
+		return false;
+	}
+
+	display.read(config.scratchAddress, readback.get(), config.testSize);
+	return memcmp(pattern.get(), readback.get(), config.testSize) == 0;
+}
+
+bool LinkTuner::memcrc(uint32_t& crc)
+{
+	const uint32_t words[]{
+		MAKE_COPROC_CMD_WORD(CMD_MEMCRC),
+		config.scratchAddress,
+		config.testSize,
+		0,
+	};
+	if(!display.sendCommands(words, ARRAY_SIZE(words))) {
+		recover();
+		return false;
+	}
+	// Result replaces the last parameter
+	auto mark = display.getFifoPosition();
+	if(!display.waitCommandsIdle()) {
+		recover();
+		return false;
+	}
+	crc = display.readResult(mark);
+	return true;
+}
+
+void LinkTuner::recover()
+{
+	// Corrupt commands may have faulted or stalled the co-processor
+	display.setSpeed(config.minSpeed);
+	if(!display.checkFault() && !display.waitCommandsIdle()) {
+		display.recoverCoprocessor();
+	}
+}
+
+void LinkTuner::startMonitor(unsigned intervalMs, Callback callback)
+{
+	if(!pattern) {
+		debug_e("[EVE] LinkTuner: call tune() first");
+		return;
+	}
+	this->callback = callback;
+	timer.initializeMs(
+		intervalMs, [](void* param) { static_cast<LinkTuner*>(param)->monitor(); }, this);
+	timer.start();
+}
+
+void LinkTuner::monitor()
+{
+	// A failed check may already have dropped to minSpeed, so step down from the speed in use
+	auto speed = display.getSpeed();
+	bool ok = verify();
+	if(!ok) {
+		speed = (speed >= config.minSpeed + config.step) ? speed - config.step : config.minSpeed;
+		debug_w("[EVE] Link check failed, reducing clock to %u Hz", speed);
+		select(display.getIoMode(), speed);
+	}
+	if(callback) {
+		callback(ok);
+	}
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,126 @@
+#include "include/Graphics/EVE/PngWriter.h"
+#include "include/Graphics/EVE/Crc.h"
+
+namespace Graphics::EVE
+{
+namespace
+{
+void setBE32(uint8_t* buf, uint32_t value)
+{
+	buf[0] = value >> 24;
+	buf[1] = value >> 16;
+	buf[2] = value >> 8;
+	buf[3] = value;
+}
+
+uint32_t adler32(const uint8_t* data, size_t length, uint32_t adler)
+{
+	uint32_t a = adler & 0xffff;
+	uint32_t b = adler >> 16;
+	while(length-- != 0) {
+		a = (a + *data++) % 65521;
+		b = (b + a) % 65521;
+	}
+	return (b << 16) | a;
+}
+
+} // namespace
+
+bool PngWriter::beginChunk(const char* type, uint32_t length)
+{
+	uint8_t buf[4];
+	setBE32(buf, length);
+	if(out.write(buf, 4) != 4) {
+		return false;
+	}
+	crc = 0;
+	return chunkData(type, 4);
+}
+
+bool PngWriter::chunkData(const void* data, size_t length)
+{
+	crc = crc32(data, length, crc);
+	return out.write(static_cast<const uint8_t*>(data), length) == length;
+}
+
+bool PngWriter::endChunk()
+{
+	uint8_t buf[4];
+	setBE32(buf, crc);
+	return out.write(buf, 4) == 4;
+}
+
+bool PngWriter::begin()
+{
+	static constexpr uint8_t signature[]{0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+	if(out.write(signature, sizeof(signature)) != sizeof(signature)) {
+		return false;
+	}
+
+	// Width, height, bit depth 8, colour type 2 (RGB), default compression, filter and interlace
+	uint8_t header[13]{};
+	setBE32(&header[0], width);
+	setBE32(&header[4], height);
+	header[8] = 8;
+	header[9] = 2;
+
+	row = 0;
+	adler = 1;
+	return beginChunk("IHDR", sizeof(header)) && chunkData(header, sizeof(header)) && endChunk();
+}
+
+bool PngWriter::writeRow(const uint8_t* rgb)
+{
+	if(isFinished()) {
+		return false;
+	}
+
+	const bool first = (row == 0);
+	const bool last = (row + 1 == height);
+	const uint16_t blockLength = 1 + width * 3;
+
+	// Each row is a stored deflate block, prefixed by the zlib header and followed by its checksum
+	const uint32_t chunkLength = (first ? 2 : 0) + 5 + blockLength + (last ? 4 : 0);
+	if(!beginChunk("IDAT", chunkLength)) {
+		return false;
+	}
+	if(first) {
+		static constexpr uint8_t zlibHeader[]{0x78, 0x01};
+		if(!chunkData(zlibHeader, sizeof(zlibHeader))) {
+			return false;
+		}
+	}
+
+	const uint8_t blockHeader[]{
+		uint8_t(last),
+		uint8_t(blockLength),
+		uint8_t(blockLength >> 8),
+		uint8_t(~blockLength),
+		uint8_t(~blockLength >> 8),
+		0, // Filter type: none
+	};
+	if(!chunkData(blockHeader, sizeof(blockHeader)) || !chunkData(rgb, width * 3)) {
+		return false;
+	}
+	adler = adler32(&blockHeader[5], 1, adler);
+	adler = adler32(rgb, width * 3, adler);
+
+	if(last) {
+		uint8_t buf[4];
+		setBE32(buf, adler);
+		if(!chunkData(buf, sizeof(buf))) {
+			return false;
+		}
+	}
+	if(!endChunk()) {
+		return false;
+	}
+
+	++row;
+	if(last) {
+		return beginChunk("IEND", 0) && endChunk();
+	}
+	return true;
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,209 @@
+#include "include/Graphics/EVE/RegisterCache.h"
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Registers only written by the host
+constexpr Register hostOwnedRegisters[]{
+	REG_HCYCLE,			  REG_HOFFSET,		   REG_HSIZE,			 REG_HSYNC0,
+	REG_HSYNC1,			  REG_VCYCLE,		   REG_VOFFSET,			 REG_VSIZE,
+	REG_VSYNC0,			  REG_VSYNC1,		   REG_ROTATE,			 REG_OUTBITS,
+	REG_DITHER,			  REG_SWIZZLE,		   REG_CSPREAD,			 REG_PCLK_POL,
+	REG_PCLK,			  REG_TAG_X,		   REG_TAG_Y,			 REG_VOL_PB,
+	REG_VOL_SOUND,		  REG_SOUND,		   REG_GPIO_DIR,		 REG_GPIOX_DIR,
+	REG_INT_EN,			  REG_INT_MASK,		   REG_PLAYBACK_START,	 REG_PLAYBACK_LENGTH,
+	REG_PLAYBACK_FREQ,	  REG_PLAYBACK_FORMAT, REG_PLAYBACK_LOOP,	 REG_PWM_HZ,
+	REG_PWM_DUTY,		  REG_MACRO_0,		   REG_MACRO_1,			 REG_TOUCH_MODE,
+	REG_TOUCH_ADC_MODE,	  REG_TOUCH_CHARGE,	   REG_TOUCH_SETTLE,	 REG_TOUCH_OVERSAMPLE,
+	REG_TOUCH_RZTHRESH,	  REG_TOUCH_CONFIG,	   REG_SPI_WIDTH,
+};
+
+// Registers whose writes can be elided, but which read back input pin states
+constexpr Register writeOnlyRegisters[]{
+	REG_GPIO,
+	REG_GPIOX,
+};
+
+struct Bitmap {
+	uint32_t words[(RegisterCache::count + 31) / 32];
+
+	constexpr void set(uint32_t address)
+	{
+		auto index = (address - RegisterCache::firstRegister) / 4;
+		words[index / 32] |= 1U << (index % 32);
+	}
+
+	constexpr bool get(unsigned index) const
+	{
+		return words[index / 32] & (1U << (index % 32));
+	}
+};
+
+constexpr Bitmap makeBitmap(bool includeWriteOnly)
+{
+	Bitmap map{};
+	for(auto reg : hostOwnedRegisters) {
+		map.set(reg);
+	}
+	if(includeWriteOnly) {
+		for(auto reg : writeOnlyRegisters) {
+			map.set(reg);
+		}
+	}
+	return map;
+}
+
+constexpr Bitmap shadowedMap = makeBitmap(true);
+constexpr Bitmap hostOwnedMap = makeBitmap(false);
+
+// Longest run of clean registers included between dirty ones in a burst write
+constexpr unsigned maxBridge{4};
+
+uint32_t sizeMask(unsigned size)
+{
+	return (size >= 4) ? 0xffffffff : (1U << (size * 8)) - 1;
+}
+
+} // namespace
+
+bool RegisterCache::isShadowed(unsigned index)
+{
+	return shadowedMap.get(index);
+}
+
+bool RegisterCache::isHostOwned(unsigned index)
+{
+	return hostOwnedMap.get(index);
+}
+
+bool RegisterCache::read(uint32_t address, unsigned size, uint32_t& value) const
+{
+	if(address % 4 != 0) {
+		return false;
+	}
+	auto index = getIndex(address);
+	if(!(flags[index] & flagValid) || !isHostOwned(index)) {
+		return false;
+	}
+	value = values[index] & sizeMask(size);
+	return true;
+}
+
+bool RegisterCache::write(uint32_t address, uint32_t value, unsigned size)
+{
+	if(address == REG_CPURESET) {
+		invalidateClean();
+		return true;
+	}
+	auto index = getIndex(address);
+	if(address % 4 != 0) {
+		invalidate(address, size);
+		return true;
+	}
+	if(!isShadowed(index)) {
+		return true;
+	}
+
+	auto& flag = flags[index];
+	if(flag & flagValid) {
+		auto mask = sizeMask(size);
+		value = (values[index] & ~mask) | (value & mask);
+		if(values[index] == value && !(flag & flagDirty)) {
+			return false;
+		}
+	}
+	values[index] = value;
+	if(flag & flagDirty) {
+		// Staged value is superseded by this write
+		--dirtyCount;
+	}
+	flag = flagValid;
+	return true;
+}
+
+bool RegisterCache::set(uint32_t address, uint32_t value)
+{
+	if(!contains(address) || address % 4 != 0) {
+		return false;
+	}
+	auto index = getIndex(address);
+	if(!isShadowed(index)) {
+		return false;
+	}
+	auto& flag = flags[index];
+	if((flag & flagValid) && values[index] == value) {
+		return true;
+	}
+	values[index] = value;
+	if(!(flag & flagDirty)) {
+		++dirtyCount;
+	}
+	flag = flagValid | flagDirty;
+	return true;
+}
+
+unsigned RegisterCache::nextDirtyRun(uint32_t& address, const uint32_t*& values)
+{
+	if(dirtyCount == 0) {
+		return 0;
+	}
+
+	unsigned first = 0;
+	while(!(flags[first] & flagDirty)) {
+		++first;
+	}
+	unsigned last = first;
+	for(unsigned i = first + 1; i < count && i <= last + maxBridge + 1; ++i) {
+		if(!(flags[i] & flagValid)) {
+			break;
+		}
+		if(flags[i] & flagDirty) {
+			last = i;
+		}
+	}
+
+	for(unsigned i = first; i <= last; ++i) {
+		if(flags[i] & flagDirty) {
+			flags[i] &= ~flagDirty;
+			--dirtyCount;
+		}
+	}
+
+	address = firstRegister + first * 4;
+	values = &this->values[first];
+	return last - first + 1;
+}
+
+void RegisterCache::invalidate()
+{
+	std::fill_n(flags, count, 0);
+	dirtyCount = 0;
+}
+
+void RegisterCache::invalidateClean()
+{
+	for(auto& flag : flags) {
+		if(!(flag & flagDirty)) {
+			flag = 0;
+		}
+	}
+}
+
+void RegisterCache::invalidateRange(uint32_t address, uint32_t end)
+{
+	if(address <= REG_CPURESET && end >= REG_CPURESET) {
+		invalidateClean();
+	}
+	auto first = getIndex(std::max(address, firstRegister));
+	auto last = getIndex(std::min(end, lastRegister));
+	for(unsigned i = first; i <= last; ++i) {
+		if(flags[i] & flagDirty) {
+			--dirtyCount;
+		}
+		flags[i] = 0;
+	}
+}
+
+} // namespace Graphics::EVE
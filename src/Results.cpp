@@ -0,0 +1,193 @@
+#include "include/Graphics/EVE/Results.h"
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Interval between co-processor progress checks
+constexpr unsigned pollIntervalMs{1};
+
+constexpr unsigned maxWords{16};
+
+} // namespace
+
+bool ResultQueue::submit(CoproCommand cmd, const uint32_t* params, unsigned paramCount, unsigned resultCount,
+						 Callback callback)
+{
+	if(resultCount == 0 || resultCount > maxValues || 1 + paramCount + resultCount > maxWords ||
+	   resultCount * 4 > bufferSize) {
+		debug_e("[EVE] Invalid result command");
+		return false;
+	}
+	if(count >= maxPending) {
+		debug_e("[EVE] Result queue full");
+		return false;
+	}
+
+	uint32_t words[maxWords]{MAKE_COPROC_CMD_WORD(cmd)};
+	std::copy_n(params, paramCount, &words[1]);
+	if(count == 0) {
+		faults = display.getStats().coproFaults;
+	}
+	if(!display.sendCommands(words, 1 + paramCount + resultCount)) {
+		return false;
+	}
+
+	auto& entry = at(count);
+	entry.end = display.getFifoPosition();
+	entry.count = resultCount;
+	entry.callback = callback;
+	++count;
+
+	if(state == State::idle && !timer.isStarted()) {
+		timer.initializeMs(
+			pollIntervalMs, [](void* param) { static_cast<ResultQueue*>(param)->poll(); }, this);
+		timer.startOnce();
+	}
+	return true;
+}
+
+void ResultQueue::cancel()
+{
+	timer.stop();
+	display.wait(request);
+	display.wait(request2);
+	state = State::idle;
+	while(count != 0) {
+		at(0).callback = nullptr;
+		head = (head + 1) % maxPending;
+		--count;
+	}
+}
+
+void ResultQueue::poll()
+{
+	if(count == 0) {
+		return;
+	}
+	// REG_CMD_READ and REG_CMD_WRITE are adjacent. Earlier writes have completed by the time this
+	// read executes, so REG_CMD_WRITE will correspond to the current position.
+	state = State::polling;
+	pollPosition = display.getFifoPosition();
+	display.read(request, REG_CMD_READ, fifoRegs, sizeof(fifoRegs), requestComplete, this);
+}
+
+bool ResultQueue::requestComplete(HSPI::Request& request)
+{
+	// May be in interrupt context
+	static_cast<ResultQueue*>(request.param)->task.queue();
+	return true;
+}
+
+void ResultQueue::process()
+{
+	switch(state) {
+	case State::idle:
+		// Cancelled
+		return;
+
+	case State::polling:
+		state = State::idle;
+		if(fifoRegs[0] == EVE_CMDFIFO_FAULT || display.getStats().coproFaults != faults) {
+			display.checkFault();
+			fail(count);
+			faults = display.getStats().coproFaults;
+			return;
+		}
+		startRead(fifoRegs[0], fifoRegs[1] & EVE_CMDFIFO_MASK);
+		return;
+
+	case State::reading:
+		state = State::idle;
+		for(unsigned i = 0; i < reading; ++i) {
+			auto& entry = at(0);
+			pop(true, &buffer[(entry.end - entry.count * 4 - readStart) / 4]);
+		}
+		break;
+	}
+
+	if(count != 0) {
+		timer.startOnce();
+	}
+}
+
+void ResultQueue::startRead(uint16_t readPtr, uint16_t writePtr)
+{
+	const uint32_t position = display.getFifoPosition();
+
+	// Results more than one FIFO length behind the host have been overwritten
+	unsigned lost{0};
+	while(lost < count && position - (at(lost).end - at(lost).count * 4) > EVE_CMDFIFO_SIZE) {
+		++lost;
+	}
+	if(lost != 0) {
+		debug_w("[EVE] %u command results overwritten", lost);
+		fail(lost);
+	}
+
+	// Find commands which the co-processor has completed and whose results fit in the buffer
+	const uint32_t readPosition = pollPosition - ((writePtr - readPtr) & EVE_CMDFIFO_MASK);
+	unsigned resolved{0};
+	uint32_t start{0};
+	uint32_t end{0};
+	while(resolved < count) {
+		auto& entry = at(resolved);
+		if(int32_t(readPosition - entry.end) < 0) {
+			break;
+		}
+		if(resolved == 0) {
+			start = entry.end - entry.count * 4;
+		} else if(entry.end - start > bufferSize) {
+			break;
+		}
+		end = entry.end;
+		++resolved;
+	}
+
+	if(resolved == 0) {
+		if(count != 0) {
+			timer.startOnce();
+		}
+		return;
+	}
+
+	reading = resolved;
+	readStart = start;
+	state = State::reading;
+	const uint16_t length = end - start;
+	const uint16_t offset = start & EVE_CMDFIFO_MASK;
+	const uint16_t first = std::min(length, uint16_t(EVE_CMDFIFO_SIZE - offset));
+	if(first < length) {
+		display.read(request, EVE_RAM_CMD + offset, buffer.get(), first);
+		display.read(request2, EVE_RAM_CMD, reinterpret_cast<uint8_t*>(buffer.get()) + first, length - first,
+					 requestComplete, this);
+	} else {
+		display.read(request, EVE_RAM_CMD + offset, buffer.get(), length, requestComplete, this);
+	}
+}
+
+void ResultQueue::fail(unsigned n)
+{
+	while(n-- != 0 && count != 0) {
+		pop(false, nullptr);
+	}
+}
+
+void ResultQueue::pop(bool success, const uint32_t* values)
+{
+	auto& entry = at(0);
+	Result result{success, entry.count, {}};
+	if(values != nullptr) {
+		std::copy_n(values, entry.count, result.values);
+	}
+	// Callback may submit further commands
+	auto callback = entry.callback;
+	entry.callback = nullptr;
+	head = (head + 1) % maxPending;
+	--count;
+	if(callback) {
+		callback(result);
+	}
+}
+
+} // namespace Graphics::EVE
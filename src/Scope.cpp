@@ -0,0 +1,91 @@
+#include "include/Graphics/EVE/Scope.h"
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+void ScopeTrace::upload(EveDisplay& display, const uint8_t* samples, HSPI::Callback callback, void* param)
+{
+	display.write(request, config.address, samples, config.width, callback, param);
+}
+
+void ScopeTrace::addCells(CommandList& list, int16_t y) const
+{
+	for(unsigned cell = 0; cell < getCellCount(); ++cell) {
+		list.add(CELL(cell));
+		list.add(VERTEX2F(config.x + cell * cellWidth, y));
+	}
+}
+
+bool ScopeTrace::draw(CommandList& list) const
+{
+	const unsigned cellCount = getCellCount();
+	const unsigned wordCount = (config.style == Style::line) ? 24 + 6 * cellCount : 16 + 2 * cellCount;
+	if(config.height == 0 || list.available() < wordCount) {
+		return false;
+	}
+
+	// Bitmap y coordinate = E * screen y / 256, so this maps full height onto 0-255.
+	// E is signed 8.8 fixed point so a one-pixel trace is limited to the largest positive value.
+	const uint32_t scaleY = std::min((256U * 256U) / config.height, 0xffffU);
+
+	const uint32_t setup[]{
+		SAVE_CONTEXT(),
+		VERTEX_FORMAT(0),
+		BITMAP_HANDLE(config.handle),
+		BITMAP_SOURCE(config.address),
+		BITMAP_LAYOUT(BMF_BARGRAPH, cellWidth, 1),
+		BITMAP_LAYOUT_H(cellWidth, 1),
+		BITMAP_SIZE(BitmapFilter::NEAREST, BitmapWrap::BORDER, BitmapWrap::BORDER, cellWidth, config.height),
+		BITMAP_SIZE_H(cellWidth, config.height),
+		BITMAP_TRANSFORM_E(scaleY),
+		SCISSOR_XY(config.x, config.y),
+		SCISSOR_SIZE(config.width, config.height),
+	};
+	list.add(setup);
+
+	const uint32_t color[]{
+		COLOR_RGB(config.color >> 16, config.color >> 8, config.color),
+		COLOR_A(config.alpha),
+	};
+
+	if(config.style == Style::bargraph) {
+		list.add(color);
+		list.add(BEGIN(GP_BITMAPS));
+		addCells(list, config.y);
+		list.add(END());
+		list.add(RESTORE_CONTEXT());
+		return true;
+	}
+
+	/*
+	 * Line style: render the bargraph twice into stencil only, offset by thickness.
+	 * Stencil is then 1 for the band we want and 2 below it.
+	 * Transparent bargraph pixels are discarded by alpha test so they don't affect stencil.
+	 */
+	const uint32_t stencilSetup[]{
+		COLOR_MASK(false, false, false, false),
+		COLOR_A(0xff),
+		ALPHA_FUNC(TestFunction::GREATER, 0),
+		STENCIL_FUNC(TestFunction::ALWAYS, 0, 0xff),
+		STENCIL_OP(StencilOp::INCR, StencilOp::INCR),
+		BEGIN(GP_BITMAPS),
+	};
+	list.add(stencilSetup);
+	addCells(list, config.y);
+	addCells(list, config.y + config.thickness);
+
+	// Draw where stencil is 1, zeroing all touched stencil values on the way
+	const uint32_t colorSetup[]{
+		COLOR_MASK(true, true, true, true),
+		STENCIL_FUNC(TestFunction::EQUAL, 1, 0xff),
+		STENCIL_OP(StencilOp::ZERO, StencilOp::ZERO),
+	};
+	list.add(colorSetup);
+	list.add(color);
+	addCells(list, config.y);
+	list.add(END());
+	list.add(RESTORE_CONTEXT());
+	return true;
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,199 @@
+#include "include/Graphics/EVE/Screenshot.h"
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Interval between co-processor completion checks
+constexpr unsigned pollIntervalMs{1};
+
+} // namespace
+
+bool Screenshot::begin(Print& output, const Config& config, Callback callback)
+{
+	if(isBusy()) {
+		debug_e("[EVE] Screenshot already in progress");
+		return false;
+	}
+
+	width = display.read16(REG_HSIZE);
+	height = display.read16(REG_VSIZE);
+	const unsigned rowBytes = width * 2;
+	if(rowBytes == 0 || height == 0) {
+		debug_e("[EVE] Screenshot requires REG_HSIZE, REG_VSIZE");
+		return false;
+	}
+
+	stripRows = std::min(config.scratchSize / rowBytes, uint32_t(height));
+	if(stripRows == 0 || (config.scratchAddress % 4) != 0 ||
+	   config.scratchAddress + stripRows * rowBytes > EVE_RAM_G_SIZE) {
+		debug_e("[EVE] Screenshot scratch region invalid");
+		return false;
+	}
+
+	// Transfer length is 16 bits
+	chunkRows = std::min(config.readSize, uint16_t(0xffff)) / rowBytes;
+	chunkRows = std::max(chunkRows, uint16_t(1));
+	chunkRows = std::min(chunkRows, stripRows);
+
+	this->config = config;
+	this->callback = callback;
+	out = &output;
+	buffer.reset(new uint8_t[chunkRows * rowBytes]);
+	if(config.format == Format::png) {
+		rgb.reset(new uint8_t[width * 3]);
+		png.reset(new PngWriter(output, width, height));
+		if(!png->begin()) {
+			this->callback = nullptr;
+			complete(false);
+			return false;
+		}
+	}
+
+	timer.initializeMs(
+		pollIntervalMs, [](void* param) { static_cast<Screenshot*>(param)->poll(); }, this);
+	stripY = 0;
+	startStrip();
+	return true;
+}
+
+void Screenshot::cancel()
+{
+	if(!isBusy()) {
+		return;
+	}
+	display.wait(request);
+	callback = nullptr;
+	complete(false);
+}
+
+void Screenshot::startStrip()
+{
+	stripHeight = std::min(stripRows, uint16_t(height - stripY));
+	const uint32_t words[]{
+		MAKE_COPROC_CMD_WORD(CMD_SNAPSHOT2),
+		BMF_RGB565,
+		config.scratchAddress,
+		uint32_t(stripY) << 16,
+		(uint32_t(stripHeight) << 16) | width,
+	};
+	if(!display.sendCommands(words, ARRAY_SIZE(words))) {
+		complete(false);
+		return;
+	}
+	// Snapshot is complete once the co-processor has read past this point
+	fifoMark = display.getFifoPosition();
+	state = State::snapshot;
+	timer.startOnce();
+}
+
+void Screenshot::poll()
+{
+	// REG_CMD_READ and REG_CMD_WRITE are adjacent
+	display.read(request, REG_CMD_READ, fifoRegs, sizeof(fifoRegs), readComplete, this);
+}
+
+void Screenshot::startRead()
+{
+	const unsigned rowBytes = width * 2;
+	readRows = std::min(chunkRows, uint16_t(stripHeight - stripRow));
+	display.read(request, config.scratchAddress + stripRow * rowBytes, buffer.get(), readRows * rowBytes,
+				 readComplete, this);
+}
+
+bool Screenshot::readComplete(HSPI::Request& request)
+{
+	// May be in interrupt context
+	static_cast<Screenshot*>(request.param)->task.queue();
+	return true;
+}
+
+void Screenshot::process()
+{
+	switch(state) {
+	case State::idle:
+		// Cancelled
+		return;
+
+	case State::snapshot:
+		switch(EveDisplay::getFifoProgress(fifoMark, fifoRegs[0], fifoRegs[1])) {
+		case EveDisplay::FifoProgress::pending:
+			timer.startOnce();
+			return;
+		case EveDisplay::FifoProgress::fault:
+			debug_e("[EVE] Screenshot: co-processor fault");
+			complete(false);
+			return;
+		case EveDisplay::FifoProgress::passed:
+			break;
+		}
+		state = State::reading;
+		stripRow = 0;
+		startRead();
+		return;
+
+	case State::reading:
+		if(!output(readRows)) {
+			debug_e("[EVE] Screenshot: output error");
+			complete(false);
+			return;
+		}
+		stripRow += readRows;
+		if(stripRow < stripHeight) {
+			startRead();
+			return;
+		}
+		stripY += stripHeight;
+		if(stripY < height) {
+			startStrip();
+		} else {
+			complete(true);
+		}
+		return;
+	}
+}
+
+bool Screenshot::output(unsigned rows)
+{
+	const unsigned rowBytes = width * 2;
+	if(!png) {
+		return out->write(buffer.get(), rows * rowBytes) == rows * rowBytes;
+	}
+
+	auto src = buffer.get();
+	for(unsigned row = 0; row < rows; ++row) {
+		auto dst = rgb.get();
+		for(unsigned x = 0; x < width; ++x) {
+			uint16_t c = src[0] | (src[1] << 8);
+			src += 2;
+			uint8_t r = c >> 11;
+			uint8_t g = (c >> 5) & 0x3f;
+			uint8_t b = c & 0x1f;
+			// Replicate high bits so full-scale values map to 0xff
+			*dst++ = (r << 3) | (r >> 2);
+			*dst++ = (g << 2) | (g >> 4);
+			*dst++ = (b << 3) | (b >> 2);
+		}
+		if(!png->writeRow(rgb.get())) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void Screenshot::complete(bool success)
+{
+	timer.stop();
+	state = State::idle;
+	png.reset();
+	buffer.reset();
+	rgb.reset();
+	out = nullptr;
+	auto cb = callback;
+	callback = nullptr;
+	if(cb) {
+		cb(success);
+	}
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,145 @@
+#include "include/Graphics/EVE/Scrubber.h"
+#include "include/Graphics/EVE/Crc.h"
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+bool Scrubber::add(uint32_t address, uint32_t size, Reload reload, const void* data)
+{
+	if(count >= maxAssets) {
+		debug_e("[EVE] Scrubber table full");
+		return false;
+	}
+	if(size == 0 || address % 4 != 0 || address + size > EVE_RAM_G_SIZE || chunkSize == 0 || chunkSize % 4 != 0) {
+		debug_e("[EVE] Scrubber region invalid");
+		return false;
+	}
+
+	auto& asset = assets[count];
+	asset.address = address;
+	asset.size = size;
+	asset.reload = reload;
+	asset.crcs.reset(new uint32_t[getChunkCount(asset)]);
+	asset.learned = (data == nullptr);
+	asset.known = 0;
+	if(data != nullptr) {
+		auto bytes = static_cast<const uint8_t*>(data);
+		for(uint32_t offset = 0; offset < size; offset += chunkSize) {
+			asset.crcs[asset.known++] = crc32(bytes + offset, std::min(uint32_t(chunkSize), size - offset));
+		}
+	}
+	++count;
+	return true;
+}
+
+bool Scrubber::remove(uint32_t address)
+{
+	for(unsigned i = 0; i < count; ++i) {
+		if(assets[i].address != address) {
+			continue;
+		}
+		std::move(&assets[i + 1], &assets[count], &assets[i]);
+		--count;
+		assets[count].crcs.reset();
+		assets[count].reload = nullptr;
+		if(current > i) {
+			--current;
+		} else if(current == i) {
+			chunk = 0;
+		}
+		return true;
+	}
+	return false;
+}
+
+void Scrubber::clear()
+{
+	while(count != 0) {
+		--count;
+		assets[count].crcs.reset();
+		assets[count].reload = nullptr;
+	}
+	current = 0;
+	chunk = 0;
+}
+
+void Scrubber::start(unsigned intervalMs)
+{
+	timer.initializeMs(
+		intervalMs, [](void* param) { static_cast<Scrubber*>(param)->step(); }, this);
+	timer.start();
+}
+
+bool Scrubber::step()
+{
+	if(count == 0) {
+		return false;
+	}
+	// Only use idle time, so frames in progress aren't delayed
+	if((display.read16(REG_CMDB_SPACE) & 0x0ffc) != EVE_CMDFIFO_SIZE - 4) {
+		return false;
+	}
+
+	if(current >= count) {
+		current = 0;
+		chunk = 0;
+	}
+	auto& asset = assets[current];
+	const uint32_t offset = chunk * chunkSize;
+	const uint32_t length = std::min(uint32_t(chunkSize), asset.size - offset);
+	uint32_t crc;
+	if(!memcrc(asset.address + offset, length, crc)) {
+		return false;
+	}
+	checkedBytes += length;
+
+	bool ok{true};
+	if(chunk < asset.known) {
+		ok = (crc == asset.crcs[chunk]);
+	} else {
+		asset.crcs[chunk] = crc;
+		asset.known = chunk + 1;
+	}
+
+	if(ok && ++chunk < getChunkCount(asset)) {
+		return true;
+	}
+
+	if(!ok) {
+		++errorCount;
+		debug_w("[EVE] GRAM error in asset @ 0x%06x, offset 0x%06x", unsigned(asset.address), unsigned(offset));
+		if(asset.reload && asset.reload(asset.address, asset.size)) {
+			++reloadCount;
+			if(asset.learned) {
+				asset.known = 0;
+			}
+		}
+	}
+
+	++current;
+	chunk = 0;
+	return true;
+}
+
+bool Scrubber::memcrc(uint32_t address, uint32_t size, uint32_t& crc)
+{
+	const uint32_t words[]{
+		MAKE_COPROC_CMD_WORD(CMD_MEMCRC),
+		address,
+		size,
+		0,
+	};
+	if(!display.sendCommands(words, ARRAY_SIZE(words))) {
+		return false;
+	}
+	// Result replaces the last parameter
+	auto mark = display.getFifoPosition();
+	if(!display.waitCommandsIdle()) {
+		debug_e("[EVE] Scrubber: timeout waiting for CMD_MEMCRC");
+		return false;
+	}
+	crc = display.readResult(mark);
+	return true;
+}
+
+} // namespace Graphics::EVE
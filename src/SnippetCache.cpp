@@ -0,0 +1,100 @@
+#include "include/Graphics/EVE/SnippetCache.h"
+#include "include/Graphics/EVE/Crc.h"
+
+namespace Graphics::EVE
+{
+uint32_t SnippetCache::getKey(const CommandList& widget)
+{
+	return crc32(widget.data(), widget.size());
+}
+
+SnippetCache::Entry* SnippetCache::find(uint32_t key)
+{
+	for(unsigned i = 0; i < count; ++i) {
+		if(entries[i].key == key) {
+			return &entries[i];
+		}
+	}
+	return nullptr;
+}
+
+void SnippetCache::beginFrame()
+{
+	if(full) {
+		for(unsigned i = 0; i < count; ++i) {
+			if(entries[i].frame != frame) {
+				clear();
+				break;
+			}
+		}
+	}
+	++frame;
+}
+
+bool SnippetCache::append(CommandList& list, uint32_t key)
+{
+	auto entry = find(key);
+	if(entry == nullptr) {
+		return false;
+	}
+	if(!list.addCommand(CMD_APPEND, address + entry->offset, entry->length)) {
+		return false;
+	}
+	entry->frame = frame;
+	return true;
+}
+
+bool SnippetCache::record(EveDisplay& display, uint32_t key, const CommandList& widget)
+{
+	// Entries may already be referenced by the frame being built so can't be evicted here
+	if(full || count >= maxEntries) {
+		full = true;
+		return false;
+	}
+
+	// Generate display list words from the start of RAM_DL
+	const uint32_t start = MAKE_COPROC_CMD_WORD(CMD_DLSTART);
+	if(!display.sendCommands(&start, 1) || !display.sendCommands(widget) || !display.waitCommandsIdle()) {
+		debug_e("[EVE] Snippet: co-processor not responding");
+		return false;
+	}
+	const uint16_t length = display.read16(REG_CMD_DL);
+	if(length == 0 || length > size) {
+		debug_w("[EVE] Snippet: %u bytes, cannot cache", length);
+		return false;
+	}
+
+	if(used + length > size) {
+		full = true;
+		return false;
+	}
+
+	const uint32_t copy[]{
+		MAKE_COPROC_CMD_WORD(CMD_MEMCPY),
+		address + used,
+		EVE_RAM_DL,
+		length,
+	};
+	if(!display.sendCommands(copy, ARRAY_SIZE(copy))) {
+		return false;
+	}
+
+	entries[count++] = Entry{key, used, length, uint16_t(frame - 1)};
+	used += length;
+	return true;
+}
+
+bool SnippetCache::add(EveDisplay& display, CommandList& list, const CommandList& widget)
+{
+	auto key = getKey(widget);
+	if(append(list, key)) {
+		return true;
+	}
+	if(record(display, key, widget) && append(list, key)) {
+		return true;
+	}
+	list.add(widget.data(), widget.length());
+	return false;
+}
+
+} // namespace Graphics::EVE
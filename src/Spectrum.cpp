@@ -0,0 +1,118 @@
+#include "include/Graphics/EVE/Spectrum.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Graphics::EVE
+{
+namespace
+{
+// log2 of full-scale sinewave power in a bin after windowing and scaling, see process()
+constexpr int32_t fullScaleLog2 = 42;
+
+// 10 * log10(2) in Q8
+constexpr int32_t dbPerLog2 = 771;
+
+} // namespace
+
+Spectrum::Spectrum(uint8_t order) : order(std::clamp(order, uint8_t(4), uint8_t(12)))
+{
+	const unsigned n = getSize();
+	sine.reset(new int16_t[n / 2]);
+	window.reset(new int16_t[n / 2]);
+	re.reset(new int32_t[n]);
+	im.reset(new int32_t[n]);
+
+	for(unsigned i = 0; i < n / 2; ++i) {
+		sine[i] = lround(32767.0 * sin(2 * M_PI * i / n));
+		window[i] = lround(32767.0 * 0.5 * (1.0 - cos(2 * M_PI * i / (n - 1))));
+	}
+}
+
+void Spectrum::transform()
+{
+	const unsigned n = getSize();
+
+	auto sinAt = [&](unsigned i) -> int32_t {
+		i &= n - 1;
+		return (i < n / 2) ? sine[i] : -sine[i - n / 2];
+	};
+
+	// Bit-reversal permutation
+	for(unsigned i = 1, j = 0; i < n; ++i) {
+		unsigned bit = n >> 1;
+		for(; j & bit; bit >>= 1) {
+			j ^= bit;
+		}
+		j ^= bit;
+		if(i < j) {
+			std::swap(re[i], re[j]);
+			std::swap(im[i], im[j]);
+		}
+	}
+
+	// Butterflies, halving at each stage to avoid overflow: overall result is scaled by 1/n
+	for(unsigned size = 2; size <= n; size <<= 1) {
+		const unsigned half = size / 2;
+		const unsigned step = n / size;
+		for(unsigned start = 0; start < n; start += size) {
+			for(unsigned k = 0; k < half; ++k) {
+				const unsigned j = k * step;
+				const int32_t wr = sinAt(j + n / 4);
+				const int32_t wi = -sinAt(j);
+				const unsigned a = start + k;
+				const unsigned b = a + half;
+				const int32_t tr = (int64_t(re[b]) * wr - int64_t(im[b]) * wi) >> 15;
+				const int32_t ti = (int64_t(re[b]) * wi + int64_t(im[b]) * wr) >> 15;
+				re[b] = (re[a] - tr) >> 1;
+				im[b] = (im[a] - ti) >> 1;
+				re[a] = (re[a] + tr) >> 1;
+				im[a] = (im[a] + ti) >> 1;
+			}
+		}
+	}
+}
+
+int32_t Spectrum::logPower(unsigned bin) const
+{
+	const uint64_t power = uint64_t(int64_t(re[bin]) * re[bin]) + uint64_t(int64_t(im[bin]) * im[bin]);
+	if(power == 0) {
+		return INT32_MIN / 2;
+	}
+
+	// log2 in Q8, using linear interpolation for fractional part (error < 0.1)
+	const int msb = 63 - __builtin_clzll(power);
+	const uint32_t frac = (msb >= 8) ? (power >> (msb - 8)) & 0xff : (power << (8 - msb)) & 0xff;
+	const int32_t log2 = (msb - fullScaleLog2) * 256 + int32_t(frac);
+
+	return (log2 * dbPerLog2) >> 8;
+}
+
+void Spectrum::process(const int16_t* samples, uint8_t* row, unsigned width)
+{
+	const unsigned n = getSize();
+
+	// Apply window, scaling input up by 2^8 to retain precision through the transform
+	for(unsigned i = 0; i < n; ++i) {
+		const int32_t w = (i < n / 2) ? window[i] : window[n - 1 - i];
+		re[i] = (int32_t(samples[i]) * w) >> 7;
+		im[i] = 0;
+	}
+
+	transform();
+
+	const unsigned binCount = n / 2;
+	const int32_t floor = floorDb * 256;
+	const int32_t range = rangeDb * 256;
+	for(unsigned x = 0; x < width; ++x) {
+		const unsigned firstBin = x * binCount / width;
+		const unsigned lastBin = std::max(firstBin + 1, (x + 1) * binCount / width);
+		int32_t peak = INT32_MIN;
+		for(unsigned bin = firstBin; bin < lastBin; ++bin) {
+			peak = std::max(peak, logPower(bin));
+		}
+		const int32_t value = int64_t(peak - floor) * 255 / range;
+		row[x] = std::clamp(value, int32_t(0), int32_t(255));
+	}
+}
+
+} // namespace Graphics::EVE
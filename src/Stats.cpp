@@ -0,0 +1,71 @@
+#include "include/Graphics/EVE/Stats.h"
+#include <Clock.h>
+
+namespace Graphics::EVE
+{
+void Stats::reset()
+{
+	*this = Stats{};
+	startTime = millis();
+}
+
+uint32_t Stats::getElapsed() const
+{
+	return millis() - startTime;
+}
+
+uint32_t Stats::perSecond(uint32_t count) const
+{
+	auto elapsed = getElapsed();
+	return elapsed ? uint64_t(count) * 1000 / elapsed : 0;
+}
+
+size_t Stats::printTo(Print& p) const
+{
+	size_t n{0};
+	char sep{'{'};
+
+	auto field = [&](const char* name, uint64_t value) {
+		n += p.print(sep);
+		n += p.print('"');
+		n += p.print(name);
+		n += p.print("\":");
+		n += p.print(value);
+		sep = ',';
+	};
+
+	auto transfer = [&](const char* name, const Transfer& t) {
+		n += p.print(sep);
+		n += p.print('"');
+		n += p.print(name);
+		n += p.print("\":");
+		sep = '{';
+		field("transactions", t.transactions);
+		field("bytes", t.bytes);
+		field("transactions_per_sec", perSecond(t.transactions));
+		field("bytes_per_sec", perSecond(t.bytes));
+		n += p.print('}');
+	};
+
+	field("elapsed_ms", getElapsed());
+	transfer("spi", spi);
+	transfer("dual", dual);
+	transfer("quad", quad);
+	field("fifo_stalls", fifoStalls);
+	field("fifo_stall_time", fifoStallTime);
+	field("poll_reads", pollReads);
+	field("cmd_high_water", cmdHighWater);
+	field("dl_high_water", dlHighWater);
+	field("copro_busy_time", coproBusyTime);
+	field("frames", frames);
+	field("missed_frames", missedFrames);
+	field("direct_lists", directLists);
+	field("elided_writes", elidedWrites);
+	field("cached_reads", cachedReads);
+	field("copro_faults", coproFaults);
+	n += p.print('}');
+
+	return n;
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,116 @@
+#include "include/Graphics/EVE/Touch.h"
+#include <Clock.h>
+
+namespace Graphics::EVE
+{
+namespace
+{
+// Touch point registers, relative to REG_CTOUCH_TOUCH1_XY, in touch index order
+constexpr uint8_t xyIndex[]{
+	(REG_CTOUCH_TOUCH_XY - REG_CTOUCH_TOUCH1_XY) / 4,
+	(REG_CTOUCH_TOUCH1_XY - REG_CTOUCH_TOUCH1_XY) / 4,
+	(REG_CTOUCH_TOUCH2_XY - REG_CTOUCH_TOUCH1_XY) / 4,
+	(REG_CTOUCH_TOUCH3_XY - REG_CTOUCH_TOUCH1_XY) / 4,
+};
+constexpr uint8_t touch4XIndex{(REG_CTOUCH_TOUCH4_X - REG_CTOUCH_TOUCH1_XY) / 4};
+constexpr uint8_t touch4YIndex{(REG_CTOUCH_TOUCH4_Y - REG_CTOUCH_TOUCH1_XY) / 4};
+constexpr uint8_t tagIndex[]{
+	(REG_TOUCH_TAG - REG_CTOUCH_TOUCH1_XY) / 4,	(REG_TOUCH_TAG1 - REG_CTOUCH_TOUCH1_XY) / 4,
+	(REG_TOUCH_TAG2 - REG_CTOUCH_TOUCH1_XY) / 4, (REG_TOUCH_TAG3 - REG_CTOUCH_TOUCH1_XY) / 4,
+	(REG_TOUCH_TAG4 - REG_CTOUCH_TOUCH1_XY) / 4,
+};
+
+// Coordinate value indicating no touch
+constexpr uint16_t noTouch{0x8000};
+
+} // namespace
+
+void Touch::begin(EveDisplay& display, uint16_t interval)
+{
+	this->display = &display;
+	// 0 selects extended mode: up to 5 touch points
+	display.write8(REG_CTOUCH_EXTENDED, 0);
+	timer.initializeMs(interval, [](void* param) { static_cast<Touch*>(param)->startRead(); }, this);
+	display.enableInterrupts(EVE_INT_TOUCH);
+}
+
+void Touch::end()
+{
+	if(display == nullptr) {
+		return;
+	}
+	timer.stop();
+	display->disableInterrupts(EVE_INT_TOUCH);
+	display->wait(request);
+	display = nullptr;
+	sampling = false;
+}
+
+void Touch::handleInterrupt(uint8_t flags)
+{
+	if(display == nullptr || !(flags & EVE_INT_TOUCH) || sampling) {
+		return;
+	}
+	sampling = true;
+	startRead();
+}
+
+void Touch::startRead()
+{
+	display->read(request, firstRegister, registers, sizeof(registers), readComplete, this);
+}
+
+bool Touch::readComplete(HSPI::Request& request)
+{
+	// May be in interrupt context
+	static_cast<Touch*>(request.param)->task.queue();
+	return true;
+}
+
+void Touch::decode(TouchSnapshot& snapshot) const
+{
+	snapshot.timestamp = micros();
+	snapshot.count = 0;
+
+	auto setPoint = [&](unsigned i, uint16_t x, uint16_t y) {
+		auto& pt = snapshot.points[i];
+		pt.down = (x != noTouch) && (y != noTouch);
+		pt.x = pt.down ? int16_t(x) : 0;
+		pt.y = pt.down ? int16_t(y) : 0;
+		pt.tag = pt.down ? registers[tagIndex[i]] : 0;
+		snapshot.count += pt.down;
+	};
+
+	for(unsigned i = 0; i < ARRAY_SIZE(xyIndex); ++i) {
+		auto xy = registers[xyIndex[i]];
+		setPoint(i, xy >> 16, xy);
+	}
+	setPoint(4, registers[touch4XIndex], registers[touch4YIndex]);
+}
+
+void Touch::read(TouchSnapshot& snapshot)
+{
+	display->read(firstRegister, registers, sizeof(registers));
+	decode(snapshot);
+}
+
+void Touch::process()
+{
+	if(display == nullptr) {
+		return;
+	}
+
+	decode(snapshot);
+	gestures.update(snapshot);
+	if(snapshotCallback) {
+		snapshotCallback(snapshot);
+	}
+
+	// Keep sampling until all points released
+	sampling = snapshot.isDown();
+	if(sampling) {
+		timer.startOnce();
+	}
+}
+
+} // namespace Graphics::EVE
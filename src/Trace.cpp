@@ -0,0 +1,263 @@
+#include "include/Graphics/EVE/Trace.h"
+#include "include/Graphics/EVE/Crc.h"
+#include <Clock.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+using namespace Trace;
+
+namespace
+{
+constexpr char magic[]{'E', 'V', 'T', 'R'};
+
+// Longest time spent replaying records in one timer callback, in microseconds
+constexpr uint32_t maxBatchTime{10000};
+
+} // namespace
+
+void TraceRecorder::writeBytes(const void* data, size_t length)
+{
+	size += output.write(static_cast<const uint8_t*>(data), length);
+}
+
+void TraceRecorder::writeVarint(uint32_t value)
+{
+	uint8_t buf[5];
+	unsigned len{0};
+	do {
+		buf[len] = value & 0x7f;
+		value >>= 7;
+		if(value != 0) {
+			buf[len] |= 0x80;
+		}
+		++len;
+	} while(value != 0);
+	writeBytes(buf, len);
+}
+
+void TraceRecorder::record(const HSPI::Request& req, uint32_t startTime)
+{
+	if(count == 0) {
+		const uint8_t header[]{magic[0], magic[1], magic[2], magic[3], version, uint8_t(mode), 0, 0};
+		writeBytes(header, sizeof(header));
+		lastTime = startTime;
+	}
+	++count;
+
+	const uint32_t duration = req.async ? 0 : micros() - startTime;
+
+	Kind kind;
+	const HSPI::Data* data{nullptr};
+	if(req.addr.bitCount == 0) {
+		kind = Kind::host;
+	} else if(req.addr.value & 0x800000) {
+		kind = Kind::write;
+		data = &req.out;
+	} else {
+		kind = Kind::read;
+		data = req.async ? nullptr : &req.in;
+	}
+
+	uint8_t flags = uint8_t(kind);
+	if(req.async) {
+		flags |= flagAsync;
+	}
+	if(data != nullptr) {
+		flags |= (mode == Mode::payload) ? flagPayload : flagHash;
+	}
+	writeBytes(&flags, 1);
+	writeVarint(startTime - lastTime);
+	writeVarint(duration);
+	lastTime = startTime;
+
+	if(kind == Kind::host) {
+		const uint8_t cmd[]{uint8_t(req.cmd.value), req.out.data[0]};
+		writeBytes(cmd, sizeof(cmd));
+		return;
+	}
+
+	const uint32_t address = req.addr.value & 0x3fffff;
+	const uint8_t addr[]{uint8_t(address), uint8_t(address >> 8), uint8_t(address >> 16)};
+	writeBytes(addr, sizeof(addr));
+	const uint16_t length = (kind == Kind::write) ? req.out.length : req.in.length;
+	writeVarint(length);
+	if(flags & flagPayload) {
+		writeBytes(data->get(), length);
+	} else if(flags & flagHash) {
+		const uint32_t crc = crc32(data->get(), length);
+		writeBytes(&crc, sizeof(crc));
+	}
+}
+
+bool TraceReplay::read(void* buffer, size_t length)
+{
+	return input->readBytes(static_cast<char*>(buffer), length) == length;
+}
+
+bool TraceReplay::readVarint(uint32_t& value)
+{
+	value = 0;
+	for(unsigned shift = 0; shift < 35; shift += 7) {
+		uint8_t c;
+		if(!read(&c, 1)) {
+			return false;
+		}
+		value |= uint32_t(c & 0x7f) << shift;
+		if(!(c & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TraceReplay::begin(IDataStream& input, const Options& options, Callback callback)
+{
+	if(isBusy()) {
+		debug_e("[EVE] Trace replay already in progress");
+		return false;
+	}
+
+	this->input = &input;
+	uint8_t header[8];
+	if(!read(header, sizeof(header)) || memcmp(header, magic, sizeof(magic)) != 0 || header[4] != version) {
+		debug_e("[EVE] Invalid trace header");
+		this->input = nullptr;
+		return false;
+	}
+	if(Mode(header[5]) != Mode::payload) {
+		debug_w("[EVE] Trace has no write payloads, only reads will be replayed");
+	}
+
+	this->options = options;
+	this->callback = callback;
+	result = Result{};
+	recordTime = 0;
+	recordPending = false;
+	startTime = micros();
+	schedule(0);
+	return true;
+}
+
+void TraceReplay::schedule(uint32_t delayMs)
+{
+	timer.initializeMs(
+		std::max(delayMs, 1U), [](void* param) { static_cast<TraceReplay*>(param)->process(); }, this);
+	timer.startOnce();
+}
+
+void TraceReplay::process()
+{
+	const uint32_t batchStart = micros();
+	while(micros() - batchStart < maxBatchTime) {
+		if(!recordPending) {
+			uint32_t delta;
+			uint32_t duration;
+			if(!read(&recordFlags, 1)) {
+				complete(true);
+				return;
+			}
+			if(!readVarint(delta) || !readVarint(duration)) {
+				complete(false);
+				return;
+			}
+			recordTime += delta;
+			result.recordedTime = recordTime + duration;
+			recordPending = true;
+		}
+
+		if(options.realTime) {
+			int32_t remaining = recordTime - (micros() - startTime);
+			if(remaining >= 1000) {
+				schedule(remaining / 1000);
+				return;
+			}
+			// Short gaps aren't worth a timer
+			while(int32_t(recordTime - (micros() - startTime)) > 0) {
+			}
+		}
+
+		recordPending = false;
+		if(!replay(recordFlags)) {
+			complete(false);
+			return;
+		}
+	}
+	schedule(0);
+}
+
+bool TraceReplay::replay(uint8_t flags)
+{
+	const auto kind = Kind(flags & 0x03);
+	if(kind == Kind::host) {
+		uint8_t cmd[2];
+		if(!read(cmd, sizeof(cmd))) {
+			return false;
+		}
+		HSPI::Request req;
+		req.setCommand8(cmd[0]);
+		req.out.set16(cmd[1]);
+		display.execute(req);
+		++result.records;
+		return true;
+	}
+
+	uint8_t addr[3];
+	uint32_t length;
+	if(!read(addr, sizeof(addr)) || !readVarint(length) || length > 0xffff) {
+		return false;
+	}
+	const uint32_t address = addr[0] | (addr[1] << 8) | (addr[2] << 16);
+	std::unique_ptr<uint8_t[]> payload;
+	if(flags & flagPayload) {
+		payload.reset(new uint8_t[length]);
+		if(!read(payload.get(), length)) {
+			return false;
+		}
+	}
+	uint32_t crc{0};
+	if((flags & flagHash) && !read(&crc, sizeof(crc))) {
+		return false;
+	}
+	++result.records;
+
+	if(kind == Kind::write) {
+		if(!payload) {
+			++result.skipped;
+		} else if(address == REG_SPI_WIDTH && length == 1) {
+			// Switch the bus too, or subsequent transfers will be garbled
+			const HSPI::IoMode modes[]{HSPI::IoMode::SPIHD, HSPI::IoMode::SDI, HSPI::IoMode::SQI};
+			display.setIoMode(modes[std::min(payload[0] & 0x03, 2)]);
+		} else {
+			display.write(address, payload.get(), length);
+		}
+		return true;
+	}
+
+	std::unique_ptr<uint8_t[]> buffer(new uint8_t[length]);
+	display.read(address, buffer.get(), length);
+	if(options.verifyReads) {
+		bool match{true};
+		if(payload) {
+			match = memcmp(payload.get(), buffer.get(), length) == 0;
+		} else if(flags & flagHash) {
+			match = crc32(buffer.get(), length) == crc;
+		}
+		if(!match) {
+			++result.mismatches;
+		}
+	}
+	return true;
+}
+
+void TraceReplay::complete(bool success)
+{
+	timer.stop();
+	input = nullptr;
+	result.elapsed = micros() - startTime;
+	if(callback) {
+		callback(success);
+	}
+}
+
+} // namespace Graphics::EVE
@@ -0,0 +1,143 @@
+#include "include/Graphics/EVE/Tracker.h"
+
+namespace Graphics::EVE
+{
+void Tracker::begin(EveDisplay& display, uint16_t interval)
+{
+	this->display = &display;
+	timer.initializeMs(interval, [](void* param) { static_cast<Tracker*>(param)->startRead(); }, this);
+	display.enableInterrupts(EVE_INT_TOUCH | EVE_INT_TAG);
+}
+
+void Tracker::end()
+{
+	if(display == nullptr) {
+		return;
+	}
+	timer.stop();
+	display->wait(request);
+	display = nullptr;
+	sampling = false;
+}
+
+bool Tracker::add(const Control& control)
+{
+	if(control.tag == 0) {
+		return false;
+	}
+	auto ctrl = find(control.tag);
+	if(ctrl == nullptr) {
+		if(controlCount >= maxControls) {
+			debug_e("[EVE] Too many tracked controls");
+			return false;
+		}
+		ctrl = &controls[controlCount++];
+	}
+	*ctrl = control;
+	return true;
+}
+
+bool Tracker::addLinear(uint8_t tag, int16_t x, int16_t y, uint16_t width, uint16_t height, int32_t min,
+						int32_t max, Callback callback)
+{
+	// A 1x1 area selects rotary tracking
+	if(width <= 1 && height <= 1) {
+		return false;
+	}
+	return add(Control{callback, min, max, x, y, width, height, -1, tag});
+}
+
+bool Tracker::addRotary(uint8_t tag, int16_t x, int16_t y, int32_t min, int32_t max, Callback callback)
+{
+	return add(Control{callback, min, max, x, y, 1, 1, -1, tag});
+}
+
+bool Tracker::remove(uint8_t tag)
+{
+	auto ctrl = find(tag);
+	if(ctrl == nullptr) {
+		return false;
+	}
+	*ctrl = controls[--controlCount];
+	return true;
+}
+
+Tracker::Control* Tracker::find(uint8_t tag)
+{
+	for(unsigned i = 0; i < controlCount; ++i) {
+		if(controls[i].tag == tag) {
+			return &controls[i];
+		}
+	}
+	return nullptr;
+}
+
+bool Tracker::track(CommandList& list) const
+{
+	if(list.available() < controlCount * 4U) {
+		return false;
+	}
+	for(unsigned i = 0; i < controlCount; ++i) {
+		auto& ctrl = controls[i];
+		list.addCommand(CMD_TRACK, MAKE_COPROC_PARAM16(ctrl.x, ctrl.y), MAKE_COPROC_PARAM16(ctrl.width, ctrl.height),
+						ctrl.tag);
+	}
+	return true;
+}
+
+void Tracker::handleInterrupt(uint8_t flags)
+{
+	if(display == nullptr || !(flags & (EVE_INT_TOUCH | EVE_INT_TAG)) || sampling || controlCount == 0) {
+		return;
+	}
+	sampling = true;
+	startRead();
+}
+
+void Tracker::startRead()
+{
+	display->read(request, REG_TRACKER, registers, sizeof(registers), readComplete, this);
+}
+
+bool Tracker::readComplete(HSPI::Request& request)
+{
+	// May be in interrupt context
+	static_cast<Tracker*>(request.param)->task.queue();
+	return true;
+}
+
+void Tracker::process()
+{
+	if(display == nullptr) {
+		return;
+	}
+
+	// Each register has value in upper 16 bits and tag in lower 8 bits, tag 0 means inactive
+	bool active{false};
+	for(auto reg : registers) {
+		const uint8_t tag = reg;
+		if(tag == 0) {
+			continue;
+		}
+		active = true;
+		auto ctrl = find(tag);
+		if(ctrl == nullptr) {
+			continue;
+		}
+		const uint16_t value = reg >> 16;
+		if(value == ctrl->lastValue) {
+			continue;
+		}
+		ctrl->lastValue = value;
+		if(ctrl->callback) {
+			ctrl->callback(tag, int32_t(ctrl->min + (int64_t(ctrl->max) - ctrl->min) * value / 0xffff));
+		}
+	}
+
+	sampling = active;
+	if(sampling) {
+		timer.startOnce();
+	}
+}
+
+} // namespace Graphics::EVE
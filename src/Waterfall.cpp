@@ -0,0 +1,106 @@
+#include "include/Graphics/EVE/Waterfall.h"
+
+namespace Graphics::EVE
+{
+Waterfall::Waterfall(const Config& config) : config(config), rowBuffer(new uint8_t[config.width * 2])
+{
+}
+
+void Waterfall::writePalette(EveDisplay& display, const uint32_t* palette)
+{
+	display.blockWrite(config.paletteAddress, palette, 256);
+}
+
+void Waterfall::clear(EveDisplay& display, uint8_t value)
+{
+	// Use current row buffer as source, one transfer per row
+	auto buf = getRowBuffer();
+	memset(buf, value, config.width);
+	for(unsigned row = 0; row < config.rows; ++row) {
+		display.write(config.address + row * config.width, buf, config.width);
+	}
+	head = 0;
+}
+
+void Waterfall::pushRow(EveDisplay& display)
+{
+	// Previous row must be written before its request and buffer can be re-used
+	display.wait(request);
+	head = (head == 0) ? config.rows - 1 : head - 1;
+	display.write(request, config.address + uint32_t(head) * config.width, getRowBuffer(), config.width);
+	current ^= 1;
+}
+
+void Waterfall::addSegments(CommandList& list) const
+{
+	// Rows [head, rows) are drawn at top, [0, head) below them
+	const uint16_t topRows = config.rows - head;
+	const uint32_t top[]{
+		SCISSOR_XY(config.x, config.y),
+		SCISSOR_SIZE(config.width, topRows),
+		BITMAP_SOURCE(config.address + uint32_t(head) * config.width),
+		VERTEX2F(config.x, config.y),
+	};
+	list.add(top);
+
+	if(head == 0) {
+		return;
+	}
+
+	const uint32_t bottom[]{
+		SCISSOR_XY(config.x, config.y + topRows),
+		SCISSOR_SIZE(config.width, head),
+		BITMAP_SOURCE(config.address),
+		VERTEX2F(config.x, config.y + topRows),
+	};
+	list.add(bottom);
+}
+
+bool Waterfall::draw(CommandList& list) const
+{
+	const unsigned segmentWords = (head == 0) ? 4 : 8;
+	const unsigned wordCount = (config.format == Format::L8) ? 11 + segmentWords : 20 + 4 * segmentWords;
+	if(list.available() < wordCount) {
+		return false;
+	}
+
+	const auto format = (config.format == Format::L8) ? BMF_L8 : BMF_PALETTED8;
+	const uint32_t setup[]{
+		SAVE_CONTEXT(),
+		VERTEX_FORMAT(0),
+		BITMAP_HANDLE(config.handle),
+		BITMAP_LAYOUT(format, config.width, config.rows),
+		BITMAP_LAYOUT_H(config.width, config.rows),
+		BITMAP_SIZE(BitmapFilter::NEAREST, BitmapWrap::BORDER, BitmapWrap::BORDER, config.width, config.rows),
+		BITMAP_SIZE_H(config.width, config.rows),
+		BEGIN(GP_BITMAPS),
+	};
+	list.add(setup);
+
+	if(config.format == Format::L8) {
+		list.add(COLOR_RGB(config.color >> 16, config.color >> 8, config.color));
+		addSegments(list);
+	} else {
+		// Palette entries are stored B, G, R, A: alpha pass first, then blend in each colour channel
+		list.add(BLEND_FUNC(BlendFunction::ONE, BlendFunction::ZERO));
+		list.add(COLOR_MASK(false, false, false, true));
+		list.add(PALETTE_SOURCE(config.paletteAddress + 3));
+		addSegments(list);
+		list.add(BLEND_FUNC(BlendFunction::DST_ALPHA, BlendFunction::ONE_MINUS_DST_ALPHA));
+		list.add(COLOR_MASK(true, false, false, false));
+		list.add(PALETTE_SOURCE(config.paletteAddress + 2));
+		addSegments(list);
+		list.add(COLOR_MASK(false, true, false, false));
+		list.add(PALETTE_SOURCE(config.paletteAddress + 1));
+		addSegments(list);
+		list.add(COLOR_MASK(false, false, true, false));
+		list.add(PALETTE_SOURCE(config.paletteAddress));
+		addSegments(list);
+	}
+
+	list.add(END());
+	list.add(RESTORE_CONTEXT());
+	return true;
+}
+
+} // namespace Graphics::EVE
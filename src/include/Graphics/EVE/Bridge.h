@@ -0,0 +1,155 @@
+#pragma once
+
+#include "Display.h"
+#include "DeferredTask.h"
+#include <Delegate.h>
+#include <memory>
+#include <algorithm>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Remote access protocol used by `tools/test.py` and `tools/bridge.py`
+ *
+ * All frames are binary and start with a little-endian 32-bit magic value.
+ *
+ * Legacy frames, one round trip each:
+ *
+ * - write: magic, address, length, data. Reply is the text "OK" or an error message.
+ * - read: magic, address, length. Reply is the data.
+ *
+ * Pipelined frames carry a sequence number, incremented by the client for each frame:
+ *
+ * - hello: magic. Reply: magic, version, window, maxPayload.
+ * - seqWrite: magic, seq, address, length, data. No immediate reply.
+ * - seqRead: magic, seq, address, length. Reply: data magic, seq, status, data.
+ * - ack (reply only): magic, seq, status. With status ok, all frames up to and including seq
+ *   are complete. Otherwise frame seq failed.
+ *
+ * The client may have up to `window` writes outstanding, each of at most `maxPayload` bytes,
+ * as reported by hello. Frames are executed in order, so a read always observes the effect
+ * of preceding writes.
+ */
+namespace BridgeProtocol
+{
+constexpr uint32_t magicWrite{0xA7B8FE30};
+constexpr uint32_t magicRead{0xA7B8FE31};
+constexpr uint32_t magicHello{0xA7B8FE32};
+constexpr uint32_t magicSeqWrite{0xA7B8FE33};
+constexpr uint32_t magicSeqRead{0xA7B8FE34};
+constexpr uint32_t magicAck{0xA7B8FE35};
+constexpr uint32_t magicData{0xA7B8FE36};
+
+constexpr uint32_t version{1};
+constexpr uint16_t defaultWindow{4};
+constexpr uint16_t defaultMaxPayload{8192};
+
+enum class Status : uint32_t {
+	ok = 0,
+	badFrame = 1,	///< Unrecognised or malformed frame
+	badAddress = 2,  ///< Address range outside device memory, or unaligned FIFO write
+	fifoTimeout = 3, ///< Co-processor stopped accepting commands
+};
+
+} // namespace BridgeProtocol
+
+/**
+ * @brief Executes remote read/write frames against a display
+ *
+ * The bridge is independent of transport: frames are passed to `handleFrame()` and replies go
+ * to the delegate given on construction. With the Sming HTTP server, for example:
+ *
+ * 	wsResource->setConnectionHandler([](WebsocketConnection& conn) { bridge.reset(); });
+ * 	wsResource->setBinaryHandler([](WebsocketConnection& conn, uint8_t* data, size_t size) {
+ * 		bridge.handleFrame(data, size);
+ * 	});
+ *
+ * with the bridge constructed as:
+ *
+ * 	EVE::Bridge bridge(display, [](const void* data, size_t length, bool binary) {
+ * 		// Send to current connection as binary or text frame
+ * 	});
+ *
+ * Pipelined writes are copied into one of `window` slots and started as asynchronous DMA
+ * transfers so the next frame can be received whilst the previous one is sent to the display.
+ * Buffers take `(window + 1) * maxPayload` bytes and are allocated on the first frame, so
+ * reduce these on devices with little RAM.
+ * Writes to REG_CMDB_WRITE go through `EveDisplay::sendCommands()`, which paces them against
+ * FIFO space. Acknowledgements are coalesced: one is sent for all writes completed since the last.
+ */
+class Bridge
+{
+public:
+	using SendDelegate = Delegate<void(const void* data, size_t length, bool binary)>;
+
+	/**
+	 * @brief Create a bridge
+	 * @param display
+	 * @param send Delegate to transmit replies
+	 * @param window Number of pipelined writes which may be outstanding
+	 * @param maxPayload Largest read or write, multiple of 4
+	 */
+	Bridge(EveDisplay& display, SendDelegate send, uint8_t window = BridgeProtocol::defaultWindow,
+		   uint16_t maxPayload = BridgeProtocol::defaultMaxPayload)
+		: display(display), send(send), task(retireTask, this), window(std::max(window, uint8_t(1))),
+		  maxPayload(maxPayload & ~3U)
+	{
+	}
+
+	~Bridge();
+
+	/**
+	 * @brief Process one received frame
+	 */
+	void handleFrame(const uint8_t* data, size_t length);
+
+	/**
+	 * @brief Complete outstanding writes and restart sequence tracking, e.g. on new connection
+	 */
+	void reset();
+
+private:
+	using Status = BridgeProtocol::Status;
+
+	struct Slot {
+		HSPI::Request request;
+		uint32_t* data;
+		uint32_t seq;
+		bool pending;
+	};
+
+	void hello();
+	void seqWrite(uint32_t seq, uint32_t address, const uint8_t* data, size_t length);
+	void read(uint32_t magic, uint32_t seq, uint32_t address, uint32_t length);
+	void legacyWrite(uint32_t address, const uint8_t* data, size_t length);
+	Status checkRange(uint32_t address, size_t length) const;
+	bool writeCommands(const uint8_t* data, size_t length);
+	static bool writeComplete(HSPI::Request& request);
+	static void retireTask(void* param)
+	{
+		static_cast<Bridge*>(param)->retire();
+	}
+	void retire();
+	void drain();
+	void sendAck(uint32_t seq, Status status);
+	void sendWords(const uint32_t* words, unsigned count)
+	{
+		send(words, count * sizeof(uint32_t), true);
+	}
+
+	EveDisplay& display;
+	SendDelegate send;
+	DeferredTask task;
+	std::unique_ptr<Slot[]> slots;
+	std::unique_ptr<uint32_t[]> buffer; ///< Slot data followed by read buffer
+	uint32_t* readBuffer{nullptr};
+	unsigned head{0};
+	unsigned tail{0};
+	unsigned inFlight{0};
+	uint32_t completedSeq{0};
+	uint8_t window;
+	uint16_t maxPayload;
+	bool ackDue{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "Display.h"
+#include "DeferredTask.h"
+#include <Delegate.h>
+#include <SimpleTimer.h>
+#include <Print.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Share one SPI bus fairly between several displays
+ *
+ * Each EveDisplay on the bus has its own chip select, but the controller executes requests in
+ * the order they're queued, so a large asset upload to one display delays frames for the others.
+ *
+ * The scheduler splits frames and uploads into chunks of at most `chunkSize` bytes and keeps one
+ * chunk in flight at a time. After each chunk the pending job with the earliest deadline goes next.
+ * Frames take the deadline of their display's next frame slot, so they overtake uploads whose
+ * deadlines are further away. An upload whose deadline is near still gets its turn, so it isn't
+ * starved either. A frame therefore waits for at most one chunk of another transfer.
+ *
+ * Frame command lists are written to REG_CMDB_WRITE as FIFO space allows. Each display has at
+ * most one frame in progress; use `isFrameDue()` to pace frame generation. Chunks may split
+ * a command and are sized from a prior read of REG_CMDB_SPACE, so from that first read until
+ * the last chunk the display's FIFO is locked with `EveDisplay::lockCommands()` and
+ * `sendCommands()` calls to it fail.
+ *
+ * Data passed to the scheduler must remain valid until the job's callback is invoked.
+ * Synchronous register and memory access is unaffected and is executed between chunks.
+ */
+class BusScheduler
+{
+public:
+	static constexpr unsigned maxDevices{4};
+
+	using Callback = Delegate<void(bool success)>;
+
+	struct DeviceStats {
+		uint32_t frames;	 ///< Frames sent
+		uint32_t lateFrames; ///< Frames completed after their deadline
+		uint32_t uploads;	///< Uploads completed
+		uint32_t chunks;	 ///< Transfers issued
+		uint32_t bytes;		 ///< Bytes sent by the scheduler
+	};
+
+	/**
+	 * @brief Create a scheduler
+	 * @param maxJobs Number of frames and uploads which may be pending across all displays
+	 * @param chunkSize Maximum bytes per transfer, multiple of 4
+	 */
+	BusScheduler(uint8_t maxJobs = 16, uint16_t chunkSize = 2048)
+		: jobs(new Job[maxJobs]{}), maxJobs(maxJobs), chunkSize(chunkSize)
+	{
+	}
+
+	~BusScheduler();
+
+	/**
+	 * @brief Add a display
+	 * @param display
+	 * @param frameRate Target frames per second
+	 * @retval bool false if too many displays are attached or `chunkSize` is invalid
+	 */
+	bool attach(EveDisplay& display, uint8_t frameRate = 60);
+
+	/**
+	 * @brief Remove a display, abandoning its pending jobs
+	 */
+	void detach(EveDisplay& display);
+
+	/**
+	 * @brief Check whether a display is ready for its next frame
+	 * @retval bool true if no frame is in progress and the display's frame slot has started
+	 */
+	bool isFrameDue(EveDisplay& display);
+
+	/**
+	 * @brief Queue a frame for a display
+	 * @param display
+	 * @param list Co-processor commands, typically ending with DISPLAY and CMD_SWAP
+	 * @param callback Invoked once all commands have been written to the FIFO
+	 * @retval bool false if a frame is already in progress or the job table is full
+	 */
+	bool sendFrame(EveDisplay& display, const CommandList& list, Callback callback = nullptr);
+
+	/**
+	 * @brief Queue data for writing to display memory
+	 * @param display
+	 * @param address Destination, usually in RAM_G
+	 * @param data
+	 * @param length Number of bytes
+	 * @param callback Invoked on completion
+	 * @param deadlineMs Time allowed for the upload to complete
+	 * @retval bool false if the job table is full
+	 */
+	bool upload(EveDisplay& display, uint32_t address, const void* data, size_t length, Callback callback = nullptr,
+				unsigned deadlineMs = 1000);
+
+	/**
+	 * @brief Get scheduler counters for a display
+	 */
+	const DeviceStats* getStats(EveDisplay& display)
+	{
+		auto dev = findDevice(display);
+		return dev ? &dev->stats : nullptr;
+	}
+
+	/**
+	 * @brief Get combined bus usage, including synchronous transfers, across all attached displays
+	 */
+	Stats::Transfer getTotal() const;
+
+	/**
+	 * @brief Write combined bus usage and per-display counters as a JSON object
+	 */
+	size_t printTo(Print& p) const;
+
+private:
+	enum class Kind : uint8_t {
+		none,
+		frame,
+		upload,
+	};
+
+	enum class State : uint8_t {
+		idle,
+		space,	///< Reading REG_CMDB_SPACE
+		writing, ///< Chunk in flight
+	};
+
+	struct Device {
+		EveDisplay* display;
+		uint32_t period;	///< Frame period in microseconds
+		uint32_t nextFrame; ///< Deadline for the next frame
+		DeviceStats stats;
+		bool framePending;
+	};
+
+	struct Job {
+		Device* device;
+		const uint8_t* data;
+		uint32_t address;
+		uint32_t length;
+		uint32_t offset;
+		uint32_t deadline;
+		Callback callback;
+		Kind kind;
+		bool blocked; ///< Waiting for FIFO space
+	};
+
+	Device* findDevice(EveDisplay& display);
+	Job* addJob(Device& device, Kind kind, const void* data, size_t length, uint32_t deadline, Callback callback);
+	Job* select();
+	void schedule();
+	void writeChunk(uint16_t maxLength);
+	static bool requestComplete(HSPI::Request& request);
+	void process();
+	void finish(Job& job, bool success);
+
+	Device devices[maxDevices]{};
+	std::unique_ptr<Job[]> jobs;
+	HSPI::Request request;
+	SimpleTimer timer;
+	DeferredTask task{[](void* param) { static_cast<BusScheduler*>(param)->process(); }, this};
+	Job* current{nullptr};
+	uint8_t maxJobs;
+	uint16_t chunkSize;
+	uint16_t space{0};	 ///< REG_CMDB_SPACE
+	uint16_t lastChunk{0}; ///< Size of chunk in flight
+	State state{State::idle};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Display.h"
+#include <Delegate.h>
+#include <SimpleTimer.h>
+#include <Storage/Partition.h>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Resistive touch calibration stored in flash
+ *
+ * CMD_CALIBRATE needs the user to tap three dots, so it should only be run once per device.
+ * The resulting REG_TOUCH_TRANSFORM_A..F values are read with one burst and stored in a partition
+ * together with the display size and a CRC32. At boot `begin()` writes them back with one burst
+ * and calibration is only run if no valid record is found, or the display size has changed.
+ *
+ * Calibration runs asynchronously: the co-processor is polled from a timer until the user has
+ * finished, so the system watchdog is not starved.
+ *
+ * Call `begin()` immediately after `EveDisplay::begin()`, before any other commands are sent.
+ */
+class Calibration
+{
+public:
+	static constexpr unsigned registerCount{6};
+
+	struct Transform {
+		uint32_t values[registerCount]; ///< REG_TOUCH_TRANSFORM_A..F
+	};
+
+	using Callback = Delegate<void(bool success)>;
+
+	/**
+	 * @brief Constructor
+	 * @param display
+	 * @param partition Storage for the calibration record
+	 * @param offset Location of record within partition, must be at the start of an erase block
+	 */
+	Calibration(EveDisplay& display, Storage::Partition partition, uint32_t offset = 0)
+		: display(display), partition(partition), offset(offset)
+	{
+	}
+
+	/**
+	 * @brief Restore stored calibration, or run calibration if required
+	 * @param callback Invoked when calibration completes, or with `false` if it could not be started.
+	 * Not called if the stored values were used.
+	 * @param force true to ignore any stored values and calibrate again
+	 * @retval bool true if the stored values were restored, false if calibration is required
+	 */
+	bool begin(Callback callback, bool force = false);
+
+	/**
+	 * @brief Load stored calibration and write it to the device
+	 * @retval bool false if no valid record is stored
+	 */
+	bool restore();
+
+	/**
+	 * @brief Run CMD_CALIBRATE and store the result
+	 * @param callback Invoked on completion
+	 * @param prompt Text displayed above the dots, nullptr for none
+	 * @retval bool false if calibration is already in progress or commands could not be sent
+	 */
+	bool calibrate(Callback callback, const char* prompt = "Tap the dots");
+
+	/**
+	 * @brief Erase the stored record so calibration is run at the next boot
+	 */
+	bool clear();
+
+	/**
+	 * @brief Read current calibration from the device
+	 */
+	void read(Transform& transform)
+	{
+		display.read(REG_TOUCH_TRANSFORM_A, transform.values, sizeof(transform.values));
+	}
+
+	/**
+	 * @brief Write calibration to the device
+	 */
+	void write(const Transform& transform)
+	{
+		display.blockWrite(REG_TOUCH_TRANSFORM_A, transform.values, registerCount);
+	}
+
+	/**
+	 * @brief Read stored calibration
+	 * @retval bool false if the record is missing, corrupt or for a different display size
+	 */
+	bool load(Transform& transform);
+
+	/**
+	 * @brief Store calibration values
+	 */
+	bool save(const Transform& transform);
+
+	bool isBusy() const
+	{
+		return fifoMark >= 0;
+	}
+
+private:
+	struct Record;
+
+	void poll();
+	void complete(bool success);
+	uint32_t getDisplaySize();
+
+	EveDisplay& display;
+	Storage::Partition partition;
+	uint32_t offset;
+	Callback callback;
+	SimpleTimer timer;
+	int fifoMark{-1}; ///< FIFO offset following CMD_CALIBRATE, -1 when idle
+};
+
+} // namespace Graphics::EVE
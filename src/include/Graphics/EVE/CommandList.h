@@ -0,0 +1,152 @@
+#pragma once
+
+#include "EVE.h"
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Buffer for constructing display lists in CPU RAM
+ *
+ * Lists are built up-front then dispatched to the display in as few transfers as possible.
+ * Each entry is a 32-bit word so display list content can be written directly to `EVE_RAM_DL`.
+ * Lists may also contain co-processor commands, in which case they go via the command FIFO.
+ */
+class CommandList
+{
+public:
+	/**
+	 * @brief Create a list
+	 * @param capacity Maximum number of 32-bit words the list can hold
+	 */
+	CommandList(size_t capacity) : buffer(new uint32_t[capacity]), capacity(capacity)
+	{
+	}
+
+	/**
+	 * @brief Append a single word
+	 * @retval bool false if there is insufficient space
+	 */
+	bool add(uint32_t word)
+	{
+		if(count >= capacity) {
+			return false;
+		}
+		buffer[count++] = word;
+		return true;
+	}
+
+	/**
+	 * @brief Append a block of words
+	 * @retval bool false if there is insufficient space, in which case nothing is added
+	 */
+	bool add(const uint32_t* words, size_t wordCount)
+	{
+		if(wordCount > available()) {
+			return false;
+		}
+		std::copy_n(words, wordCount, &buffer[count]);
+		count += wordCount;
+		return true;
+	}
+
+	template <size_t N> bool add(const uint32_t (&words)[N])
+	{
+		return add(words, N);
+	}
+
+	/**
+	 * @brief Append a co-processor command
+	 * @param cmd
+	 * @param params Parameter words, use `MAKE_COPROC_PARAM16` to combine 16-bit pairs
+	 * @retval bool false if there is insufficient space, in which case nothing is added
+	 *
+	 * Lists containing co-processor commands must be sent via `EveDisplay::sendCommands()`.
+	 */
+	template <typename... Params> bool addCommand(CoproCommand cmd, Params... params)
+	{
+		const uint32_t words[]{MAKE_COPROC_CMD_WORD(cmd), uint32_t(params)...};
+		return add(words);
+	}
+
+	/**
+	 * @brief Append a register write using CMD_MEMWRITE
+	 * @param address Register address
+	 * @param value
+	 * @retval bool false if there is insufficient space, in which case nothing is added
+	 *
+	 * The co-processor performs the write when it reaches this point in the stream,
+	 * so it takes effect in order with surrounding commands.
+	 */
+	bool addRegisterWrite(uint32_t address, uint32_t value)
+	{
+		return addCommand(CMD_MEMWRITE, address, sizeof(uint32_t), value);
+	}
+
+	/**
+	 * @brief Append a string parameter, as used by CMD_TEXT, CMD_BUTTON, etc.
+	 * @param str
+	 * @retval bool false if there is insufficient space, in which case nothing is added
+	 *
+	 * The terminating NUL is included and the string is zero-padded to a whole number of words.
+	 */
+	bool addString(const char* str)
+	{
+		auto len = strlen(str) + 1;
+		auto wordCount = (len + 3) / 4;
+		if(wordCount > available()) {
+			return false;
+		}
+		buffer[count + wordCount - 1] = 0;
+		memcpy(&buffer[count], str, len);
+		count += wordCount;
+		return true;
+	}
+
+	/**
+	 * @brief Discard content so the list can be re-used
+	 */
+	void clear()
+	{
+		count = 0;
+	}
+
+	const uint32_t* data() const
+	{
+		return buffer.get();
+	}
+
+	/**
+	 * @brief Get number of words in the list
+	 */
+	size_t length() const
+	{
+		return count;
+	}
+
+	/**
+	 * @brief Get size of list content in bytes
+	 */
+	size_t size() const
+	{
+		return count * sizeof(uint32_t);
+	}
+
+	/**
+	 * @brief Get number of words which may still be added
+	 */
+	size_t available() const
+	{
+		return capacity - count;
+	}
+
+private:
+	std::unique_ptr<uint32_t[]> buffer;
+	size_t capacity;
+	size_t count{0};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Calculate standard (IEEE 802.3) CRC32
+ * @param data
+ * @param length
+ * @param crc Value from a previous call to continue a calculation
+ * @retval uint32_t
+ *
+ * This is the same algorithm used by CMD_MEMCRC, so the result for a block of data
+ * can be compared directly with the value calculated by the EVE over its copy in GRAM.
+ */
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+} // namespace Graphics::EVE
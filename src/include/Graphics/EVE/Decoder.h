@@ -0,0 +1,160 @@
+#pragma once
+
+#include "Schema.h"
+#include <cstddef>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Decodes and validates display lists and co-processor command streams
+ *
+ * Commands are identified using the tables in `Schema.h`, generated from `tools/eve.py`, so this
+ * decodes exactly what the python tools do. Each word is looked up by table index without copying
+ * or allocation, so whole recorded sessions can be scanned quickly on the host. The same code runs
+ * on-device, for example to check a CommandList before sending it.
+ *
+ * Issues detected:
+ *
+ * - Unknown commands and streams which end part-way through a command
+ * - Addresses, and address ranges given by a length parameter, outside the memory map
+ * - Parameters which must be multiples of 4, and stream lengths which are not
+ * - BEGIN without END before the next BEGIN, DISPLAY or CMD_SWAP; END without BEGIN
+ * - Display lists exceeding RAM_DL. For command streams only words sent directly are counted,
+ *   not those generated by widgets, so this is a lower bound.
+ *
+ * CMD_INFLATE data length is determined by decompressing the stream, so requires a Host build.
+ * Elsewhere the remainder of the buffer passed to `decode()` is taken as compressed data.
+ */
+class Decoder
+{
+public:
+	enum class Source {
+		commands,	///< Co-processor command stream, which may contain display list words
+		displayList, ///< RAM_DL content, possibly several lists each terminated by DISPLAY
+	};
+
+	enum class Issue : uint8_t {
+		unknownCommand,
+		truncated,
+		misaligned,
+		badAddress,
+		badData, ///< CMD_INFLATE data is not a valid zlib stream
+		nestedBegin,
+		endWithoutBegin,
+		missingEnd,
+		dlOverflow,
+	};
+
+	/**
+	 * @brief A decoded command, valid only for the duration of a Handler callback
+	 */
+	struct Command {
+		const Schema::Command* def; ///< nullptr for unknown commands
+		const uint8_t* data;		///< Start of command word
+		uint32_t offset;			///< Byte offset from start of stream
+		uint32_t length;			///< Total size including payload and padding
+		const uint8_t* payload;		///< String or data block content, if any
+		uint32_t payloadLength;		///< Excludes string NUL terminator
+		bool coprocessor;
+
+		uint32_t word() const
+		{
+			return data[0] | (data[1] << 8) | (data[2] << 16) | (uint32_t(data[3]) << 24);
+		}
+
+		/**
+		 * @brief Get value of a fixed-size parameter, sign-extended where the type is signed
+		 */
+		int32_t getValue(unsigned paramIndex) const;
+	};
+
+	class Handler
+	{
+	public:
+		virtual ~Handler()
+		{
+		}
+
+		virtual void command(const Command& cmd)
+		{
+		}
+
+		/**
+		 * @brief Called for each problem found
+		 * @param cmd Command concerned, nullptr if the issue concerns the stream as a whole
+		 * @param offset Byte offset from start of stream
+		 * @param issue
+		 */
+		virtual void issue(const Command* cmd, uint32_t offset, Issue issue)
+		{
+		}
+	};
+
+	struct Stats {
+		uint64_t bytes;
+		uint32_t displayListWords;
+		uint32_t coprocessorCommands;
+		uint32_t issues;
+	};
+
+	Decoder(Source source, Handler* handler = nullptr);
+	~Decoder();
+
+	/**
+	 * @brief Decode a block of data
+	 * @param data
+	 * @param length
+	 * @retval size_t Number of bytes consumed
+	 *
+	 * Stops before any incomplete command at the end of the block. To process a stream in pieces,
+	 * resubmit the unconsumed bytes at the start of the next block.
+	 */
+	size_t decode(const void* data, size_t length);
+
+	/**
+	 * @brief Report issues outstanding at the end of the stream
+	 */
+	void finish();
+
+	/**
+	 * @brief Prepare to decode a new stream
+	 */
+	void reset();
+
+	const Stats& getStats() const
+	{
+		return stats;
+	}
+
+	/**
+	 * @brief Write command as text, e.g. `TEXT(x=10, y=20, font=28, options=0, s="Hello")`
+	 * @retval size_t Length of text, excluding NUL terminator; output is truncated to fit buffer
+	 */
+	static size_t format(const Command& cmd, char* buffer, size_t bufSize);
+
+	static const char* toString(Issue issue);
+
+private:
+	bool decodeCommand(Command& cmd, const uint8_t* end);
+	bool coprocessorPayload(Command& cmd, const Schema::Param& param, const uint8_t* end);
+	void check(const Command& cmd);
+	void checkAddresses(const Command& cmd);
+	void displayListWord(const Command& cmd);
+	void startList();
+	void report(const Command* cmd, uint32_t offset, Issue issue);
+
+	Source source;
+	Handler* handler;
+	Stats stats{};
+	uint32_t streamOffset{0};
+	uint32_t pending{0};
+	uint32_t listWords{0};
+	bool primitive{false};
+	bool overflow{false};
+	bool badStream{false};
+	uint32_t inflateOutput{0};
+	std::unique_ptr<uint8_t[]> inflateBuffer;
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Run an object's handler in task context, safely with respect to its destruction
+ *
+ * Request completion callbacks may run in interrupt context, so they queue a task to continue.
+ * A queued task can't be cancelled, so if it refers to the object directly it may run after the
+ * object has been destroyed. Instead the task refers to a small heap-allocated token. When the
+ * object is destroyed with a task still queued the token is detached, and is freed by the task
+ * when it runs.
+ *
+ * Owners must wait for their requests to complete before this object is destroyed.
+ * Requests for a task which is already queued are merged.
+ */
+class DeferredTask
+{
+public:
+	using Handler = void (*)(void* owner);
+
+	DeferredTask(Handler handler, void* owner);
+	~DeferredTask();
+
+	DeferredTask(const DeferredTask&) = delete;
+	DeferredTask& operator=(const DeferredTask&) = delete;
+
+	/**
+	 * @brief Queue the handler to run in task context
+	 * @note May be called from interrupt context
+	 */
+	void queue();
+
+	/**
+	 * @brief Check whether the handler is waiting to run
+	 */
+	bool isQueued() const
+	{
+		return token->queued;
+	}
+
+private:
+	struct Token {
+		Handler handler;
+		void* owner; ///< nullptr once detached
+		volatile bool queued;
+	};
+
+	static void run(void* param);
+
+	Token* token;
+};
+
+} // namespace Graphics::EVE
@@ -2,10 +2,23 @@
 
 #include <HSPI/MemoryDevice.h>
 #include "EVE.h"
+#include "CommandList.h"
+#include "Stats.h"
+#include "RegisterCache.h"
+#include "Registers.h"
+#ifdef ARCH_HOST
+#include "Emulator.h"
+#endif
 #include <FlashString/Array.hpp>
+#include <Delegate.h>
 
 namespace Graphics
 {
+namespace EVE
+{
+class TraceRecorder;
+}
+
 class EveDisplay : public HSPI::MemoryDevice
 {
 public:
@@ -27,6 +40,19 @@ public:
 		uint8_t pclk;		 ///< PCLK frequency divider, 0=disable
 	};
 
+	/**
+	 * @brief Diagnostic information captured when the co-processor faults
+	 */
+	struct Fault {
+		uint32_t time;		   ///< System time when detected, in microseconds
+		uint32_t frames;	   ///< REG_FRAMES
+		uint16_t writeOffset;  ///< REG_CMD_WRITE, the end of the submitted commands
+		uint16_t dlOffset;	 ///< REG_CMD_DL, display list bytes generated before the fault
+		uint32_t commands[16]; ///< FIFO words preceding `writeOffset`, oldest first
+	};
+
+	using FaultCallback = Delegate<void(const Fault& fault)>;
+
 	using MemoryDevice::MemoryDevice;
 
 	size_t getSize() const override
@@ -67,15 +93,612 @@ public:
 		return addr < EVE::EVE_MEMORY_SIZE;
 	}
 
-	void blockWrite(uint32_t addr, const uint32_t* values, unsigned count);
+	/*
+	 * All transfers go through execute() so they can be accounted for.
+	 * The MemoryDevice methods are re-declared here as the base class versions call Device::execute() directly.
+	 */
+
+	void execute(HSPI::Request& req)
+	{
+		auto& transfer = stats.getTransfer(getIoMode());
+		++transfer.transactions;
+		transfer.bytes += req.out.length + req.in.length;
+		if(trace != nullptr) {
+			executeTraced(req);
+			return;
+		}
+		dispatch(req);
+	}
+
+	void write(HSPI::Request& req, uint32_t address, const void* data, size_t len, HSPI::Callback callback = nullptr,
+			   void* param = nullptr)
+	{
+		registers.invalidate(address, len);
+		prepareWrite(req, address);
+		req.out.set(data, len);
+		req.in.clear();
+		req.setAsync(callback, param);
+		execute(req);
+	}
+
+	void write(uint32_t address, const void* data, size_t len)
+	{
+		registers.invalidate(address, len);
+		HSPI::Request req;
+		prepareWrite(req, address);
+		req.out.set(data, len);
+		req.in.clear();
+		execute(req);
+	}
+
+	void write8(uint32_t address, uint8_t value)
+	{
+		if(!writeRegister(address, value, 1)) {
+			return;
+		}
+		HSPI::Request req;
+		prepareWrite(req, address);
+		req.out.set8(value);
+		req.in.clear();
+		execute(req);
+	}
+
+	void write16(uint32_t address, uint16_t value)
+	{
+		if(!writeRegister(address, value, 2)) {
+			return;
+		}
+		HSPI::Request req;
+		prepareWrite(req, address);
+		req.out.set16(value);
+		req.in.clear();
+		execute(req);
+	}
+
+	void write32(uint32_t address, uint32_t value)
+	{
+		if(!writeRegister(address, value, 4)) {
+			return;
+		}
+		HSPI::Request req;
+		prepareWrite(req, address);
+		req.out.set32(value);
+		req.in.clear();
+		execute(req);
+	}
+
+	void read(HSPI::Request& req, uint32_t address, void* buffer, size_t len, HSPI::Callback callback = nullptr,
+			  void* param = nullptr)
+	{
+		prepareRead(req, address);
+		req.out.clear();
+		req.in.set(buffer, len);
+		req.setAsync(callback, param);
+		execute(req);
+	}
+
+	void read(uint32_t address, void* buffer, size_t len)
+	{
+		HSPI::Request req;
+		prepareRead(req, address);
+		req.out.clear();
+		req.in.set(buffer, len);
+		execute(req);
+	}
+
+	uint8_t read8(uint32_t address)
+	{
+		uint32_t value;
+		if(readRegister(address, 1, value)) {
+			return value;
+		}
+		HSPI::Request req;
+		prepareRead(req, address);
+		req.out.clear();
+		req.in.set8(0);
+		execute(req);
+		return req.in.data8;
+	}
+
+	uint16_t read16(uint32_t address)
+	{
+		uint32_t value;
+		if(readRegister(address, 2, value)) {
+			return value;
+		}
+		HSPI::Request req;
+		prepareRead(req, address);
+		req.out.clear();
+		req.in.set16(0);
+		execute(req);
+		return req.in.data16;
+	}
+
+	uint32_t read32(uint32_t address)
+	{
+		uint32_t value;
+		if(readRegister(address, 4, value)) {
+			return value;
+		}
+		HSPI::Request req;
+		prepareRead(req, address);
+		req.out.clear();
+		req.in.set32(0);
+		execute(req);
+		return req.in.data32;
+	}
+
+	/**
+	 * @brief Read a register using its natural width
+	 *
+	 * Fails to compile if the register is write-only.
+	 */
+	template <EVE::Register reg> typename EVE::Registers::Traits<reg>::Value read()
+	{
+		constexpr auto& desc = EVE::Registers::Traits<reg>::descriptor;
+		static_assert(desc.canRead(), "Register is write-only");
+		if constexpr(desc.size() == 1) {
+			return read8(reg);
+		} else if constexpr(desc.size() == 2) {
+			return read16(reg);
+		} else {
+			return read32(reg);
+		}
+	}
+
+	/**
+	 * @brief Write a register using its natural width
+	 *
+	 * Fails to compile if the register is read-only.
+	 */
+	template <EVE::Register reg> void write(typename EVE::Registers::Traits<reg>::Value value)
+	{
+		constexpr auto& desc = EVE::Registers::Traits<reg>::descriptor;
+		static_assert(desc.canWrite(), "Register is read-only");
+		assert(desc.fits(value));
+		if constexpr(desc.size() == 1) {
+			write8(reg, value);
+		} else if constexpr(desc.size() == 2) {
+			write16(reg, value);
+		} else {
+			write32(reg, value);
+		}
+	}
+
+	/**
+	 * @brief Write a run of adjacent registers in a single transfer
+	 *
+	 * For example:
+	 *
+	 * 	display.writeBurst<REG_VOL_PB, REG_VOL_SOUND, REG_SOUND>(0xff, 0x40, 0x60);
+	 *
+	 * Fails to compile if any register is read-only or they're not adjacent and in address order.
+	 * The transfer is skipped if the shadow register cache shows no values would change.
+	 */
+	template <EVE::Register... regs> void writeBurst(typename EVE::Registers::Traits<regs>::Value... values)
+	{
+		using namespace EVE::Registers;
+		constexpr EVE::Register addresses[]{regs...};
+		static_assert(isContiguous(addresses, sizeof...(regs)), "Registers must be adjacent");
+		static_assert((Traits<regs>::descriptor.canWrite() && ...), "Register is read-only");
+		assert((Traits<regs>::descriptor.fits(values) && ...));
+		const uint32_t words[]{uint32_t(values)...};
+		writeRegisters(addresses[0], words, sizeof...(regs));
+	}
+
+	/**
+	 * @brief Direct in-band register writes to a command list
+	 * @param list Pass nullptr to revert to immediate writes
+	 *
+	 * Typically set whilst building a frame so register changes such as backlight level or REG_PLAY
+	 * happen at the right point relative to the frame's commands, without first waiting for the
+	 * FIFO to drain.
+	 */
+	void setStream(EVE::CommandList* list)
+	{
+		stream = list;
+	}
+
+	EVE::CommandList* getStream() const
+	{
+		return stream;
+	}
+
+	/**
+	 * @brief Write a register in sequence with co-processor commands
+	 * @param address Register address
+	 * @param value
+	 *
+	 * @retval bool false if the stream is full, in which case nothing is written
+	 *
+	 * If a stream is set, appends CMD_MEMWRITE to it, otherwise the register is written immediately.
+	 * On failure the caller should send or enlarge the list and try again: writing the register
+	 * directly would apply it out of order with the frame.
+	 *
+	 * Host-owned registers known to hold the value already are skipped. The shadow copy is
+	 * invalidated by an in-band write, as the list may be discarded rather than sent.
+	 */
+	bool writeInBand(uint32_t address, uint32_t value);
+
+	template <EVE::Register reg> bool writeInBand(typename EVE::Registers::Traits<reg>::Value value)
+	{
+		constexpr auto& desc = EVE::Registers::Traits<reg>::descriptor;
+		static_assert(desc.canWrite(), "Register is read-only");
+		assert(desc.fits(value));
+		return writeInBand(reg, value);
+	}
+
+	void blockWrite(uint32_t addr, const uint32_t* values, unsigned count)
+	{
+		registers.invalidate(addr, count * sizeof(uint32_t));
+		writeBlock(addr, values, count);
+	}
 
 	void blockWrite(uint32_t addr, const FSTR::Array<uint32_t>& values)
 	{
 		blockWrite(addr, values.data(), values.length());
 	}
 
+	/**
+	 * @brief Stage a register write
+	 * @param address Register address
+	 * @param value
+	 *
+	 * Host-owned registers (see EVE::RegisterCache) are updated in the shadow copy and written by
+	 * the next call to `flushRegisters()`, only if changed. Other registers are written immediately.
+	 */
+	void setRegister(uint32_t address, uint32_t value)
+	{
+		if(!registers.set(address, value)) {
+			write32(address, value);
+		}
+	}
+
+	/**
+	 * @brief Write all staged registers, merging adjacent ones into burst writes
+	 */
+	void flushRegisters();
+
+	/**
+	 * @brief Discard shadow register values
+	 *
+	 * Call after changing a host-owned register by other means, such as CMD_SETROTATE.
+	 * Any staged writes are also discarded.
+	 */
+	void invalidateRegisters()
+	{
+		registers.invalidate();
+	}
+
+	/**
+	 * @brief Write commands to the co-processor FIFO via REG_CMDB_WRITE
+	 * @param words Command words
+	 * @param count Number of words
+	 * @retval bool false if the co-processor stopped accepting commands
+	 *
+	 * Data is written in bursts as FIFO space becomes available, so may be any length.
+	 * Fails if the FIFO is locked by an asynchronous writer.
+	 */
+	bool sendCommands(const uint32_t* words, unsigned count);
+
+	/**
+	 * @brief Write commands to the co-processor FIFO asynchronously
+	 * @param req Request to use, must not be re-used until complete
+	 * @param words Command words, must remain valid until the request completes
+	 * @param count Number of words
+	 * @param callback Invoked on completion, may be in interrupt context
+	 * @param param
+	 *
+	 * Unlike `sendCommands()` this doesn't wait for space so the caller must check REG_CMDB_SPACE first.
+	 * A caller which splits a command list across several writes should hold `lockCommands()` until
+	 * the last one so other commands aren't spliced into it.
+	 */
+	void writeCommands(HSPI::Request& req, const uint32_t* words, unsigned count, HSPI::Callback callback = nullptr,
+					   void* param = nullptr);
+
+	/**
+	 * @brief Reserve the command FIFO for an asynchronous writer
+	 * @param lock true to reserve, false to release
+	 *
+	 * Whilst reserved, `sendCommands()` fails rather than inserting commands part-way through
+	 * a list being written in chunks.
+	 */
+	void lockCommands(bool lock)
+	{
+		commandsLocked = lock;
+	}
+
+	bool isCommandsLocked() const
+	{
+		return commandsLocked;
+	}
+
+	/**
+	 * @brief Get total number of bytes written to the command FIFO
+	 *
+	 * Tracked by the host so no read is required. The low 12 bits equal REG_CMD_WRITE, provided all
+	 * commands are sent using `sendCommands()` or `writeCommands()`. Used to locate command results
+	 * in RAM_CMD and to tell whether they may have been overwritten.
+	 */
+	uint32_t getFifoPosition() const
+	{
+		return fifoPosition;
+	}
+
+	/**
+	 * @brief Progress of the co-processor towards a FIFO position
+	 */
+	enum class FifoProgress {
+		pending, ///< Commands before the position are still to be executed
+		passed,	 ///< All commands before the position have been executed
+		fault,	 ///< Co-processor has faulted
+	};
+
+	/**
+	 * @brief Determine progress towards a FIFO position from register values
+	 * @param mark Value of `getFifoPosition()` following the commands of interest
+	 * @param cmdRead Value of REG_CMD_READ
+	 * @param cmdWrite Value of REG_CMD_WRITE
+	 *
+	 * For callers which read the registers themselves, for example asynchronously.
+	 */
+	static FifoProgress getFifoProgress(uint32_t mark, uint32_t cmdRead, uint32_t cmdWrite);
+
+	/**
+	 * @brief Read REG_CMD_READ and REG_CMD_WRITE and determine progress towards a FIFO position
+	 */
+	FifoProgress getFifoProgress(uint32_t mark);
+
+	/**
+	 * @brief Read a value returned by a co-processor command
+	 * @param mark Value of `getFifoPosition()` following the command
+	 * @param wordsFromEnd Location of result, counting back from the end of the command
+	 *
+	 * Commands which return values overwrite their trailing parameters. The result is only valid
+	 * once the co-processor has passed `mark`, and until it has been overwritten by later commands.
+	 */
+	uint32_t readResult(uint32_t mark, unsigned wordsFromEnd = 1)
+	{
+		return read32(EVE::EVE_RAM_CMD + ((mark - wordsFromEnd * 4) & EVE::EVE_CMDFIFO_MASK));
+	}
+
+	bool sendCommands(const EVE::CommandList& list)
+	{
+		return sendCommands(list.data(), list.length());
+	}
+
+	/**
+	 * @brief Replay a boot blob generated by `tools/blob.py`
+	 * @param blob Command stream, typically stored in flash
+	 * @retval bool false if the co-processor stopped accepting commands
+	 *
+	 * The blob replaces the setup sequence which follows `begin()`, uploading assets and
+	 * configuring fonts, bitmap handles, touch and registers in one streamed submission.
+	 * Staged register writes are flushed first. As the blob may write registers directly the
+	 * shadow copies are then discarded.
+	 */
+	bool sendCommands(const FSTR::Array<uint32_t>& blob)
+	{
+		flushRegisters();
+		registers.invalidate();
+		return sendCommands(blob.data(), blob.length());
+	}
+
+	/**
+	 * @brief Write a complete display list directly to RAM_DL and swap it in at the next frame
+	 * @param words Display list words, ending with DISPLAY(). Must remain valid until the transfer completes.
+	 * @param count Number of words
+	 * @param callback Optional callback invoked when the swap request has been written
+	 * @param param Parameter passed to callback
+	 * @retval bool false if the list is invalid or the EVE didn't become ready
+	 *
+	 * This bypasses the co-processor so is the lowest-latency path for frames containing only
+	 * display list commands. The list and REG_DLSWAP write are sent as asynchronous transfers.
+	 *
+	 * Before writing, waits for the co-processor FIFO to drain, so it isn't also writing to RAM_DL,
+	 * and for any previous swap to complete so the list being displayed is never overwritten.
+	 * Co-processor frames may be freely interleaved as CMD_DLSTART also waits for a pending swap.
+	 */
+	bool sendDisplayList(const uint32_t* words, unsigned count, HSPI::Callback callback = nullptr,
+						 void* param = nullptr);
+
+	bool sendDisplayList(const EVE::CommandList& list, HSPI::Callback callback = nullptr, void* param = nullptr)
+	{
+		return sendDisplayList(list.data(), list.length(), callback, param);
+	}
+
+	/**
+	 * @brief Wait for a display list swap to complete
+	 * @param timeoutMs
+	 * @retval bool false on timeout
+	 */
+	bool waitSwap(unsigned timeoutMs = 50);
+
+	/**
+	 * @brief Enable interrupt sources on the INT_N line
+	 * @param mask Combination of EVE::Interrupt bits to add to REG_INT_MASK
+	 *
+	 * Only sources enabled through this method are unmasked; the reset value of REG_INT_MASK is ignored.
+	 */
+	void enableInterrupts(uint8_t mask);
+
+	/**
+	 * @brief Disable interrupt sources
+	 * @param mask Combination of EVE::Interrupt bits to remove from REG_INT_MASK
+	 *
+	 * INT_N is disabled once no sources remain.
+	 */
+	void disableInterrupts(uint8_t mask);
+
+	/**
+	 * @brief Read and clear pending interrupt flags
+	 * @retval uint8_t Combination of EVE::Interrupt bits
+	 *
+	 * Typically called from a task queued by the INT_N GPIO interrupt, with the result passed
+	 * to any components which need it, such as EVE::Touch.
+	 */
+	uint8_t readInterruptFlags()
+	{
+		return read8(EVE::REG_INT_FLAGS);
+	}
+
+	/**
+	 * @brief Wait for the co-processor to process all outstanding commands
+	 * @param timeoutMs
+	 * @retval bool false on timeout or co-processor fault
+	 *
+	 * A fault is recovered from before returning.
+	 */
+	bool waitCommandsIdle(unsigned timeoutMs = 100);
+
+	/**
+	 * @brief Check REG_CMD_READ for the fault signature and recover if found
+	 * @retval bool true if the co-processor had faulted
+	 *
+	 * Faults are also detected by `waitCommandsIdle()`, `updateFrameStats()` and when
+	 * `sendCommands()` finds the FIFO full.
+	 */
+	bool checkFault();
+
+	/**
+	 * @brief Reset the co-processor and restore its state
+	 *
+	 * Diagnostic context is captured first and is available from `getLastFault()`.
+	 * Only the co-processor is reset: GRAM, the current display list and host registers are kept.
+	 * The FIFO pointers are cleared, the commands set with `setRecoveryCommands()` are replayed, and
+	 * the fault callback is invoked so the application can re-submit its frame.
+	 *
+	 * May also be called directly to abandon commands which have stalled, for example waiting for
+	 * data which will never arrive.
+	 */
+	void recoverCoprocessor();
+
+	/**
+	 * @brief Set commands to restore co-processor state after a reset
+	 * @param words Must remain valid, typically CMD_SETFONT2, CMD_SETBITMAP, CMD_SETSCRATCH, etc.
+	 * @param count Number of words
+	 *
+	 * Restoring font and bitmap registrations lets rendering resume without uploading any assets again.
+	 */
+	void setRecoveryCommands(const uint32_t* words, unsigned count)
+	{
+		recoveryCommands = words;
+		recoveryCount = count;
+	}
+
+	void setRecoveryCommands(const EVE::CommandList& list)
+	{
+		setRecoveryCommands(list.data(), list.length());
+	}
+
+	void onFault(FaultCallback callback)
+	{
+		faultCallback = callback;
+	}
+
+	const Fault& getLastFault() const
+	{
+		return lastFault;
+	}
+
+	/**
+	 * @brief Sample frame-related statistics
+	 *
+	 * Call once per frame, after CMD_SWAP has been issued. Costs two or three register reads.
+	 */
+	void updateFrameStats();
+
+	const EVE::Stats& getStats() const
+	{
+		return stats;
+	}
+
+	void resetStats()
+	{
+		stats.reset();
+		coproBusy = false;
+		lastFrameCount = 0;
+	}
+
+	/**
+	 * @brief Record all transactions
+	 * @param recorder Pass nullptr to stop recording
+	 */
+	void setTrace(EVE::TraceRecorder* recorder)
+	{
+		trace = recorder;
+	}
+
+#ifdef ARCH_HOST
+	/**
+	 * @brief Direct all requests to an emulated device instead of the SPI controller
+	 * @param emulator Pass nullptr to revert to the controller
+	 */
+	void setEmulator(EVE::Emulator* emulator)
+	{
+		this->emulator = emulator;
+	}
+#endif
+
 private:
+	void dispatch(HSPI::Request& req)
+	{
+#ifdef ARCH_HOST
+		if(emulator != nullptr) {
+			req.device = this;
+			emulator->execute(req);
+			return;
+		}
+#endif
+		MemoryDevice::execute(req);
+	}
+
+	bool writeRegister(uint32_t address, uint32_t value, unsigned size)
+	{
+		if(!EVE::RegisterCache::contains(address) || registers.write(address, value, size)) {
+			return true;
+		}
+		++stats.elidedWrites;
+		return false;
+	}
+
+	bool readRegister(uint32_t address, unsigned size, uint32_t& value)
+	{
+		if(!EVE::RegisterCache::contains(address) || !registers.read(address, size, value)) {
+			return false;
+		}
+		++stats.cachedReads;
+		return true;
+	}
+
+	void writeBlock(uint32_t addr, const uint32_t* values, unsigned count);
+	void writeRegisters(uint32_t addr, const uint32_t* values, unsigned count);
+	void executeTraced(HSPI::Request& req);
 	void cmdWrite(EVE::HostCommand cmd, uint8_t param);
+	void coproStart();
+	void coproIdle();
+
+	EVE::Stats stats{};
+	EVE::TraceRecorder* trace{nullptr};
+	EVE::RegisterCache registers;
+	EVE::CommandList* stream{nullptr};
+	HSPI::Request dlRequest;
+	HSPI::Request swapRequest;
+	uint32_t swapCommand{EVE::EVE_DLSWAP_FRAME}; ///< Source for asynchronous REG_DLSWAP write
+	Fault lastFault{};
+	FaultCallback faultCallback;
+	const uint32_t* recoveryCommands{nullptr};
+	unsigned recoveryCount{0};
+#ifdef ARCH_HOST
+	EVE::Emulator* emulator{nullptr};
+#endif
+	uint32_t coproBusyStart{0};
+	uint32_t lastFrameCount{0};
+	uint32_t fifoPosition{0};
+	uint8_t interruptMask{0}; ///< Sources enabled via enableInterrupts()
+	bool coproBusy{false};
+	bool recovering{false};
+	bool commandsLocked{false};
 };
 
 } // namespace Graphics
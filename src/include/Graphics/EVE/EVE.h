@@ -53,6 +53,8 @@ constexpr uint32_t EVE_RAM_CMD = 0x00308000;
 /* Memory buffer sizes */
 constexpr uint32_t EVE_RAM_G_SIZE = 1024 * 1024;
 constexpr uint32_t EVE_CMDFIFO_SIZE = 4 * 1024;
+constexpr uint32_t EVE_CMDFIFO_MASK = EVE_CMDFIFO_SIZE - 1;
+constexpr uint32_t EVE_CMDFIFO_FAULT = 0xfff; ///< REG_CMD_READ value following a co-processor fault
 constexpr uint32_t EVE_RAM_DL_SIZE = 8 * 1024;
 constexpr uint32_t EVE_MEMORY_SIZE = 0x00400000;
 
@@ -159,6 +161,10 @@ enum BitmapFormat {
 	BMF_TEXT8X8 = 9,
 	BMF_TEXTVGA = 10,
 	BMF_BARGRAPH = 11,
+	BMF_PALETTED565 = 14,
+	BMF_PALETTED4444 = 15,
+	BMF_PALETTED8 = 16,
+	BMF_L2 = 17,
 };
 
 /* DL_BITMAP_SIZE filter types */
@@ -506,6 +512,16 @@ static inline constexpr uint32_t MAKE_COPROC_CMD_WORD(CoproCommand cmd)
 	return 0xffffff00UL | cmd;
 }
 
+/**
+ * @brief Pack two 16-bit co-processor command parameters into one word
+ *
+ * The first parameter occupies the least significant half.
+ */
+static inline constexpr uint32_t MAKE_COPROC_PARAM16(uint16_t first, uint16_t second)
+{
+	return first | (uint32_t(second) << 16);
+}
+
 /* Registers */
 enum Register : uint32_t {
 	REG_ID = 0x00302000,
@@ -806,6 +822,14 @@ INLINE_DL_COMMAND(JUMP, uint16_t dest)
 	return MAKE_CMD_WORD(DL_JUMP, dest);
 }
 
+/**
+ * @brief Return from a previous CALL command.
+ */
+INLINE_DL_COMMAND(RETURN)
+{
+	return MAKE_CMD_WORD(DL_RETURN, 0);
+}
+
 /**
  * @brief Set the bitmap cell number for the VERTEX2F command.
  */
@@ -907,6 +931,14 @@ INLINE_DL_COMMAND(MACRO, uint8_t macro)
 	return MAKE_CMD_WORD(DL_MACRO, macro & 0x01);
 }
 
+/**
+ * @brief No operation.
+ */
+INLINE_DL_COMMAND(NOP)
+{
+	return MAKE_CMD_WORD(DL_NOP, 0);
+}
+
 /**
  * @brief Set the base address of the palette.
  * @note 2-byte alignment is required if pixel format is PALETTE4444 or PALETTE565.
@@ -924,6 +956,22 @@ INLINE_DL_COMMAND(POINT_SIZE, uint16_t size)
 	return MAKE_CMD_WORD(DL_POINT_SIZE, size & 0x1FFF);
 }
 
+/**
+ * @brief Restore the current graphics context from the context stack.
+ */
+INLINE_DL_COMMAND(RESTORE_CONTEXT)
+{
+	return MAKE_CMD_WORD(DL_RESTORE_CONTEXT, 0);
+}
+
+/**
+ * @brief Push the current graphics context on the context stack.
+ */
+INLINE_DL_COMMAND(SAVE_CONTEXT)
+{
+	return MAKE_CMD_WORD(DL_SAVE_CONTEXT, 0);
+}
+
 /**
  * @brief Set the size of the scissor clip rectangle.
  * @note valid range for width and height is from zero to 2048
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "EVE.h"
+#include "DeferredTask.h"
+#include <HSPI/Request.h>
+#include <Delegate.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+class Coprocessor;
+
+/**
+ * @brief Software model of an FT813 for Host builds
+ *
+ * Attach to an EveDisplay with `EveDisplay::setEmulator()`; all SPI requests are then serviced here instead
+ * of being passed to the hardware controller, so the complete command path can run without a board.
+ *
+ * The model covers:
+ *
+ * - The full 4 MiB address map: RAM_G, ROM (chip ID), RAM_DL, RAM_REG and RAM_CMD
+ * - Host commands (RST_PULSE etc.)
+ * - Co-processor FIFO pointers REG_CMD_READ / REG_CMD_WRITE, REG_CMDB_SPACE and REG_CMDB_WRITE
+ * - REG_DLSWAP, which copies RAM_DL to the active display list
+ * - REG_FRAMES and REG_CLOCK, derived from elapsed time
+ * - Interrupt flags, mask and enable, with a callback to represent the INT_N line
+ * - Capacitive touch registers, driven by `touch()` and `release()`
+ *
+ * The co-processor interprets the full FT81x command set apart from image and video decoding
+ * (CMD_LOADIMAGE, CMD_PLAYVIDEO, CMD_VIDEOSTART, CMD_VIDEOFRAME) which raise a fault.
+ * Memory operations, CMD_INFLATE, CMD_APPEND, CMD_SETBITMAP, matrices and result-returning commands
+ * such as CMD_GETPTR are exact. Widgets produce approximate geometry only, and ROM font glyphs are
+ * not present so text renders with correct metrics but no visible glyphs.
+ * CMD_TRACK areas update REG_TRACKER when `touch()` reports a tracked tag.
+ *
+ * Transfer time is calculated from the clock speed, I/O mode and transaction overhead so that throughput
+ * measurements (e.g. EVE::Stats) are representative. By default this is only accumulated, but may
+ * optionally be enforced in real time.
+ */
+class Emulator
+{
+public:
+	using InterruptCallback = Delegate<void()>;
+
+	struct Config {
+		uint32_t transactionOverhead{1000}; ///< Fixed cost per SPI transaction in nanoseconds
+		uint16_t frameRate{60};				///< Rate at which REG_FRAMES advances
+		bool realTime{false};				///< Delay each request by its calculated transfer time
+	};
+
+	Emulator(const Config& config);
+
+	Emulator() : Emulator(Config{})
+	{
+	}
+
+	~Emulator();
+
+	/**
+	 * @brief Reset device to power-on state
+	 */
+	void reset();
+
+	/**
+	 * @brief Service an SPI request
+	 *
+	 * Called by EveDisplay in place of the hardware controller.
+	 */
+	void execute(HSPI::Request& req);
+
+	/**
+	 * @brief Set callback to be invoked (in task context) when INT_N is asserted
+	 */
+	void onInterrupt(InterruptCallback callback)
+	{
+		interruptCallback = callback;
+	}
+
+	/**
+	 * @brief Simulate a touch
+	 * @param index Touch point (0-4)
+	 * @param x, y Screen co-ordinates
+	 * @param tag Value for corresponding REG_TOUCH_TAG register
+	 */
+	void touch(uint8_t index, int16_t x, int16_t y, uint8_t tag = 0);
+
+	/**
+	 * @brief Simulate release of a touch point
+	 */
+	void release(uint8_t index);
+
+	/**
+	 * @brief Direct access to device memory
+	 */
+	uint8_t* getMemory()
+	{
+		return memory.get();
+	}
+
+	const uint8_t* getMemory() const
+	{
+		return memory.get();
+	}
+
+	uint32_t getRegister(Register reg) const
+	{
+		return reinterpret_cast<const uint32_t*>(&memory[reg])[0];
+	}
+
+	/**
+	 * @brief Get the active (swapped) display list
+	 */
+	const uint32_t* getDisplayList() const
+	{
+		return displayList.get();
+	}
+
+	/**
+	 * @brief Get number of display list swaps performed
+	 */
+	uint32_t getSwapCount() const
+	{
+		return swapCount;
+	}
+
+	/**
+	 * @brief Get total calculated SPI transfer time in nanoseconds
+	 */
+	uint64_t getTransferTime() const
+	{
+		return transferTime;
+	}
+
+	void resetTransferTime()
+	{
+		transferTime = 0;
+	}
+
+private:
+	friend class Coprocessor;
+
+	uint32_t& reg(Register r)
+	{
+		return reinterpret_cast<uint32_t*>(&memory[r])[0];
+	}
+
+	void hostCommand(uint8_t cmd);
+	void write(uint32_t address, const uint8_t* data, size_t length);
+	void read(uint32_t address, uint8_t* buffer, size_t length);
+	void updateRegisters();
+	void writeFifo(const uint8_t* data, size_t length);
+	void runCoprocessor();
+	uint32_t fifoWord(uint32_t offset) const;
+	void writeDisplayList(uint32_t word);
+	void swap();
+	void setInterruptFlags(uint8_t flags);
+	void checkInterrupt();
+	void raiseInterrupt();
+	uint32_t calculateTransferTime(const HSPI::Request& req) const;
+
+	Config config;
+	std::unique_ptr<uint8_t[]> memory;
+	std::unique_ptr<uint32_t[]> displayList;
+	std::unique_ptr<Coprocessor> coprocessor;
+	InterruptCallback interruptCallback;
+	DeferredTask interruptTask{[](void* param) { static_cast<Emulator*>(param)->raiseInterrupt(); }, this};
+	uint64_t transferTime{0};
+	uint32_t startTime{0};
+	uint32_t swapCount{0};
+	uint8_t interruptFlags{0};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <Delegate.h>
+#include <cstdint>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief State of a single touch point
+ */
+struct TouchPoint {
+	int16_t x;
+	int16_t y;
+	uint8_t tag;
+	bool down;
+};
+
+/**
+ * @brief Content of all touch registers captured at one instant
+ */
+struct TouchSnapshot {
+	static constexpr unsigned maxPoints{5};
+
+	TouchPoint points[maxPoints];
+	uint32_t timestamp; ///< System time in microseconds when captured
+	uint8_t count;		///< Number of points currently down
+
+	bool isDown() const
+	{
+		return count != 0;
+	}
+};
+
+enum class GestureType {
+	tap,
+	drag,
+	fling,
+	pinch,
+	rotate,
+};
+
+/**
+ * @brief Describes a recognised gesture
+ *
+ * For two-finger gestures (pinch, rotate) position is the mid-point between the two fingers.
+ */
+struct Gesture {
+	enum class Phase {
+		begin,
+		update,
+		end,
+	};
+
+	GestureType type;
+	Phase phase;
+	int16_t x;	///< Current position
+	int16_t y;
+	int16_t dx;   ///< Movement since previous event
+	int16_t dy;
+	int16_t vx;   ///< Estimated velocity in pixels/second
+	int16_t vy;
+	int32_t scale; ///< Pinch scale relative to start, 16.16 fixed-point (65536 = 1.0)
+	int32_t angle; ///< Rotation relative to start in units of 1/65536 of a circle (as CMD_ROTATE)
+	uint8_t tag;   ///< Tag at start of gesture
+};
+
+/**
+ * @brief Recognises gestures from a sequence of touch snapshots
+ *
+ * One-finger gestures:
+ *
+ * tap
+ * 	Press and release within `tapTime` without moving more than `slop` pixels.
+ *
+ * drag
+ * 	Movement of more than `slop` pixels. Reported with begin, update and end phases.
+ *
+ * fling
+ * 	Reported instead of drag end if release velocity exceeds `flingSpeed`.
+ *
+ * Two-finger gestures, reported with begin, update and end phases:
+ *
+ * pinch
+ * 	Distance between fingers changes by more than `pinchThreshold`.
+ *
+ * rotate
+ * 	Angle between fingers changes by more than `rotateThreshold`.
+ *
+ * Velocity is estimated per finger using an exponentially-weighted average of
+ * displacement over time between snapshots.
+ */
+class GestureDetector
+{
+public:
+	using Callback = Delegate<void(const Gesture& gesture)>;
+
+	struct Config {
+		uint16_t slop{8};			  ///< Movement in pixels before a touch becomes a drag
+		uint16_t tapTime{300};		  ///< Maximum duration of a tap in milliseconds
+		uint16_t flingSpeed{600};	 ///< Minimum release speed for a fling, pixels/second
+		uint16_t pinchThreshold{3277}; ///< Minimum scale change (16.16) to start pinch, default 5%
+		uint16_t rotateThreshold{910}; ///< Minimum angle change to start rotate, default 5 degrees
+	};
+
+	GestureDetector() = default;
+
+	GestureDetector(const Config& config) : config(config)
+	{
+	}
+
+	void onGesture(Callback callback)
+	{
+		this->callback = callback;
+	}
+
+	/**
+	 * @brief Feed in next snapshot
+	 */
+	void update(const TouchSnapshot& snapshot);
+
+	/**
+	 * @brief Compute angle of vector in units of 1/65536 of a circle
+	 */
+	static int32_t atan2(int32_t y, int32_t x);
+
+private:
+	struct Track {
+		int16_t startX;
+		int16_t startY;
+		int16_t x;
+		int16_t y;
+		int32_t vx; ///< Velocity, pixels/second
+		int32_t vy;
+		uint32_t startTime;
+		uint8_t tag;
+		bool down;
+		bool dragging;
+		bool multi; ///< Part of a two-finger gesture so no single-finger events
+	};
+
+	void pointDown(Track& track, const TouchPoint& point, uint32_t timestamp);
+	void pointMove(Track& track, const TouchPoint& point, uint32_t elapsed);
+	void pointUp(Track& track, uint32_t timestamp);
+	void startTwoFinger();
+	void updateTwoFinger(Gesture::Phase phase);
+	Gesture makeGesture(GestureType type, Gesture::Phase phase, const Track& track) const;
+	void emit(const Gesture& gesture);
+
+	Config config{};
+	Callback callback;
+	Track tracks[TouchSnapshot::maxPoints]{};
+	uint32_t lastTimestamp{0};
+	// Two-finger state
+	uint8_t first{0};
+	uint8_t second{0};
+	bool twoFinger{false};
+	bool pinching{false};
+	bool rotating{false};
+	uint32_t startDistance{0};
+	int32_t startAngle{0};
+	int16_t midX{0};
+	int16_t midY{0};
+};
+
+} // namespace Graphics::EVE
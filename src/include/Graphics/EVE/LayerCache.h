@@ -0,0 +1,116 @@
+#pragma once
+
+#include "CommandList.h"
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Static sub-scene rendered once into a GRAM bitmap
+ *
+ * Widgets such as CMD_GAUGE, CMD_CLOCK and CMD_GRADIENT expand into many display list words and
+ * take the co-processor a long time to generate. When only a needle or value changes it's far
+ * cheaper to capture the static parts once with CMD_SNAPSHOT2 and draw the result as a single
+ * bitmap each frame, leaving the DL budget and co-processor time for the dynamic parts.
+ *
+ * To capture, build a frame with `beginCapture()`, the static content in screen coordinates,
+ * then `endCapture()`, and send it before the next regular frame. CMD_SNAPSHOT2 renders the
+ * current display list so the capture frame is shown for one frame period: capture on screen
+ * changes or when settings change rather than on every value update.
+ *
+ * With BMF_ARGB4 the region is cleared transparent so the layer can be drawn over other content.
+ * Reserve `getGramSize()` bytes of GRAM at `address`.
+ */
+class LayerCache
+{
+public:
+	struct Config {
+		uint32_t address; ///< GRAM address for bitmap, 4-byte aligned
+		int16_t x;		  ///< Screen area to capture and draw
+		int16_t y;
+		uint16_t width;
+		uint16_t height;
+		uint8_t handle;					 ///< Bitmap handle to use (0-14)
+		BitmapFormat format{BMF_RGB565}; ///< BMF_RGB565 or BMF_ARGB4
+		uint32_t background{0};			 ///< Clear colour for BMF_RGB565
+	};
+
+	LayerCache(const Config& config) : config(config)
+	{
+	}
+
+	const Config& getConfig() const
+	{
+		return config;
+	}
+
+	/**
+	 * @brief Number of bytes of GRAM required for the bitmap
+	 */
+	uint32_t getGramSize() const
+	{
+		return uint32_t(config.width) * config.height * 2;
+	}
+
+	/**
+	 * @brief Determine whether the bitmap holds a current capture
+	 */
+	bool isValid() const
+	{
+		return valid;
+	}
+
+	/**
+	 * @brief Mark content as out of date so it's captured again
+	 */
+	void invalidate()
+	{
+		valid = false;
+	}
+
+	/**
+	 * @brief Set a value summarising the inputs to the static content, such as a hash or counter
+	 * @retval bool true if key changed, in which case layer is invalidated
+	 */
+	bool setKey(uint32_t key)
+	{
+		if(key == this->key) {
+			return false;
+		}
+		this->key = key;
+		valid = false;
+		return true;
+	}
+
+	/**
+	 * @brief Start a capture frame
+	 * @retval bool false if list has insufficient space, in which case it is left unchanged
+	 *
+	 * Adds CMD_DLSTART, clears the screen and sets scissor to the layer area.
+	 * Follow with display list or widget commands for the static content.
+	 */
+	bool beginCapture(CommandList& list) const;
+
+	/**
+	 * @brief Complete a capture frame
+	 * @retval bool false if list has insufficient space, in which case it is left unchanged
+	 *
+	 * Adds DISPLAY, CMD_SWAP and CMD_SNAPSHOT2. The layer is valid once this returns:
+	 * commands execute in order so any subsequent frame will draw the captured content.
+	 */
+	bool endCapture(CommandList& list);
+
+	/**
+	 * @brief Append display list commands to draw layer bitmap
+	 * @retval bool false if list has insufficient space, in which case it is left unchanged
+	 *
+	 * Graphics context is preserved using SAVE_CONTEXT/RESTORE_CONTEXT.
+	 */
+	bool draw(CommandList& list) const;
+
+private:
+	Config config;
+	uint32_t key{0};
+	bool valid{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Display.h"
+#include <Delegate.h>
+#include <SimpleTimer.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Find the fastest reliable SPI clock and I/O mode for a particular board
+ *
+ * Each candidate setting is checked by writing a pseudo-random pattern to a GRAM scratch region,
+ * having the co-processor checksum it with CMD_MEMCRC, and reading it back. The write path, FIFO
+ * and read path are therefore all exercised. For each I/O mode the clock is raised in steps until
+ * a check fails; the setting giving the highest throughput, less `margin` steps, is selected.
+ *
+ * Settings are always changed at `minSpeed`, which must be reliable, so a failed check can't
+ * leave REG_SPI_WIDTH in an unknown state. A failure at speed may corrupt the command FIFO, in which
+ * case the co-processor is reset; call `tune()` before loading fonts or other co-processor state.
+ *
+ * `startMonitor()` repeats the check periodically at the selected setting and drops to the
+ * next lower step if it fails.
+ */
+class LinkTuner
+{
+public:
+	struct Config {
+		uint32_t scratchAddress;	 ///< GRAM region for test pattern, must not be in use by the application
+		uint16_t testSize{4096};	 ///< Bytes per check, multiple of 4
+		uint32_t minSpeed{4000000};  ///< Known-good clock used whilst changing settings
+		uint32_t maxSpeed{30000000}; ///< Highest clock to try
+		uint32_t step{2000000};		 ///< Clock increment
+		uint8_t passes{3};			 ///< Checks required at each setting, each with a different pattern
+		uint8_t margin{1};			 ///< Steps below the fastest passing clock to select
+		HSPI::IoModes modes{HSPI::IoMode::SPIHD | HSPI::IoMode::SDI | HSPI::IoMode::SQI};
+	};
+
+	/**
+	 * @brief Called by the monitor after each check
+	 * @param success false if the check failed and the clock has been reduced
+	 */
+	using Callback = Delegate<void(bool success)>;
+
+	LinkTuner(EveDisplay& display) : display(display)
+	{
+	}
+
+	~LinkTuner()
+	{
+		stopMonitor();
+	}
+
+	/**
+	 * @brief Test all candidate settings and select the best
+	 * @retval bool false if no setting passed, in which case `minSpeed` and SPIHD are selected
+	 */
+	bool tune(const Config& config);
+
+	/**
+	 * @brief Check the link at the current setting
+	 * @retval bool true if written, checksummed and read-back data all match
+	 */
+	bool verify();
+
+	/**
+	 * @brief Start periodic checks at the current setting
+	 * @param intervalMs Time between checks
+	 * @param callback Optional
+	 */
+	void startMonitor(unsigned intervalMs, Callback callback = nullptr);
+
+	void stopMonitor()
+	{
+		timer.stop();
+	}
+
+	uint32_t getSpeed() const
+	{
+		return display.getSpeed();
+	}
+
+	HSPI::IoMode getIoMode() const
+	{
+		return display.getIoMode();
+	}
+
+private:
+	void select(HSPI::IoMode mode, uint32_t speed);
+	bool check(uint32_t seed);
+	bool memcrc(uint32_t& crc);
+	void recover();
+	void monitor();
+
+	EveDisplay& display;
+	Config config{};
+	Callback callback;
+	SimpleTimer timer;
+	std::unique_ptr<uint32_t[]> pattern;
+	std::unique_ptr<uint32_t[]> readback;
+	uint32_t nextSeed{1};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Print.h>
+#include <cstdint>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Streaming PNG encoder for 8-bit RGB images
+ *
+ * Rows are written as they become available using uncompressed (stored) deflate blocks,
+ * one IDAT chunk per row. No image buffer or compression library is required so this
+ * is suitable for use on-device as well as with the host emulator.
+ */
+class PngWriter
+{
+public:
+	PngWriter(Print& out, uint16_t width, uint16_t height) : out(out), width(width), height(height)
+	{
+	}
+
+	/**
+	 * @brief Write PNG signature and header
+	 */
+	bool begin();
+
+	/**
+	 * @brief Write next row of pixels
+	 * @param rgb `width` pixels of 3 bytes each, red first
+	 * @retval bool false on output error or if all rows have been written
+	 *
+	 * The image is completed automatically when the last row is written.
+	 */
+	bool writeRow(const uint8_t* rgb);
+
+	bool isFinished() const
+	{
+		return row >= height;
+	}
+
+private:
+	bool beginChunk(const char* type, uint32_t length);
+	bool chunkData(const void* data, size_t length);
+	bool endChunk();
+
+	Print& out;
+	uint16_t width;
+	uint16_t height;
+	uint16_t row{0};
+	uint32_t crc{0};
+	uint32_t adler{1};
+};
+
+} // namespace Graphics::EVE
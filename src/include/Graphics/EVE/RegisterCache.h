@@ -0,0 +1,117 @@
+#pragma once
+
+#include "EVE.h"
+#include <cstddef>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Shadow copy of host-owned EVE registers
+ *
+ * Configuration registers such as REG_PWM_DUTY, REG_GPIO, REG_VOL_* and REG_ROTATE are only
+ * changed by the host, so EveDisplay keeps a copy of the last value written. Writes which wouldn't
+ * change anything are skipped and reads of registers the EVE never changes are served from RAM.
+ * Registers may also be staged with `set()` and written together in as few bursts as possible.
+ *
+ * Values are indexed by register address so runs of adjacent dirty registers are contiguous
+ * in memory and can be written with one transfer.
+ *
+ * An entry becomes valid when written, holding the value zero-extended to 32 bits, so registers
+ * should be written using their natural width. All entries are invalidated by host commands
+ * (e.g. RST_PULSE). Writes to REG_CPURESET invalidate clean entries but keep staged values, which
+ * a co-processor reset doesn't affect. Registers changed by the co-processor, for example
+ * REG_ROTATE by CMD_SETROTATE, must be invalidated by the application.
+ */
+class RegisterCache
+{
+public:
+	static constexpr uint32_t firstRegister{REG_CPURESET};
+	static constexpr uint32_t lastRegister{REG_SPI_WIDTH};
+	static constexpr unsigned count{(lastRegister - firstRegister) / 4 + 1};
+
+	static constexpr bool contains(uint32_t address)
+	{
+		return address >= firstRegister && address < lastRegister + 4;
+	}
+
+	/**
+	 * @brief Get cached register value
+	 * @param address Register address
+	 * @param size Access size in bytes
+	 * @param value On success, receives the value
+	 * @retval bool true if value is cached and the register is host-owned
+	 */
+	bool read(uint32_t address, unsigned size, uint32_t& value) const;
+
+	/**
+	 * @brief Record a register write
+	 * @param address Register address
+	 * @param value
+	 * @param size Access size in bytes
+	 * @retval bool true if the write must be sent to the device, false if it can be skipped
+	 */
+	bool write(uint32_t address, uint32_t value, unsigned size);
+
+	/**
+	 * @brief Stage a register value for the next flush
+	 * @retval bool false if register isn't cached, in which case it should be written directly
+	 */
+	bool set(uint32_t address, uint32_t value);
+
+	/**
+	 * @brief Find next run of registers to be written
+	 * @param address On success, the first register in the run
+	 * @param values On success, points to the values to write
+	 * @retval unsigned Number of registers in the run, 0 if there are no more dirty registers
+	 *
+	 * The returned registers are marked clean. A run may include valid clean registers between
+	 * dirty ones where that saves a transfer.
+	 */
+	unsigned nextDirtyRun(uint32_t& address, const uint32_t*& values);
+
+	bool isDirty() const
+	{
+		return dirtyCount != 0;
+	}
+
+	/**
+	 * @brief Discard all cached values, including any staged writes
+	 */
+	void invalidate();
+
+	/**
+	 * @brief Discard cached values but keep staged writes
+	 */
+	void invalidateClean();
+
+	/**
+	 * @brief Discard cached values for a range of memory
+	 */
+	void invalidate(uint32_t address, size_t length)
+	{
+		if(length != 0 && address < lastRegister + 4 && address + length > firstRegister) {
+			invalidateRange(address, address + length - 1);
+		}
+	}
+
+private:
+	enum Flag : uint8_t {
+		flagValid = 0x01,
+		flagDirty = 0x02,
+	};
+
+	void invalidateRange(uint32_t address, uint32_t end);
+	static bool isShadowed(unsigned index);
+	static bool isHostOwned(unsigned index);
+
+	static constexpr unsigned getIndex(uint32_t address)
+	{
+		return (address - firstRegister) / 4;
+	}
+
+	uint32_t values[count]{};
+	uint8_t flags[count]{};
+	uint8_t dirtyCount{0};
+};
+
+} // namespace Graphics::EVE
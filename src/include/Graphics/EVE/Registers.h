@@ -0,0 +1,192 @@
+/****
+ * Registers.h
+ *
+ * Register descriptors, generated from eve.py. Do not edit.
+ *
+ *   python3 tools/gen.py --registers > src/include/Graphics/EVE/Registers.h
+ *
+ ****/
+
+#pragma once
+
+#include "EVE.h"
+#include <type_traits>
+
+namespace Graphics::EVE::Registers
+{
+enum class Access : uint8_t {
+	read = 0x01,
+	write = 0x02,
+	readWrite = 0x03,
+};
+
+struct Descriptor {
+	Register address;
+	uint8_t bitcount;
+	Access access;
+	uint32_t reset; ///< Value following reset (FT812/FT813)
+
+	/**
+	 * @brief Transfer size in bytes
+	 */
+	constexpr uint8_t size() const
+	{
+		return (bitcount <= 8) ? 1 : (bitcount <= 16) ? 2 : 4;
+	}
+
+	constexpr bool canRead() const
+	{
+		return uint8_t(access) & uint8_t(Access::read);
+	}
+
+	constexpr bool canWrite() const
+	{
+		return uint8_t(access) & uint8_t(Access::write);
+	}
+
+	/**
+	 * @brief Determine whether a value fits in the register
+	 */
+	constexpr bool fits(uint32_t value) const
+	{
+		return bitcount >= 32 || (value >> bitcount) == 0;
+	}
+};
+
+inline constexpr Descriptor descriptors[]{
+	{REG_ID, 8, Access::read, 0x7c},
+	{REG_FRAMES, 32, Access::read, 0x0},
+	{REG_CLOCK, 32, Access::read, 0x0},
+	{REG_FREQUENCY, 28, Access::readWrite, 0x3938700},
+	{REG_RENDERMODE, 1, Access::readWrite, 0x0},
+	{REG_SNAPY, 11, Access::readWrite, 0x0},
+	{REG_SNAPSHOT, 1, Access::readWrite, 0x0},
+	{REG_SNAPFORMAT, 6, Access::readWrite, 0x20},
+	{REG_CPURESET, 3, Access::readWrite, 0x2},
+	{REG_TAP_CRC, 32, Access::read, 0x0},
+	{REG_TAP_MASK, 32, Access::readWrite, 0xffffffff},
+	{REG_HCYCLE, 12, Access::readWrite, 0x224},
+	{REG_HOFFSET, 12, Access::readWrite, 0x2b},
+	{REG_HSIZE, 12, Access::readWrite, 0x1e0},
+	{REG_HSYNC0, 12, Access::readWrite, 0x0},
+	{REG_HSYNC1, 12, Access::readWrite, 0x29},
+	{REG_VCYCLE, 12, Access::readWrite, 0x124},
+	{REG_VOFFSET, 12, Access::readWrite, 0xc},
+	{REG_VSIZE, 12, Access::readWrite, 0x110},
+	{REG_VSYNC0, 10, Access::readWrite, 0x0},
+	{REG_VSYNC1, 10, Access::readWrite, 0xa},
+	{REG_DLSWAP, 2, Access::readWrite, 0x0},
+	{REG_ROTATE, 3, Access::readWrite, 0x0},
+	{REG_OUTBITS, 9, Access::readWrite, 0x1b6},
+	{REG_DITHER, 1, Access::readWrite, 0x1},
+	{REG_SWIZZLE, 4, Access::readWrite, 0x0},
+	{REG_CSPREAD, 1, Access::readWrite, 0x1},
+	{REG_PCLK_POL, 1, Access::readWrite, 0x0},
+	{REG_PCLK, 8, Access::readWrite, 0x0},
+	{REG_TAG_X, 11, Access::readWrite, 0x0},
+	{REG_TAG_Y, 11, Access::readWrite, 0x0},
+	{REG_TAG, 8, Access::read, 0x0},
+	{REG_VOL_PB, 8, Access::readWrite, 0xff},
+	{REG_VOL_SOUND, 8, Access::readWrite, 0xff},
+	{REG_SOUND, 16, Access::readWrite, 0x0},
+	{REG_PLAY, 1, Access::readWrite, 0x0},
+	{REG_GPIO_DIR, 8, Access::readWrite, 0x80},
+	{REG_GPIO, 8, Access::readWrite, 0x0},
+	{REG_GPIOX_DIR, 16, Access::readWrite, 0x8000},
+	{REG_GPIOX, 16, Access::readWrite, 0x8000},
+	{REG_INT_FLAGS, 8, Access::read, 0x0},
+	{REG_INT_EN, 1, Access::readWrite, 0x0},
+	{REG_INT_MASK, 8, Access::readWrite, 0xff},
+	{REG_PLAYBACK_START, 20, Access::readWrite, 0x0},
+	{REG_PLAYBACK_LENGTH, 20, Access::readWrite, 0x0},
+	{REG_PLAYBACK_READPTR, 20, Access::read, 0x0},
+	{REG_PLAYBACK_FREQ, 16, Access::readWrite, 0x1f40},
+	{REG_PLAYBACK_FORMAT, 2, Access::readWrite, 0x0},
+	{REG_PLAYBACK_LOOP, 1, Access::readWrite, 0x0},
+	{REG_PLAYBACK_PLAY, 1, Access::readWrite, 0x0},
+	{REG_PWM_HZ, 14, Access::readWrite, 0xfa},
+	{REG_PWM_DUTY, 8, Access::readWrite, 0x80},
+	{REG_MACRO_0, 32, Access::readWrite, 0x0},
+	{REG_MACRO_1, 32, Access::readWrite, 0x0},
+	{REG_CMD_READ, 12, Access::readWrite, 0x0},
+	{REG_CMD_WRITE, 12, Access::readWrite, 0x0},
+	{REG_CMD_DL, 13, Access::readWrite, 0x0},
+	{REG_TOUCH_MODE, 2, Access::readWrite, 0x3},
+	{REG_TOUCH_ADC_MODE, 1, Access::readWrite, 0x1},
+	{REG_TOUCH_CHARGE, 16, Access::readWrite, 0x1770},
+	{REG_TOUCH_SETTLE, 4, Access::readWrite, 0x3},
+	{REG_TOUCH_OVERSAMPLE, 4, Access::readWrite, 0x7},
+	{REG_TOUCH_RZTHRESH, 16, Access::readWrite, 0xffff},
+	{REG_TOUCH_RAW_XY, 32, Access::read, 0xffffffff},
+	{REG_TOUCH_RZ, 16, Access::read, 0x7fff},
+	{REG_TOUCH_SCREEN_XY, 32, Access::read, 0x80008000},
+	{REG_TOUCH_TAG_XY, 32, Access::read, 0x0},
+	{REG_TOUCH_TAG, 8, Access::read, 0x0},
+	{REG_TOUCH_TAG1_XY, 32, Access::read, 0x0},
+	{REG_TOUCH_TAG1, 8, Access::read, 0x0},
+	{REG_TOUCH_TAG2_XY, 32, Access::read, 0x0},
+	{REG_TOUCH_TAG2, 8, Access::read, 0x0},
+	{REG_TOUCH_TAG3_XY, 32, Access::read, 0x0},
+	{REG_TOUCH_TAG3, 8, Access::read, 0x0},
+	{REG_TOUCH_TAG4_XY, 32, Access::read, 0x0},
+	{REG_TOUCH_TAG4, 8, Access::read, 0x0},
+	{REG_TOUCH_TRANSFORM_A, 32, Access::readWrite, 0x10000},
+	{REG_TOUCH_TRANSFORM_B, 32, Access::readWrite, 0x0},
+	{REG_TOUCH_TRANSFORM_C, 32, Access::readWrite, 0x0},
+	{REG_TOUCH_TRANSFORM_D, 32, Access::readWrite, 0x0},
+	{REG_TOUCH_TRANSFORM_E, 32, Access::readWrite, 0x10000},
+	{REG_TOUCH_TRANSFORM_F, 32, Access::readWrite, 0x0},
+	{REG_TOUCH_CONFIG, 16, Access::readWrite, 0x8381},
+	{REG_CTOUCH_TOUCH4_X, 16, Access::read, 0x8000},
+	{REG_BIST_EN, 1, Access::readWrite, 0x0},
+	{REG_TRIM, 5, Access::readWrite, 0x0},
+	{REG_ANA_COMP, 8, Access::readWrite, 0x0},
+	{REG_SPI_WIDTH, 3, Access::readWrite, 0x0},
+	{REG_TOUCH_DIRECT_XY, 32, Access::read, 0x0},
+	{REG_TOUCH_DIRECT_Z1Z2, 32, Access::read, 0x0},
+	{REG_DATESTAMP0, 32, Access::read, 0x0},
+	{REG_DATESTAMP1, 32, Access::read, 0x0},
+	{REG_DATESTAMP2, 32, Access::read, 0x0},
+	{REG_DATESTAMP3, 32, Access::read, 0x0},
+	{REG_CMDB_SPACE, 12, Access::readWrite, 0xffc},
+	{REG_CMDB_WRITE, 32, Access::write, 0x0},
+	{REG_TRACKER, 32, Access::read, 0x0},
+	{REG_TRACKER_1, 32, Access::read, 0x0},
+	{REG_TRACKER_2, 32, Access::read, 0x0},
+	{REG_TRACKER_3, 32, Access::read, 0x0},
+	{REG_TRACKER_4, 32, Access::read, 0x0},
+	{REG_MEDIAFIFO_READ, 32, Access::readWrite, 0x0},
+	{REG_MEDIAFIFO_WRITE, 32, Access::readWrite, 0x0},
+};
+
+constexpr const Descriptor* find(Register reg)
+{
+	for(auto& d : descriptors) {
+		if(d.address == reg) {
+			return &d;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Check that registers form a contiguous run, as required for a burst transfer
+ */
+constexpr bool isContiguous(const Register* regs, unsigned count)
+{
+	for(unsigned i = 1; i < count; ++i) {
+		if(regs[i] != regs[i - 1] + 4) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <Register reg> struct Traits {
+	static_assert(find(reg) != nullptr, "Unknown register");
+	static constexpr Descriptor descriptor = *find(reg);
+	using Value = std::conditional_t<descriptor.size() == 1, uint8_t,
+									 std::conditional_t<descriptor.size() == 2, uint16_t, uint32_t>>;
+};
+
+} // namespace Graphics::EVE::Registers
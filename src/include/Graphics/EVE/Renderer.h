@@ -0,0 +1,210 @@
+#pragma once
+
+#include "EVE.h"
+#include <Print.h>
+#include <vector>
+
+namespace Graphics::EVE
+{
+class Emulator;
+
+/**
+ * @brief Software display list rasteriser for Host builds
+ *
+ * Executes a display list into colour, stencil and tag buffers following the EVE rendering model:
+ *
+ * - Primitives: BITMAPS, POINTS, LINES, LINE_STRIP, EDGE_STRIP_R/L/A/B and RECTS with VERTEX2F / VERTEX2II
+ * - Bitmaps in all FT81x formats with transform matrix, cells, palettes, NEAREST / BILINEAR and BORDER / REPEAT
+ * - Alpha test, stencil test and operations, blending, colour mask, scissor and tag buffer
+ * - Graphics context stack, CALL / RETURN / JUMP and MACRO
+ *
+ * Points, lines and rectangles are anti-aliased using analytic pixel coverage, so edges are close to,
+ * but not bit-identical with, hardware output. ROM fonts and the TEXT8X8 / TEXTVGA formats need glyph
+ * data which is not modelled so render as transparent.
+ *
+ * Alongside the image, each frame produces a cost report: pixels generated per primitive and per line.
+ * The EVE renders each line within a fixed budget of system clocks; lines which exceed `lineBudget`
+ * fragments are at risk of visible corruption on hardware. CLEAR is excluded from line cost.
+ */
+class Renderer
+{
+public:
+	struct Config {
+		uint16_t width{800};
+		uint16_t height{480};
+		/// Fragments per line. Default is REG_HCYCLE (928) * REG_PCLK (2), i.e. one per system clock, which is conservative
+		uint32_t lineBudget{1856};
+	};
+
+	/**
+	 * @brief Cost of one BEGIN ... END sequence, or CLEAR
+	 */
+	struct PrimitiveCost {
+		uint16_t index;	///< Display list word offset
+		uint8_t primitive; ///< GraphicsPrimitive, 0 for CLEAR
+		uint16_t vertices;
+		uint32_t pixels; ///< Fragments generated after scissoring
+	};
+
+	struct FrameCost {
+		uint32_t commands;	 ///< Display list words executed
+		uint32_t pixels;	   ///< Total fragments generated
+		uint32_t maxLineCost;  ///< Highest per-line fragment count
+		uint16_t linesOverBudget;
+		std::vector<PrimitiveCost> primitives;
+		std::vector<uint32_t> lineCost;
+	};
+
+	Renderer(const Config& config);
+
+	Renderer() : Renderer(Config{})
+	{
+	}
+
+	/**
+	 * @brief Render a display list
+	 * @param displayList Up to 2048 words, terminated by DISPLAY
+	 * @param memory EVE address space, used for bitmaps, palettes and macro registers
+	 */
+	void render(const uint32_t* displayList, const uint8_t* memory);
+
+	/**
+	 * @brief Render the active display list from an emulator
+	 */
+	void render(const Emulator& emulator);
+
+	/**
+	 * @brief Get colour buffer, 0xAARRGGBB per pixel
+	 */
+	const uint32_t* getColorBuffer() const
+	{
+		return color.data();
+	}
+
+	uint32_t getPixel(uint16_t x, uint16_t y) const
+	{
+		return color[y * config.width + x] & 0xffffff;
+	}
+
+	uint8_t getTag(uint16_t x, uint16_t y) const
+	{
+		return tag[y * config.width + x];
+	}
+
+	uint8_t getStencil(uint16_t x, uint16_t y) const
+	{
+		return stencil[y * config.width + x];
+	}
+
+	const FrameCost& getCost() const
+	{
+		return cost;
+	}
+
+	/**
+	 * @brief Write colour buffer as PNG image
+	 */
+	bool writePng(Print& out) const;
+
+	/**
+	 * @brief Write cost report as a JSON object
+	 */
+	size_t printCost(Print& p) const;
+
+private:
+	struct BitmapHandle {
+		uint32_t source;
+		uint16_t stride;
+		uint16_t layoutHeight;
+		uint16_t width;
+		uint16_t height;
+		uint8_t format;
+		bool bilinear;
+		bool repeatX;
+		bool repeatY;
+	};
+
+	struct Context {
+		uint32_t color{0xffffffff};
+		uint32_t clearColor{0};
+		uint8_t clearStencil{0};
+		uint8_t clearTag{0};
+		uint8_t tag{0};
+		bool tagMask{true};
+		TestFunction alphaFunc{TestFunction::ALWAYS};
+		uint8_t alphaRef{0};
+		TestFunction stencilFunc{TestFunction::ALWAYS};
+		uint8_t stencilRef{0};
+		uint8_t stencilFuncMask{0xff};
+		uint8_t stencilMask{0xff};
+		StencilOp stencilFail{StencilOp::KEEP};
+		StencilOp stencilPass{StencilOp::KEEP};
+		BlendFunction blendSrc{BlendFunction::SRC_ALPHA};
+		BlendFunction blendDst{BlendFunction::ONE_MINUS_SRC_ALPHA};
+		uint8_t colorMask{0x0f};
+		uint16_t pointSize{16};
+		uint16_t lineWidth{16};
+		uint8_t handle{0};
+		uint8_t cell{0};
+		uint16_t scissorX{0};
+		uint16_t scissorY{0};
+		uint16_t scissorWidth{2048};
+		uint16_t scissorHeight{2048};
+		uint8_t vertexFormat{4};
+		int32_t translateX{0};
+		int32_t translateY{0};
+		int32_t transform[6]{256, 0, 0, 0, 256, 0};
+		uint32_t paletteSource{0};
+	};
+
+	struct Vertex {
+		float x;
+		float y;
+		uint8_t handle;
+		uint8_t cell;
+	};
+
+	struct Clip {
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+	};
+
+	void reset();
+	bool execute(uint32_t word);
+	void vertex(const Vertex& v);
+	void beginCost(uint8_t primitive);
+	void clear(bool color, bool stencil, bool tag);
+	Clip getClip() const;
+	void fragment(int x, int y, uint32_t texel, float coverage);
+	void drawPoint(const Vertex& v);
+	void drawLine(const Vertex& v0, const Vertex& v1);
+	void drawRect(const Vertex& v0, const Vertex& v1);
+	void drawEdge(const Vertex& v0, const Vertex& v1);
+	void drawBitmap(const Vertex& v);
+	uint32_t fetchTexel(const BitmapHandle& bmp, uint32_t base, int u, int v) const;
+	uint32_t sampleBitmap(const BitmapHandle& bmp, uint32_t base, float u, float v) const;
+	uint8_t read8(uint32_t address) const;
+	uint16_t read16(uint32_t address) const;
+	uint32_t read32(uint32_t address) const;
+
+	Config config;
+	std::vector<uint32_t> color;
+	std::vector<uint8_t> stencil;
+	std::vector<uint8_t> tag;
+	FrameCost cost;
+	const uint8_t* memory{nullptr};
+	Context ctx;
+	Context contextStack[4];
+	uint8_t contextDepth{0};
+	BitmapHandle handles[32];
+	GraphicsPrimitive primitive{GP_BITMAPS};
+	bool inPrimitive{false};
+	Vertex lastVertex{};
+	unsigned vertexCount{0};
+	uint16_t pc{0};
+	int currentCost{-1}; ///< Index into cost.primitives
+};
+
+} // namespace Graphics::EVE
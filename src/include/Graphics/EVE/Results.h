@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Display.h"
+#include "DeferredTask.h"
+#include <Delegate.h>
+#include <SimpleTimer.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Retrieve co-processor command results without blocking
+ *
+ * Commands such as CMD_GETPTR and CMD_MEMCRC return values by overwriting their own parameters
+ * in the FIFO. Waiting for each one to complete stalls the host, so instead the command is sent,
+ * its FIFO position noted and a callback invoked once the result is available.
+ *
+ * Progress is checked from a timer with one asynchronous read of REG_CMD_READ and REG_CMD_WRITE.
+ * When the co-processor has passed one or more commands their results are fetched together with
+ * a single read covering all of them. Results are abandoned, and reported as failed, if the
+ * application sends enough further commands to overwrite them before they can be read, or if the
+ * co-processor faults.
+ *
+ * The FIFO position is tracked by `EveDisplay::sendCommands()` and `EveDisplay::writeCommands()`,
+ * so commands must not be written to REG_CMDB_WRITE by any other means.
+ */
+class ResultQueue
+{
+public:
+	static constexpr unsigned maxValues{6};
+
+	struct Result {
+		bool success;
+		uint8_t count;				///< Number of values
+		uint32_t values[maxValues]; ///< Result words, in parameter order
+	};
+
+	using Callback = Delegate<void(const Result& result)>;
+
+	/**
+	 * @brief Create a queue
+	 * @param display
+	 * @param maxPending Number of commands which may be awaiting results
+	 * @param bufferSize Maximum bytes fetched by one read, multiple of 4
+	 */
+	ResultQueue(EveDisplay& display, uint8_t maxPending = 8, uint16_t bufferSize = 256)
+		: display(display), pending(new Pending[maxPending]), buffer(new uint32_t[bufferSize / 4]),
+		  maxPending(maxPending), bufferSize(bufferSize)
+	{
+	}
+
+	~ResultQueue()
+	{
+		cancel();
+	}
+
+	/**
+	 * @brief Get end address of data written by the last CMD_INFLATE or CMD_LOADIMAGE
+	 */
+	bool getPtr(Callback callback)
+	{
+		return submit(CMD_GETPTR, nullptr, 0, 1, callback);
+	}
+
+	/**
+	 * @brief Get source address, width and height of the last CMD_LOADIMAGE
+	 */
+	bool getProps(Callback callback)
+	{
+		return submit(CMD_GETPROPS, nullptr, 0, 3, callback);
+	}
+
+	/**
+	 * @brief Calculate CRC32 of a block of memory
+	 */
+	bool memCrc(uint32_t ptr, uint32_t num, Callback callback)
+	{
+		const uint32_t params[]{ptr, num};
+		return submit(CMD_MEMCRC, params, 2, 1, callback);
+	}
+
+	/**
+	 * @brief Read a register at the point the co-processor reaches this command
+	 */
+	bool regRead(uint32_t address, Callback callback)
+	{
+		return submit(CMD_REGREAD, &address, 1, 1, callback);
+	}
+
+	/**
+	 * @brief Get the current bitmap transform matrix coefficients A-F
+	 */
+	bool getMatrix(Callback callback)
+	{
+		return submit(CMD_GETMATRIX, nullptr, 0, 6, callback);
+	}
+
+	/**
+	 * @brief Send a command whose trailing parameters are replaced by results
+	 * @param cmd
+	 * @param params Input parameters
+	 * @param paramCount Number of input parameters
+	 * @param resultCount Number of result words following the input parameters
+	 * @param callback Invoked in task context with the result
+	 * @retval bool false if the queue is full or the command could not be sent
+	 */
+	bool submit(CoproCommand cmd, const uint32_t* params, unsigned paramCount, unsigned resultCount,
+				Callback callback);
+
+	/**
+	 * @brief Number of commands awaiting results
+	 */
+	uint8_t getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * @brief Abandon all pending commands. Callbacks are not invoked.
+	 */
+	void cancel();
+
+private:
+	enum class State {
+		idle,
+		polling, ///< Reading FIFO pointers
+		reading, ///< Fetching results
+	};
+
+	struct Pending {
+		uint32_t end; ///< FIFO position following the command
+		uint8_t count;
+		Callback callback;
+	};
+
+	Pending& at(unsigned index)
+	{
+		return pending[(head + index) % maxPending];
+	}
+
+	void poll();
+	void startRead(uint16_t readPtr, uint16_t writePtr);
+	static bool requestComplete(HSPI::Request& request);
+	void process();
+	void fail(unsigned n);
+	void pop(bool success, const uint32_t* values);
+
+	EveDisplay& display;
+	SimpleTimer timer;
+	DeferredTask task{[](void* param) { static_cast<ResultQueue*>(param)->process(); }, this};
+	HSPI::Request request;
+	HSPI::Request request2; ///< Second part of a read which wraps around the end of RAM_CMD
+	std::unique_ptr<Pending[]> pending;
+	std::unique_ptr<uint32_t[]> buffer;
+	uint32_t fifoRegs[2]; ///< REG_CMD_READ, REG_CMD_WRITE
+	uint32_t pollPosition{0}; ///< FIFO position when pointers were read
+	uint32_t readStart{0};	///< FIFO position of the first word in buffer
+	uint32_t faults{0};
+	State state{State::idle};
+	uint8_t maxPending;
+	uint16_t bufferSize;
+	uint8_t head{0};
+	uint8_t count{0};
+	uint8_t reading{0}; ///< Number of commands being fetched
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,432 @@
+/****
+ * Schema.h
+ *
+ * Command definitions for Decoder, generated from eve.py. Do not edit.
+ *
+ *   python3 tools/gen.py --schema > src/include/Graphics/EVE/Schema.h
+ *
+ ****/
+
+#pragma once
+
+#include <cstdint>
+
+namespace Graphics::EVE::Schema
+{
+enum class Type : uint8_t {
+	value,
+	address,   ///< Memory address, checked against the memory map
+	length,    ///< Size of memory block at preceding address(es)
+	color,     ///< 24-bit RGB value
+	cstring,   ///< NUL-terminated string, padded to 4-byte boundary
+	dataBlock, ///< Variable-length data, padded to 4-byte boundary
+};
+
+constexpr uint8_t flagSigned{0x01};
+constexpr uint8_t flagAligned{0x02}; ///< Value must be a multiple of 4
+
+struct Param {
+	const char* name;
+	uint8_t offset;   ///< Bit position for display list commands, byte offset for co-processor commands
+	uint8_t bitcount; ///< Value width, 0 for variable-length types
+	Type type;
+	uint8_t flags;
+	int8_t lengthParam; ///< For dataBlock, index of parameter giving length or -1 if determined by content
+};
+
+struct Command {
+	const char* name;
+	uint8_t code;
+	uint8_t size; ///< Size in bytes excluding any variable-length payload
+	uint8_t paramCount;
+	const Param* params;
+};
+
+inline constexpr Param displayListParams[]{
+	{"addr", 0, 22, Type::address, 0, -1},
+	{"green", 0, 8, Type::value, 0, -1},
+	{"blue", 8, 8, Type::value, 0, -1},
+	{"red", 16, 8, Type::value, 0, -1},
+	{"tag", 0, 8, Type::value, 0, -1},
+	{"green", 0, 8, Type::value, 0, -1},
+	{"blue", 8, 8, Type::value, 0, -1},
+	{"red", 16, 8, Type::value, 0, -1},
+	{"handle", 0, 5, Type::value, 0, -1},
+	{"cell", 0, 7, Type::value, 0, -1},
+	{"height", 0, 9, Type::value, 0, -1},
+	{"linestride", 9, 10, Type::value, 0, -1},
+	{"format", 19, 5, Type::value, 0, -1},
+	{"height", 0, 9, Type::value, 0, -1},
+	{"width", 9, 9, Type::value, 0, -1},
+	{"wrapy", 18, 1, Type::value, 0, -1},
+	{"wrapx", 19, 1, Type::value, 0, -1},
+	{"filter", 20, 1, Type::value, 0, -1},
+	{"ref", 0, 8, Type::value, 0, -1},
+	{"func", 8, 4, Type::value, 0, -1},
+	{"mask", 0, 8, Type::value, 0, -1},
+	{"ref", 8, 8, Type::value, 0, -1},
+	{"func", 16, 4, Type::value, 0, -1},
+	{"dst", 0, 3, Type::value, 0, -1},
+	{"src", 3, 3, Type::value, 0, -1},
+	{"spass", 0, 3, Type::value, 0, -1},
+	{"sfail", 3, 3, Type::value, 0, -1},
+	{"size", 0, 13, Type::value, 0, -1},
+	{"width", 0, 12, Type::value, 0, -1},
+	{"alpha", 0, 8, Type::value, 0, -1},
+	{"alpha", 0, 8, Type::value, 0, -1},
+	{"s", 0, 8, Type::value, 0, -1},
+	{"tag", 0, 8, Type::value, 0, -1},
+	{"mask", 0, 8, Type::value, 0, -1},
+	{"mask", 0, 1, Type::value, 0, -1},
+	{"a", 0, 17, Type::value, flagSigned, -1},
+	{"b", 0, 17, Type::value, flagSigned, -1},
+	{"c", 0, 24, Type::value, flagSigned, -1},
+	{"d", 0, 17, Type::value, flagSigned, -1},
+	{"e", 0, 17, Type::value, flagSigned, -1},
+	{"f", 0, 24, Type::value, flagSigned, -1},
+	{"y", 0, 11, Type::value, 0, -1},
+	{"x", 11, 11, Type::value, 0, -1},
+	{"height", 0, 12, Type::value, 0, -1},
+	{"width", 12, 12, Type::value, 0, -1},
+	{"dest", 0, 16, Type::value, 0, -1},
+	{"dest", 0, 16, Type::value, 0, -1},
+	{"prim", 0, 4, Type::value, 0, -1},
+	{"a", 0, 1, Type::value, 0, -1},
+	{"b", 1, 1, Type::value, 0, -1},
+	{"g", 2, 1, Type::value, 0, -1},
+	{"r", 3, 1, Type::value, 0, -1},
+	{"m", 0, 1, Type::value, 0, -1},
+	{"t", 0, 1, Type::value, 0, -1},
+	{"s", 1, 1, Type::value, 0, -1},
+	{"c", 2, 1, Type::value, 0, -1},
+	{"frac", 0, 3, Type::value, 0, -1},
+	{"height", 0, 2, Type::value, 0, -1},
+	{"linestride", 2, 2, Type::value, 0, -1},
+	{"height", 0, 2, Type::value, 0, -1},
+	{"width", 2, 2, Type::value, 0, -1},
+	{"addr", 0, 22, Type::address, 0, -1},
+	{"x", 0, 17, Type::value, flagSigned, -1},
+	{"y", 0, 17, Type::value, flagSigned, -1},
+	{"y", 0, 15, Type::value, flagSigned, -1},
+	{"x", 15, 15, Type::value, flagSigned, -1},
+	{"cell", 0, 7, Type::value, 0, -1},
+	{"handle", 7, 5, Type::value, 0, -1},
+	{"y", 12, 9, Type::value, 0, -1},
+	{"x", 21, 9, Type::value, 0, -1},
+};
+
+inline constexpr Command displayListCommands[]{
+	{"DISPLAY", 0x00, 4, 0, nullptr},
+	{"BITMAP_SOURCE", 0x01, 4, 1, &displayListParams[0]},
+	{"CLEAR_COLOR_RGB", 0x02, 4, 3, &displayListParams[1]},
+	{"TAG", 0x03, 4, 1, &displayListParams[4]},
+	{"COLOR_RGB", 0x04, 4, 3, &displayListParams[5]},
+	{"BITMAP_HANDLE", 0x05, 4, 1, &displayListParams[8]},
+	{"CELL", 0x06, 4, 1, &displayListParams[9]},
+	{"BITMAP_LAYOUT", 0x07, 4, 3, &displayListParams[10]},
+	{"BITMAP_SIZE", 0x08, 4, 5, &displayListParams[13]},
+	{"ALPHA_FUNC", 0x09, 4, 2, &displayListParams[18]},
+	{"STENCIL_FUNC", 0x0a, 4, 3, &displayListParams[20]},
+	{"BLEND_FUNC", 0x0b, 4, 2, &displayListParams[23]},
+	{"STENCIL_OP", 0x0c, 4, 2, &displayListParams[25]},
+	{"POINT_SIZE", 0x0d, 4, 1, &displayListParams[27]},
+	{"LINE_WIDTH", 0x0e, 4, 1, &displayListParams[28]},
+	{"CLEAR_COLOR_A", 0x0f, 4, 1, &displayListParams[29]},
+	{"COLOR_A", 0x10, 4, 1, &displayListParams[30]},
+	{"CLEAR_STENCIL", 0x11, 4, 1, &displayListParams[31]},
+	{"CLEAR_TAG", 0x12, 4, 1, &displayListParams[32]},
+	{"STENCIL_MASK", 0x13, 4, 1, &displayListParams[33]},
+	{"TAG_MASK", 0x14, 4, 1, &displayListParams[34]},
+	{"BITMAP_TRANSFORM_A", 0x15, 4, 1, &displayListParams[35]},
+	{"BITMAP_TRANSFORM_B", 0x16, 4, 1, &displayListParams[36]},
+	{"BITMAP_TRANSFORM_C", 0x17, 4, 1, &displayListParams[37]},
+	{"BITMAP_TRANSFORM_D", 0x18, 4, 1, &displayListParams[38]},
+	{"BITMAP_TRANSFORM_E", 0x19, 4, 1, &displayListParams[39]},
+	{"BITMAP_TRANSFORM_F", 0x1a, 4, 1, &displayListParams[40]},
+	{"SCISSOR_XY", 0x1b, 4, 2, &displayListParams[41]},
+	{"SCISSOR_SIZE", 0x1c, 4, 2, &displayListParams[43]},
+	{"CALL", 0x1d, 4, 1, &displayListParams[45]},
+	{"JUMP", 0x1e, 4, 1, &displayListParams[46]},
+	{"BEGIN", 0x1f, 4, 1, &displayListParams[47]},
+	{"COLOR_MASK", 0x20, 4, 4, &displayListParams[48]},
+	{"END", 0x21, 4, 0, nullptr},
+	{"SAVE_CONTEXT", 0x22, 4, 0, nullptr},
+	{"RESTORE_CONTEXT", 0x23, 4, 0, nullptr},
+	{"RETURN", 0x24, 4, 0, nullptr},
+	{"MACRO", 0x25, 4, 1, &displayListParams[52]},
+	{"CLEAR", 0x26, 4, 3, &displayListParams[53]},
+	{"VERTEX_FORMAT", 0x27, 4, 1, &displayListParams[56]},
+	{"BITMAP_LAYOUT_H", 0x28, 4, 2, &displayListParams[57]},
+	{"BITMAP_SIZE_H", 0x29, 4, 2, &displayListParams[59]},
+	{"PALETTE_SOURCE", 0x2a, 4, 1, &displayListParams[61]},
+	{"VERTEX_TRANSLATE_X", 0x2b, 4, 1, &displayListParams[62]},
+	{"VERTEX_TRANSLATE_Y", 0x2c, 4, 1, &displayListParams[63]},
+	{"NOP", 0x2d, 4, 0, nullptr},
+	{"VERTEX2F", 0x40, 4, 2, &displayListParams[64]},
+	{"VERTEX2II", 0x80, 4, 4, &displayListParams[66]},
+};
+
+inline constexpr Param coprocessorParams[]{
+	{"ms", 4, 32, Type::value, 0, -1},
+	{"color", 4, 32, Type::color, 0, -1},
+	{"color", 4, 32, Type::color, 0, -1},
+	{"x0", 4, 16, Type::value, flagSigned, -1},
+	{"y0", 6, 16, Type::value, flagSigned, -1},
+	{"rgb0", 8, 32, Type::color, 0, -1},
+	{"x1", 12, 16, Type::value, flagSigned, -1},
+	{"y1", 14, 16, Type::value, flagSigned, -1},
+	{"rgb1", 16, 32, Type::color, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"font", 8, 16, Type::value, 0, -1},
+	{"options", 10, 16, Type::value, 0, -1},
+	{"s", 12, 0, Type::cstring, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"h", 10, 16, Type::value, 0, -1},
+	{"font", 12, 16, Type::value, 0, -1},
+	{"options", 14, 16, Type::value, 0, -1},
+	{"s", 16, 0, Type::cstring, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"h", 10, 16, Type::value, 0, -1},
+	{"font", 12, 16, Type::value, 0, -1},
+	{"options", 14, 16, Type::value, 0, -1},
+	{"s", 16, 0, Type::cstring, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"h", 10, 16, Type::value, 0, -1},
+	{"options", 12, 16, Type::value, 0, -1},
+	{"value", 14, 16, Type::value, 0, -1},
+	{"range", 16, 16, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"h", 10, 16, Type::value, 0, -1},
+	{"options", 12, 16, Type::value, 0, -1},
+	{"value", 14, 16, Type::value, 0, -1},
+	{"range", 16, 16, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"h", 10, 16, Type::value, 0, -1},
+	{"options", 12, 16, Type::value, 0, -1},
+	{"value", 14, 16, Type::value, 0, -1},
+	{"size", 16, 16, Type::value, 0, -1},
+	{"range", 18, 16, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"font", 10, 16, Type::value, 0, -1},
+	{"options", 12, 16, Type::value, 0, -1},
+	{"state", 14, 16, Type::value, 0, -1},
+	{"s", 16, 0, Type::cstring, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"r", 8, 16, Type::value, 0, -1},
+	{"options", 10, 16, Type::value, 0, -1},
+	{"major", 12, 16, Type::value, 0, -1},
+	{"minor", 14, 16, Type::value, 0, -1},
+	{"value", 16, 16, Type::value, 0, -1},
+	{"range", 18, 16, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"r", 8, 16, Type::value, 0, -1},
+	{"options", 10, 16, Type::value, 0, -1},
+	{"h", 12, 16, Type::value, 0, -1},
+	{"m", 14, 16, Type::value, 0, -1},
+	{"s", 16, 16, Type::value, 0, -1},
+	{"ms", 18, 16, Type::value, 0, -1},
+	{"result", 4, 32, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"style", 8, 16, Type::value, 0, -1},
+	{"scale", 10, 16, Type::value, 0, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"num", 8, 32, Type::length, 0, -1},
+	{"result", 12, 32, Type::value, 0, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"result", 8, 32, Type::value, 0, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"num", 8, 32, Type::length, 0, -1},
+	{"data", 12, 0, Type::dataBlock, 0, 1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"value", 8, 16, Type::value, 0, -1},
+	{"num", 12, 32, Type::length, 0, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"num", 8, 32, Type::length, 0, -1},
+	{"dest", 4, 32, Type::address, 0, -1},
+	{"src", 8, 32, Type::address, 0, -1},
+	{"num", 12, 32, Type::length, 0, -1},
+	{"ptr", 4, 32, Type::address, flagAligned, -1},
+	{"num", 8, 32, Type::length, flagAligned, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"data", 8, 0, Type::dataBlock, 0, -1},
+	{"result", 4, 32, Type::value, flagSigned, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"options", 8, 16, Type::value, 0, -1},
+	{"ptr", 4, 32, Type::address, 0, -1},
+	{"width", 8, 32, Type::value, 0, -1},
+	{"height", 12, 32, Type::value, 0, -1},
+	{"tx", 4, 32, Type::value, flagSigned, -1},
+	{"ty", 8, 32, Type::value, flagSigned, -1},
+	{"sx", 4, 32, Type::value, flagSigned, -1},
+	{"sy", 8, 32, Type::value, flagSigned, -1},
+	{"a", 4, 32, Type::value, flagSigned, -1},
+	{"font", 4, 16, Type::value, 0, -1},
+	{"ptr", 8, 32, Type::address, flagAligned, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"w", 8, 16, Type::value, 0, -1},
+	{"h", 10, 16, Type::value, 0, -1},
+	{"tag", 12, 16, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"r", 8, 16, Type::value, 0, -1},
+	{"options", 10, 16, Type::value, 0, -1},
+	{"value", 12, 16, Type::value, 0, -1},
+	{"x", 4, 16, Type::value, flagSigned, -1},
+	{"y", 6, 16, Type::value, flagSigned, -1},
+	{"font", 8, 16, Type::value, 0, -1},
+	{"options", 10, 16, Type::value, 0, -1},
+	{"n", 12, 32, Type::value, flagSigned, -1},
+	{"a", 4, 32, Type::value, flagSigned, -1},
+	{"b", 8, 32, Type::value, flagSigned, -1},
+	{"c", 12, 32, Type::value, flagSigned, -1},
+	{"d", 16, 32, Type::value, flagSigned, -1},
+	{"e", 20, 32, Type::value, flagSigned, -1},
+	{"f", 24, 32, Type::value, flagSigned, -1},
+	{"color", 4, 32, Type::color, 0, -1},
+	{"r", 4, 16, Type::value, 0, -1},
+	{"fmt", 4, 16, Type::value, 0, -1},
+	{"ptr", 8, 32, Type::address, 0, -1},
+	{"x", 12, 16, Type::value, flagSigned, -1},
+	{"y", 14, 16, Type::value, flagSigned, -1},
+	{"w", 16, 16, Type::value, 0, -1},
+	{"h", 18, 16, Type::value, 0, -1},
+	{"b", 4, 16, Type::value, 0, -1},
+	{"ptr", 4, 32, Type::address, flagAligned, -1},
+	{"size", 8, 32, Type::length, flagAligned, -1},
+	{"options", 4, 16, Type::value, 0, -1},
+	{"font", 4, 16, Type::value, 0, -1},
+	{"ptr", 8, 32, Type::address, flagAligned, -1},
+	{"firstchar", 12, 16, Type::value, 0, -1},
+	{"handle", 4, 16, Type::value, 0, -1},
+	{"font", 4, 32, Type::value, 0, -1},
+	{"romslot", 8, 16, Type::value, 0, -1},
+	{"dst", 4, 32, Type::address, 0, -1},
+	{"ptr", 8, 32, Type::address, 0, -1},
+	{"source", 4, 32, Type::address, 0, -1},
+	{"fmt", 8, 16, Type::value, 0, -1},
+	{"width", 10, 16, Type::value, 0, -1},
+	{"height", 12, 16, Type::value, 0, -1},
+};
+
+inline constexpr Command coprocessorCommands[]{
+	{"DLSTART", 0x00, 4, 0, nullptr},
+	{"SWAP", 0x01, 4, 0, nullptr},
+	{"INTERRUPT", 0x02, 8, 1, &coprocessorParams[0]},
+	{"BGCOLOR", 0x09, 8, 1, &coprocessorParams[1]},
+	{"FGCOLOR", 0x0a, 8, 1, &coprocessorParams[2]},
+	{"GRADIENT", 0x0b, 20, 6, &coprocessorParams[3]},
+	{"TEXT", 0x0c, 12, 5, &coprocessorParams[9]},
+	{"BUTTON", 0x0d, 16, 7, &coprocessorParams[14]},
+	{"KEYS", 0x0e, 16, 7, &coprocessorParams[21]},
+	{"PROGRESS", 0x0f, 20, 7, &coprocessorParams[28]},
+	{"SLIDER", 0x10, 20, 7, &coprocessorParams[35]},
+	{"SCROLLBAR", 0x11, 20, 8, &coprocessorParams[42]},
+	{"TOGGLE", 0x12, 16, 7, &coprocessorParams[50]},
+	{"GAUGE", 0x13, 20, 8, &coprocessorParams[57]},
+	{"CLOCK", 0x14, 20, 8, &coprocessorParams[65]},
+	{"CALIBRATE", 0x15, 8, 1, &coprocessorParams[73]},
+	{"SPINNER", 0x16, 12, 4, &coprocessorParams[74]},
+	{"STOP", 0x17, 4, 0, nullptr},
+	{"MEMCRC", 0x18, 16, 3, &coprocessorParams[78]},
+	{"REGREAD", 0x19, 12, 2, &coprocessorParams[81]},
+	{"MEMWRITE", 0x1a, 12, 3, &coprocessorParams[83]},
+	{"MEMSET", 0x1b, 16, 3, &coprocessorParams[86]},
+	{"MEMZERO", 0x1c, 12, 2, &coprocessorParams[89]},
+	{"MEMCPY", 0x1d, 16, 3, &coprocessorParams[91]},
+	{"APPEND", 0x1e, 12, 2, &coprocessorParams[94]},
+	{"SNAPSHOT", 0x1f, 8, 1, &coprocessorParams[96]},
+	{"INFLATE", 0x22, 8, 2, &coprocessorParams[97]},
+	{"GETPTR", 0x23, 8, 1, &coprocessorParams[99]},
+	{"LOADIMAGE", 0x24, 12, 2, &coprocessorParams[100]},
+	{"GETPROPS", 0x25, 16, 3, &coprocessorParams[102]},
+	{"LOADIDENTITY", 0x26, 4, 0, nullptr},
+	{"TRANSLATE", 0x27, 12, 2, &coprocessorParams[105]},
+	{"SCALE", 0x28, 12, 2, &coprocessorParams[107]},
+	{"ROTATE", 0x29, 8, 1, &coprocessorParams[109]},
+	{"SETMATRIX", 0x2a, 4, 0, nullptr},
+	{"SETFONT", 0x2b, 12, 2, &coprocessorParams[110]},
+	{"TRACK", 0x2c, 16, 5, &coprocessorParams[112]},
+	{"DIAL", 0x2d, 16, 5, &coprocessorParams[117]},
+	{"NUMBER", 0x2e, 16, 5, &coprocessorParams[122]},
+	{"SCREENSAVER", 0x2f, 4, 0, nullptr},
+	{"SKETCH", 0x30, 4, 0, nullptr},
+	{"LOGO", 0x31, 4, 0, nullptr},
+	{"COLDSTART", 0x32, 4, 0, nullptr},
+	{"GETMATRIX", 0x33, 28, 6, &coprocessorParams[127]},
+	{"GRADCOLOR", 0x34, 8, 1, &coprocessorParams[133]},
+	{"SETROTATE", 0x36, 8, 1, &coprocessorParams[134]},
+	{"SNAPSHOT2", 0x37, 20, 6, &coprocessorParams[135]},
+	{"SETBASE", 0x38, 8, 1, &coprocessorParams[141]},
+	{"MEDIAFIFO", 0x39, 12, 2, &coprocessorParams[142]},
+	{"PLAYVIDEO", 0x3a, 8, 1, &coprocessorParams[144]},
+	{"SETFONT2", 0x3b, 16, 3, &coprocessorParams[145]},
+	{"SETSCRATCH", 0x3c, 8, 1, &coprocessorParams[148]},
+	{"ROMFONT", 0x3f, 12, 2, &coprocessorParams[149]},
+	{"VIDEOSTART", 0x40, 4, 0, nullptr},
+	{"VIDEOFRAME", 0x41, 12, 2, &coprocessorParams[151]},
+	{"SETBITMAP", 0x43, 16, 4, &coprocessorParams[153]},
+};
+
+/**
+ * @brief Command table index by most significant byte of display list word, 0xff if invalid
+ */
+inline constexpr uint8_t displayListIndex[256]{
+	  0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,
+	 16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31,
+	 32,  33,  34,  35,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	 46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+	 46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+	 46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+	 46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,  46,
+	 47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+	 47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+	 47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+	 47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,  47,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+/**
+ * @brief Command table index by least significant byte of co-processor command word (0xffffffxx), 0xff if invalid
+ */
+inline constexpr uint8_t coprocessorIndex[256]{
+	  0,   1,   2, 255, 255, 255, 255, 255, 255,   3,   4,   5,   6,   7,   8,   9,
+	 10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,
+	255, 255,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35,  36,  37,  38,  39,
+	 40,  41,  42,  43,  44, 255,  45,  46,  47,  48,  49,  50,  51, 255, 255,  52,
+	 53,  54, 255,  55, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+	255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+} // namespace Graphics::EVE::Schema
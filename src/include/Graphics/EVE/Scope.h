@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Display.h"
+#include "CommandList.h"
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Oscilloscope trace rendered from a row of samples in GRAM
+ *
+ * Drawing a trace using LINE_STRIP requires one 32-bit VERTEX2F per point, so an 800-point
+ * trace costs 3200 bytes of display list per frame and eats into the 2048-word DL limit.
+ *
+ * Instead, samples are written as a single row of bytes (one per column) into GRAM and drawn
+ * using the BARGRAPH bitmap format. Per-frame traffic drops to `width` bytes (one DMA transfer)
+ * plus a fixed 30 or so DL words regardless of trace width.
+ *
+ * Sample values are screen-oriented: 0 is the top of the trace area and 255 the bottom.
+ * The bitmap is stretched vertically to fill the requested height.
+ *
+ * BARGRAPH bitmaps are limited to 256 pixels wide so the row is split into cells of 256 bytes.
+ * Reserve `getGramSize()` bytes of GRAM for the trace.
+ */
+class ScopeTrace
+{
+public:
+	enum class Style {
+		bargraph, ///< Filled from sample level to bottom of trace area
+		line,	 ///< Band of `thickness` pixels below each sample level
+	};
+
+	struct Config {
+		uint32_t address; ///< GRAM address for samples, 4-byte aligned
+		uint16_t width;   ///< Number of samples (columns)
+		uint16_t height;  ///< Height of trace area in pixels
+		int16_t x;		  ///< Position of trace area
+		int16_t y;
+		uint8_t handle;	///< Bitmap handle to use (0-14)
+		Style style;
+		uint8_t thickness; ///< Line thickness in pixels for Style::line
+		uint32_t color;	///< RGB colour
+		uint8_t alpha;
+	};
+
+	static constexpr uint16_t cellWidth{256};
+
+	ScopeTrace(const Config& config) : config(config)
+	{
+	}
+
+	/**
+	 * @brief Number of bytes of GRAM required for the sample row
+	 */
+	uint32_t getGramSize() const
+	{
+		return getCellCount() * cellWidth;
+	}
+
+	const Config& getConfig() const
+	{
+		return config;
+	}
+
+	void setColor(uint32_t color, uint8_t alpha = 0xff)
+	{
+		config.color = color;
+		config.alpha = alpha;
+	}
+
+	void setPosition(int16_t x, int16_t y)
+	{
+		config.x = x;
+		config.y = y;
+	}
+
+	/**
+	 * @brief Write a row of samples into GRAM using a single asynchronous transfer
+	 * @param display
+	 * @param samples Buffer containing `width` samples. Must remain valid until transfer completes.
+	 * @param callback Optional completion callback
+	 * @param param Parameter passed to callback
+	 *
+	 * If a previous upload is still in progress this call waits for it to complete first.
+	 */
+	void upload(EveDisplay& display, const uint8_t* samples, HSPI::Callback callback = nullptr,
+				void* param = nullptr);
+
+	/**
+	 * @brief Append display list commands to draw trace
+	 * @retval bool false if list has insufficient space or height is zero, in which case it is left unchanged
+	 *
+	 * Graphics context is preserved using SAVE_CONTEXT/RESTORE_CONTEXT.
+	 * The `line` style uses the stencil buffer in the trace area, which is left cleared.
+	 */
+	bool draw(CommandList& list) const;
+
+private:
+	unsigned getCellCount() const
+	{
+		return (config.width + cellWidth - 1) / cellWidth;
+	}
+
+	void addCells(CommandList& list, int16_t y) const;
+
+	Config config;
+	HSPI::Request request;
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Display.h"
+#include "DeferredTask.h"
+#include "PngWriter.h"
+#include <Delegate.h>
+#include <SimpleTimer.h>
+#include <Print.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Capture the screen using CMD_SNAPSHOT2 without a full-frame buffer
+ *
+ * The screen is captured as RGB565 in horizontal strips into a GRAM scratch region, so only
+ * `scratchSize` bytes of GRAM are needed rather than 768 KB for an 800x480 display.
+ * Each strip is read back with asynchronous DMA reads of a few rows at a time and encoded
+ * straight to the output, as PNG or raw little-endian RGB565.
+ *
+ * Everything runs from timer and task callbacks so the application can continue rendering.
+ * Snapshot commands are interleaved with the application's commands in the FIFO; each captures
+ * whatever display list is current when it executes, so if the screen changes during capture
+ * strips may come from different frames.
+ */
+class Screenshot
+{
+public:
+	enum class Format {
+		png,
+		rgb565,
+	};
+
+	struct Config {
+		uint32_t scratchAddress; ///< GRAM region for strips, must not be in use by the application
+		uint32_t scratchSize{32768}; ///< Size of region, at least one row (2 bytes per pixel)
+		uint16_t readSize{4096}; ///< Maximum bytes per DMA read, rounded down to whole rows
+		Format format{Format::png};
+	};
+
+	using Callback = Delegate<void(bool success)>;
+
+	Screenshot(EveDisplay& display) : display(display)
+	{
+	}
+
+	~Screenshot()
+	{
+		cancel();
+	}
+
+	/**
+	 * @brief Start a capture
+	 * @param output Destination, e.g. FileStream or MemoryDataStream
+	 * @param config
+	 * @param callback Invoked on completion
+	 * @retval bool false if a capture is already in progress or configuration is invalid
+	 */
+	bool begin(Print& output, const Config& config, Callback callback);
+
+	/**
+	 * @brief Abandon capture in progress, if any. The callback is not invoked.
+	 */
+	void cancel();
+
+	bool isBusy() const
+	{
+		return state != State::idle;
+	}
+
+private:
+	enum class State {
+		idle,
+		snapshot, ///< Waiting for co-processor to complete CMD_SNAPSHOT2
+		reading,  ///< Reading rows back from GRAM
+	};
+
+	void startStrip();
+	void poll();
+	void startRead();
+	static bool readComplete(HSPI::Request& request);
+	void process();
+	bool output(unsigned rows);
+	void complete(bool success);
+
+	EveDisplay& display;
+	Print* out{nullptr};
+	Config config{};
+	Callback callback;
+	HSPI::Request request;
+	SimpleTimer timer;
+	DeferredTask task{[](void* param) { static_cast<Screenshot*>(param)->process(); }, this};
+	std::unique_ptr<PngWriter> png;
+	std::unique_ptr<uint8_t[]> buffer;
+	std::unique_ptr<uint8_t[]> rgb;
+	State state{State::idle};
+	uint16_t width{0};
+	uint16_t height{0};
+	uint16_t stripRows{0};
+	uint16_t chunkRows{0};
+	uint16_t stripY{0};
+	uint16_t stripHeight{0};
+	uint16_t stripRow{0};
+	uint16_t readRows{0};
+	uint32_t fifoMark{0}; ///< FIFO position following CMD_SNAPSHOT2
+	uint32_t fifoRegs[2]; ///< REG_CMD_READ, REG_CMD_WRITE
+};
+
+} // namespace Graphics::EVE
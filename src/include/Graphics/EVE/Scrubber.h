@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Display.h"
+#include <Delegate.h>
+#include <SimpleTimer.h>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Background integrity check of assets held in GRAM
+ *
+ * Assets (fonts, icons, bitmaps) are registered in a residency table with their GRAM location and
+ * a callback which uploads them again. Each asset is divided into fixed-size chunks and the
+ * scrubber works through them in turn, one chunk per timer tick, having the co-processor
+ * calculate its CRC with CMD_MEMCRC. A chunk is only checked when the command FIFO is empty,
+ * and the chunk size bounds the co-processor time taken, so checks fit in the idle time between
+ * frames. If a CRC doesn't match, only that asset is re-uploaded.
+ *
+ * Expected CRCs are calculated from the asset data if it's available in CPU-addressable memory.
+ * Otherwise the first pass over an asset records them, so register assets immediately after
+ * uploading them.
+ */
+class Scrubber
+{
+public:
+	/**
+	 * @brief Upload an asset again
+	 * @param address GRAM address given to `add()`
+	 * @param size
+	 * @retval bool true if the asset was uploaded
+	 */
+	using Reload = Delegate<bool(uint32_t address, uint32_t size)>;
+
+	/**
+	 * @brief Create a scrubber
+	 * @param display
+	 * @param maxAssets Size of residency table
+	 * @param chunkSize Bytes checked per tick, multiple of 4
+	 */
+	Scrubber(EveDisplay& display, uint16_t maxAssets = 16, uint16_t chunkSize = 8192)
+		: display(display), assets(new Asset[maxAssets]), maxAssets(maxAssets), chunkSize(chunkSize)
+	{
+	}
+
+	~Scrubber()
+	{
+		stop();
+	}
+
+	/**
+	 * @brief Add an asset to the residency table
+	 * @param address Location in GRAM, 4-byte aligned
+	 * @param size Size in bytes
+	 * @param reload Callback to upload the asset
+	 * @param data Asset content, used to calculate expected CRCs. Need not remain valid after this call.
+	 * @retval bool false if the table is full or the region is invalid
+	 */
+	bool add(uint32_t address, uint32_t size, Reload reload, const void* data = nullptr);
+
+	/**
+	 * @brief Remove an asset, e.g. when its GRAM is re-used
+	 */
+	bool remove(uint32_t address);
+
+	void clear();
+
+	/**
+	 * @brief Start background checks
+	 * @param intervalMs Time between chunks
+	 */
+	void start(unsigned intervalMs = 50);
+
+	void stop()
+	{
+		timer.stop();
+	}
+
+	/**
+	 * @brief Check the next chunk
+	 * @retval bool false if the co-processor was busy and nothing was checked
+	 */
+	bool step();
+
+	uint16_t getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * @brief Total number of bytes checked
+	 */
+	uint32_t getCheckedBytes() const
+	{
+		return checkedBytes;
+	}
+
+	/**
+	 * @brief Number of chunks which failed their check
+	 */
+	uint32_t getErrorCount() const
+	{
+		return errorCount;
+	}
+
+	/**
+	 * @brief Number of assets uploaded again following an error
+	 */
+	uint32_t getReloadCount() const
+	{
+		return reloadCount;
+	}
+
+private:
+	struct Asset {
+		uint32_t address;
+		uint32_t size;
+		Reload reload;
+		std::unique_ptr<uint32_t[]> crcs; ///< One per chunk
+		uint32_t known;					  ///< Chunks with a recorded CRC
+		bool learned;					  ///< CRCs recorded from GRAM rather than calculated from data
+	};
+
+	unsigned getChunkCount(const Asset& asset) const
+	{
+		return (asset.size + chunkSize - 1) / chunkSize;
+	}
+
+	bool memcrc(uint32_t address, uint32_t size, uint32_t& crc);
+
+	EveDisplay& display;
+	SimpleTimer timer;
+	std::unique_ptr<Asset[]> assets;
+	uint16_t maxAssets;
+	uint16_t chunkSize;
+	uint16_t count{0};
+	uint16_t current{0}; ///< Asset being checked
+	uint32_t chunk{0};   ///< Next chunk in asset
+	uint32_t checkedBytes{0};
+	uint32_t errorCount{0};
+	uint32_t reloadCount{0};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Display.h"
+#include "CommandList.h"
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Cache of co-processor generated display list fragments
+ *
+ * Widgets such as CMD_BUTTON, CMD_KEYS and CMD_TEXT make the co-processor generate the same
+ * display list words every frame when their parameters haven't changed. A snippet is recorded
+ * by running the widget commands once into an empty display list and copying the result from
+ * RAM_DL into GRAM with CMD_MEMCPY. Later frames replay it with a 12-byte CMD_APPEND.
+ *
+ * Snippets are keyed by a CRC of the widget's command words so any change in position, options,
+ * text or preceding state commands included in the list selects a different entry.
+ * GRAM is allocated sequentially from the configured region. Call `beginFrame()` before building
+ * each frame: a list may already contain CMD_APPEND references to any snippet it has used, so
+ * nothing is evicted part-way through a frame. When GRAM or the entry table fills up, further
+ * widgets are added directly and the cache is cleared at the start of the next frame, unless
+ * every snippet was used by the last one.
+ *
+ * Recording is synchronous and uses the display list buffer, so it must be done whilst a frame
+ * is being built in CPU RAM and not part-way through sending one. Co-processor state such as
+ * CMD_FGCOLOR persists between frames, so set it in the widget list rather than relying on
+ * what went before. Likewise graphics state (COLOR_RGB, etc.) in effect at the point of append
+ * applies to the snippet unless the widget list sets it.
+ */
+class SnippetCache
+{
+public:
+	/**
+	 * @brief Create a cache
+	 * @param address Start of GRAM region, 4-byte aligned
+	 * @param size Size of GRAM region in bytes
+	 * @param maxEntries Number of snippets which can be held
+	 */
+	SnippetCache(uint32_t address, uint32_t size, uint16_t maxEntries = 32)
+		: entries(new Entry[maxEntries]), address(address), size(size), maxEntries(maxEntries)
+	{
+	}
+
+	/**
+	 * @brief Calculate key for a widget command list
+	 */
+	static uint32_t getKey(const CommandList& widget);
+
+	/**
+	 * @brief Start building a new frame
+	 *
+	 * If the cache filled up during the previous frame and not all snippets were used by it,
+	 * the cache is cleared so the current working set can be recorded.
+	 */
+	void beginFrame();
+
+	/**
+	 * @brief Append a cached snippet to a list
+	 * @param list Frame being built
+	 * @param key Value from `getKey()`
+	 * @retval bool false if snippet isn't cached or list has insufficient space
+	 */
+	bool append(CommandList& list, uint32_t key);
+
+	/**
+	 * @brief Record a snippet
+	 * @param display
+	 * @param key Value from `getKey()`
+	 * @param widget Co-processor and display list commands to record
+	 * @retval bool false if snippet is too large, cache is full or co-processor failed to respond
+	 */
+	bool record(EveDisplay& display, uint32_t key, const CommandList& widget);
+
+	/**
+	 * @brief Append snippet for widget to list, recording it first if not already cached
+	 * @retval bool false on failure, in which case widget commands are added directly
+	 */
+	bool add(EveDisplay& display, CommandList& list, const CommandList& widget);
+
+	/**
+	 * @brief Discard all snippets
+	 * @note Must not be called whilst a frame which uses the cache is being built
+	 */
+	void clear()
+	{
+		used = 0;
+		count = 0;
+		full = false;
+	}
+
+	/**
+	 * @brief Number of snippets currently cached
+	 */
+	uint16_t getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * @brief Number of bytes of GRAM occupied by snippets
+	 */
+	uint32_t getUsed() const
+	{
+		return used;
+	}
+
+private:
+	struct Entry {
+		uint32_t key;
+		uint32_t offset;
+		uint16_t length;
+		uint16_t frame; ///< Generation in which snippet was last appended
+	};
+
+	Entry* find(uint32_t key);
+
+	std::unique_ptr<Entry[]> entries;
+	uint32_t address;
+	uint32_t size;
+	uint32_t used{0};
+	uint16_t maxEntries;
+	uint16_t count{0};
+	uint16_t frame{0};
+	bool full{false}; ///< Set when a snippet couldn't be recorded for lack of space
+};
+
+} // namespace Graphics::EVE
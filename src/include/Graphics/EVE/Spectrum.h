@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Fixed-point FFT and log-magnitude kernel for producing waterfall rows
+ *
+ * Targets CPUs without an FPU (e.g. esp32-s2) so all per-block arithmetic is integer.
+ * Samples are Hann-windowed, transformed with a radix-2 FFT, then converted to dBFS and
+ * mapped onto 0-255 according to the configured range. Output goes straight into a row
+ * buffer ready for DMA, such as `Waterfall::getRowBuffer()`.
+ *
+ * 0 dBFS corresponds to a full-scale sinewave centred in a bin.
+ */
+class Spectrum
+{
+public:
+	/**
+	 * @brief Construct kernel
+	 * @param order Transform size is 2^order points, between 4 and 12
+	 */
+	Spectrum(uint8_t order);
+
+	/**
+	 * @brief Get number of input samples required by `process()`
+	 */
+	unsigned getSize() const
+	{
+		return 1U << order;
+	}
+
+	/**
+	 * @brief Set range of levels mapped onto output values
+	 * @param floorDb Level which maps to 0, e.g. -100
+	 * @param rangeDb Span which maps to 0-255, e.g. 100
+	 */
+	void setRange(int floorDb, unsigned rangeDb)
+	{
+		this->floorDb = floorDb;
+		this->rangeDb = rangeDb ?: 1;
+	}
+
+	/**
+	 * @brief Compute spectrum row
+	 * @param samples Input block of `getSize()` samples
+	 * @param row Output buffer
+	 * @param width Number of output pixels. The `getSize() / 2` bins are mapped onto this, taking the peak
+	 * value where several bins fall into one pixel.
+	 */
+	void process(const int16_t* samples, uint8_t* row, unsigned width);
+
+private:
+	void transform();
+	int32_t logPower(unsigned bin) const;
+
+	uint8_t order;
+	int floorDb{-100};
+	unsigned rangeDb{100};
+	std::unique_ptr<int16_t[]> sine;   ///< Q15 sin(2*pi*i/N) for i in [0, N/2)
+	std::unique_ptr<int16_t[]> window; ///< Q15 Hann window, first half (symmetrical)
+	std::unique_ptr<int32_t[]> re;
+	std::unique_ptr<int32_t[]> im;
+};
+
+} // namespace Graphics::EVE
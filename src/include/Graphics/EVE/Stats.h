@@ -0,0 +1,71 @@
+#pragma once
+
+#include <HSPI/Common.h>
+#include <Print.h>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Runtime performance counters maintained by EveDisplay
+ *
+ * Counters are simple increments on paths which already perform SPI transactions so may be left enabled.
+ * Frame-related values (DL usage, missed frames, co-processor busy time) are sampled by
+ * `EveDisplay::updateFrameStats()` which the application calls once per frame.
+ *
+ * Durations are accumulated in microseconds using 64-bit totals, and elapsed time is measured
+ * in milliseconds, so counters remain valid on a unit left running for weeks.
+ */
+struct Stats {
+	struct Transfer {
+		uint32_t transactions; ///< Number of SPI requests issued
+		uint32_t bytes;		   ///< Payload bytes transferred, excluding address and dummy cycles
+	};
+
+	uint32_t startTime; ///< Value of millis() when counters were last reset
+	Transfer spi;		///< Standard (half-duplex) SPI transfers
+	Transfer dual;		///< Dual I/O transfers
+	Transfer quad;		///< Quad I/O transfers
+	uint32_t fifoStalls;	///< Number of times the command FIFO was full
+	uint64_t fifoStallTime; ///< Time spent waiting for command FIFO space, in microseconds
+	uint32_t pollReads;		///< Register reads issued whilst waiting for the EVE
+	uint16_t cmdHighWater;  ///< Maximum observed command FIFO fill level, in bytes
+	uint16_t dlHighWater;   ///< Maximum observed REG_CMD_DL value, in bytes
+	uint64_t coproBusyTime; ///< Time between command submission and the FIFO becoming empty, in microseconds
+	uint32_t frames;		///< Number of frames reported via `updateFrameStats()`
+	uint32_t missedFrames;  ///< Display frames which passed without a new frame being reported
+	uint32_t directLists;   ///< Display lists written directly to RAM_DL via `EveDisplay::sendDisplayList()`
+	uint32_t elidedWrites;  ///< Register writes skipped as the value was unchanged
+	uint32_t cachedReads;   ///< Register reads served from the shadow copy
+	uint32_t coproFaults;   ///< Co-processor faults recovered from
+
+	void reset();
+
+	Transfer& getTransfer(HSPI::IoMode mode)
+	{
+		switch(mode) {
+		case HSPI::IoMode::SDI:
+			return dual;
+		case HSPI::IoMode::SQI:
+			return quad;
+		default:
+			return spi;
+		}
+	}
+
+	/**
+	 * @brief Time since counters were reset, in milliseconds
+	 */
+	uint32_t getElapsed() const;
+
+	/**
+	 * @brief Convert a counter value into a rate based on elapsed time
+	 */
+	uint32_t perSecond(uint32_t count) const;
+
+	/**
+	 * @brief Write counters as a JSON object
+	 */
+	size_t printTo(Print& p) const;
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Display.h"
+#include "DeferredTask.h"
+#include "Gesture.h"
+#include <SimpleTimer.h>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Multi-touch support for capacitive (FT813) panels
+ *
+ * All five touch points and their tags are captured by a single burst read of the
+ * register block from REG_CTOUCH_TOUCH1_XY to REG_CTOUCH_TOUCH3_XY (120 bytes), rather than
+ * polling each register individually.
+ *
+ * Sampling is started by EVE_INT_TOUCH and continues at `interval` until all points are released.
+ * Reads are asynchronous; decoding and gesture recognition run in task context.
+ *
+ * The EVE INT_N line must be connected to a GPIO and its interrupt passed through. For example:
+ *
+ * 	attachInterrupt(EVE_INT_PIN, InterruptDelegate([]() {
+ * 		touch.handleInterrupt(display.readInterruptFlags());
+ * 	}), FALLING);
+ *
+ */
+class Touch
+{
+public:
+	using SnapshotCallback = Delegate<void(const TouchSnapshot& snapshot)>;
+
+	~Touch()
+	{
+		end();
+	}
+
+	/**
+	 * @brief Configure touch controller for extended (multi-touch) mode and enable interrupt
+	 * @param display
+	 * @param interval Sampling interval in milliseconds whilst touched
+	 */
+	void begin(EveDisplay& display, uint16_t interval = 10);
+
+	void end();
+
+	/**
+	 * @brief Pass interrupt flags obtained from `EveDisplay::readInterruptFlags()`
+	 */
+	void handleInterrupt(uint8_t flags);
+
+	/**
+	 * @brief Capture all touch points synchronously
+	 */
+	void read(TouchSnapshot& snapshot);
+
+	/**
+	 * @brief Set callback to receive each snapshot
+	 */
+	void onSnapshot(SnapshotCallback callback)
+	{
+		snapshotCallback = callback;
+	}
+
+	GestureDetector& getGestures()
+	{
+		return gestures;
+	}
+
+	/**
+	 * @brief Get most recent snapshot
+	 */
+	const TouchSnapshot& getSnapshot() const
+	{
+		return snapshot;
+	}
+
+private:
+	static constexpr uint32_t firstRegister{REG_CTOUCH_TOUCH1_XY};
+	static constexpr unsigned registerCount{(REG_CTOUCH_TOUCH3_XY - REG_CTOUCH_TOUCH1_XY) / 4 + 1};
+
+	void startRead();
+	static bool readComplete(HSPI::Request& request);
+	void process();
+	void decode(TouchSnapshot& snapshot) const;
+
+	EveDisplay* display{nullptr};
+	HSPI::Request request;
+	SimpleTimer timer;
+	DeferredTask task{[](void* param) { static_cast<Touch*>(param)->process(); }, this};
+	GestureDetector gestures;
+	SnapshotCallback snapshotCallback;
+	TouchSnapshot snapshot{};
+	uint32_t registers[registerCount];
+	bool sampling{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "Display.h"
+#include <Data/Stream/DataSourceStream.h>
+#include <SimpleTimer.h>
+#include <Delegate.h>
+#include <Print.h>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Compact binary trace of SPI transactions
+ *
+ * The trace starts with an 8-byte header: "EVTR", version, mode and two reserved bytes.
+ * Each record then contains:
+ *
+ * - Flags byte: bits 0-1 Kind, bit 2 asynchronous, bit 3 payload follows, bit 4 CRC32 follows
+ * - Time since start of previous record in microseconds (varint)
+ * - Duration in microseconds (varint), 0 for asynchronous requests as completion is not observed
+ * - Host commands: command and parameter bytes
+ * - Memory transfers: 24-bit address, length (varint), then payload and/or CRC32
+ *
+ * Varints are little-endian base 128, as used by protobuf. All other values are little-endian.
+ */
+namespace Trace
+{
+enum class Kind : uint8_t {
+	host = 0,
+	write = 1,
+	read = 2,
+};
+
+enum class Mode : uint8_t {
+	hash = 0,	///< Record CRC32 of data only, trace can be analysed but not replayed
+	payload = 1, ///< Record all data
+};
+
+constexpr uint8_t version{1};
+constexpr uint8_t flagAsync{0x04};
+constexpr uint8_t flagPayload{0x08};
+constexpr uint8_t flagHash{0x10};
+
+} // namespace Trace
+
+/**
+ * @brief Records all transactions made through EveDisplay::execute()
+ *
+ * Attach using `EveDisplay::setTrace()`. Synchronous requests are recorded on completion so reads
+ * include the data returned. Asynchronous requests are recorded when issued, without read data.
+ *
+ * Output goes to any Print, typically a FileStream or MemoryDataStream. Writes are made during
+ * each transaction so the output should be fast; for long captures use hash mode.
+ */
+class TraceRecorder
+{
+public:
+	TraceRecorder(Print& output, Trace::Mode mode = Trace::Mode::payload) : output(output), mode(mode)
+	{
+	}
+
+	/**
+	 * @brief Record a request
+	 * @param req
+	 * @param startTime Value of micros() when the request was issued
+	 */
+	void record(const HSPI::Request& req, uint32_t startTime);
+
+	uint32_t getCount() const
+	{
+		return count;
+	}
+
+	/**
+	 * @brief Get number of bytes written to output, including header
+	 */
+	size_t getSize() const
+	{
+		return size;
+	}
+
+private:
+	void writeVarint(uint32_t value);
+	void writeBytes(const void* data, size_t length);
+
+	Print& output;
+	Trace::Mode mode;
+	uint32_t lastTime{0};
+	uint32_t count{0};
+	size_t size{0};
+};
+
+/**
+ * @brief Replays a recorded trace through a display
+ *
+ * The display may be real hardware or, on Host builds, attached to an EVE::Emulator.
+ * Writes to REG_SPI_WIDTH are converted to `setIoMode()` calls so the bus mode follows the recording.
+ *
+ * Records are replayed from a timer in batches of limited duration, so a long trace doesn't
+ * starve the system watchdog. In real time mode gaps of a millisecond or more are timer delays.
+ */
+class TraceReplay
+{
+public:
+	using Callback = Delegate<void(bool success)>;
+
+	struct Options {
+		bool realTime{true};	 ///< Reproduce gaps between transactions, otherwise run back-to-back
+		bool verifyReads{false}; ///< Compare read data against the recording
+	};
+
+	struct Result {
+		uint32_t records;
+		uint32_t skipped;	///< Writes recorded without payload
+		uint32_t mismatches; ///< Reads which returned different data (if verifying)
+		uint32_t recordedTime; ///< Time span of the recording in microseconds
+		uint32_t elapsed;	  ///< Time taken to replay in microseconds
+	};
+
+	TraceReplay(EveDisplay& display) : display(display)
+	{
+	}
+
+	/**
+	 * @brief Start replaying a trace
+	 * @param input Must remain valid until the callback is invoked
+	 * @param options
+	 * @param callback Invoked on completion, with false if the trace is truncated
+	 * @retval bool false if the trace header is invalid or a replay is already in progress
+	 */
+	bool begin(IDataStream& input, const Options& options, Callback callback);
+
+	/**
+	 * @brief Abandon replay without invoking the callback
+	 */
+	void end()
+	{
+		timer.stop();
+		input = nullptr;
+	}
+
+	bool isBusy() const
+	{
+		return input != nullptr;
+	}
+
+	const Result& getResult() const
+	{
+		return result;
+	}
+
+private:
+	bool read(void* buffer, size_t length);
+	bool readVarint(uint32_t& value);
+	bool replay(uint8_t flags);
+	void process();
+	void schedule(uint32_t delayMs);
+	void complete(bool success);
+
+	EveDisplay& display;
+	IDataStream* input{nullptr};
+	Options options;
+	Callback callback;
+	SimpleTimer timer;
+	Result result{};
+	uint32_t startTime{0};
+	uint32_t recordTime{0}; ///< Start of next record relative to startTime
+	uint8_t recordFlags{0}; ///< Flags for record waiting to be replayed
+	bool recordPending{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Display.h"
+#include "DeferredTask.h"
+#include <SimpleTimer.h>
+#include <Delegate.h>
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Dispatch value changes from co-processor tracked controls
+ *
+ * Sliders, scrollbars, dials and scroll areas are registered by tag with the range of values they represent.
+ * `track()` adds the corresponding CMD_TRACK commands; the EVE then computes positions and angles itself,
+ * so no host-side hit testing or trigonometry is required.
+ *
+ * After a touch or tag interrupt the five tracker registers (REG_TRACKER to REG_TRACKER_4) are read
+ * in a single burst, repeated at `interval` whilst any are active. Each change is converted into the control's value
+ * range and passed to its handler.
+ *
+ * Linear controls report position along their longest dimension. Rotary controls report the angle about
+ * their centre, increasing clockwise from the bottom (6 o'clock), as used by CMD_DIAL.
+ */
+class Tracker
+{
+public:
+	/**
+	 * @brief Handler for value changes
+	 * @param tag Tag of the control
+	 * @param value Converted value, from `min` to `max`
+	 */
+	using Callback = Delegate<void(uint8_t tag, int32_t value)>;
+
+	static constexpr unsigned maxControls{16};
+
+	~Tracker()
+	{
+		end();
+	}
+
+	/**
+	 * @brief Start tracking
+	 * @param display
+	 * @param interval Sampling interval in milliseconds whilst touched
+	 */
+	void begin(EveDisplay& display, uint16_t interval = 20);
+
+	void end();
+
+	/**
+	 * @brief Register a linear control such as a slider or scroll area
+	 * @param tag Tag used when drawing the control, must be non-zero
+	 * @param x, y, width, height Tracked area
+	 * @param min Value at left (or top) of area
+	 * @param max Value at right (or bottom) of area
+	 * @param callback
+	 * @retval bool false if tag is invalid or there are too many controls
+	 */
+	bool addLinear(uint8_t tag, int16_t x, int16_t y, uint16_t width, uint16_t height, int32_t min, int32_t max,
+				   Callback callback);
+
+	/**
+	 * @brief Register a rotary control such as a dial
+	 * @param tag Tag used when drawing the control, must be non-zero
+	 * @param x, y Centre of rotation
+	 * @param min Value at start of rotation
+	 * @param max Value after one full clockwise revolution
+	 * @param callback
+	 * @retval bool false if tag is invalid or there are too many controls
+	 */
+	bool addRotary(uint8_t tag, int16_t x, int16_t y, int32_t min, int32_t max, Callback callback);
+
+	/**
+	 * @brief Remove a control
+	 *
+	 * Tracking remains active in the EVE until the co-processor is reset,
+	 * but no further events are dispatched.
+	 */
+	bool remove(uint8_t tag);
+
+	/**
+	 * @brief Add CMD_TRACK commands for all registered controls
+	 * @retval bool false if list has insufficient space
+	 *
+	 * Tracking persists so this only needs doing once after controls are registered.
+	 */
+	bool track(CommandList& list) const;
+
+	/**
+	 * @brief Pass interrupt flags obtained from `EveDisplay::readInterruptFlags()`
+	 */
+	void handleInterrupt(uint8_t flags);
+
+private:
+	struct Control {
+		Callback callback;
+		int32_t min;
+		int32_t max;
+		int16_t x;
+		int16_t y;
+		uint16_t width;
+		uint16_t height;
+		int32_t lastValue; ///< Raw tracker value last reported, -1 if none
+		uint8_t tag;
+	};
+
+	static constexpr unsigned registerCount{(REG_TRACKER_4 - REG_TRACKER) / 4 + 1};
+
+	bool add(const Control& control);
+	Control* find(uint8_t tag);
+	void startRead();
+	static bool readComplete(HSPI::Request& request);
+	void process();
+
+	EveDisplay* display{nullptr};
+	HSPI::Request request;
+	SimpleTimer timer;
+	DeferredTask task{[](void* param) { static_cast<Tracker*>(param)->process(); }, this};
+	Control controls[maxControls];
+	uint8_t controlCount{0};
+	uint32_t registers[registerCount];
+	bool sampling{false};
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Display.h"
+#include "CommandList.h"
+
+namespace Graphics::EVE
+{
+/**
+ * @brief Scrolling spectrogram (waterfall) display
+ *
+ * History is held in GRAM as a circular bitmap of `rows` lines, one byte per pixel.
+ * Each new row is written once, using a single transfer, over the oldest row.
+ * Scrolling is done entirely in the display list by drawing the bitmap in two parts
+ * either side of the wrap point, adjusting BITMAP_SOURCE and vertex position.
+ * Existing rows are never re-uploaded or copied.
+ *
+ * Newest row is at the top.
+ *
+ * Row data is written into a pair of host buffers, obtained via `getRowBuffer()`,
+ * so one can be filled (e.g. by `Spectrum::process()`) whilst the other is being transferred.
+ *
+ * Two formats are supported:
+ *
+ * L8
+ * 	Intensity only, tinted by `color`.
+ *
+ * PALETTED8
+ * 	Each byte indexes a 256-entry ARGB8888 palette (1KiB) held in GRAM.
+ * 	FT81x draws this format in four passes, one per channel, so render cost is higher.
+ */
+class Waterfall
+{
+public:
+	enum class Format {
+		L8,
+		paletted8,
+	};
+
+	struct Config {
+		uint32_t address;		 ///< GRAM address of history bitmap, `width * rows` bytes
+		uint32_t paletteAddress; ///< GRAM address of palette for Format::paletted8, 4-byte aligned
+		uint16_t width;			 ///< Row width in pixels
+		uint16_t rows;			 ///< Number of history rows (bitmap height)
+		int16_t x;				 ///< Position on screen
+		int16_t y;
+		uint8_t handle; ///< Bitmap handle to use (0-14)
+		Format format;
+		uint32_t color; ///< RGB tint for Format::L8
+	};
+
+	Waterfall(const Config& config);
+
+	const Config& getConfig() const
+	{
+		return config;
+	}
+
+	/**
+	 * @brief Number of bytes of GRAM required for history bitmap
+	 */
+	uint32_t getGramSize() const
+	{
+		return uint32_t(config.width) * config.rows;
+	}
+
+	/**
+	 * @brief Write palette to GRAM
+	 * @param display
+	 * @param palette 256 entries in ARGB8888 format
+	 */
+	void writePalette(EveDisplay& display, const uint32_t* palette);
+
+	/**
+	 * @brief Clear history
+	 * @param display
+	 * @param value Pixel value to fill with
+	 *
+	 * Blocks until complete.
+	 */
+	void clear(EveDisplay& display, uint8_t value = 0);
+
+	/**
+	 * @brief Get buffer for constructing the next row
+	 * @retval uint8_t* Buffer of `width` bytes, valid until the next call to `pushRow()`
+	 */
+	uint8_t* getRowBuffer()
+	{
+		return &rowBuffer[current * config.width];
+	}
+
+	/**
+	 * @brief Write content of row buffer to GRAM and scroll
+	 *
+	 * The transfer is asynchronous. If the previous row is still being written this call
+	 * waits for it to complete. The other row buffer then becomes available for filling.
+	 */
+	void pushRow(EveDisplay& display);
+
+	/**
+	 * @brief Append display list commands to draw waterfall
+	 * @retval bool false if list has insufficient space, in which case it is left unchanged
+	 *
+	 * Graphics context is preserved using SAVE_CONTEXT/RESTORE_CONTEXT.
+	 */
+	bool draw(CommandList& list) const;
+
+private:
+	void addSegments(CommandList& list) const;
+
+	Config config;
+	HSPI::Request request;
+	std::unique_ptr<uint8_t[]> rowBuffer; ///< Two rows
+	uint16_t head{0};					  ///< Index of newest row in GRAM
+	uint8_t current{0};					  ///< Index of row buffer being filled
+};
+
+} // namespace Graphics::EVE
@@ -0,0 +1,25 @@
+#include <SmingTest.h>
+#include <modules.h>
+
+#define XX(t) extern void REGISTER_TEST(t);
+TEST_MAP(XX)
+#undef XX
+
+namespace
+{
+void registerTests()
+{
+#define XX(t) REGISTER_TEST(t);
+	TEST_MAP(XX)
+#undef XX
+}
+
+} // namespace
+
+void init()
+{
+	Serial.begin(SERIAL_BAUD_RATE);
+	Serial.systemDebugOutput(true);
+
+	System.onReady([]() { SmingTest::runner.execute(registerTests); });
+}
@@ -0,0 +1,19 @@
+# The emulator and rasteriser only exist in Host builds
+ifneq ($(SMING_ARCH),Host)
+$(error EVE tests must be built with SMING_ARCH=Host)
+endif
+
+COMPONENT_SEARCH_DIRS := $(PROJECT_DIR)/../..
+
+COMPONENT_DEPENDS := \
+	SmingTest \
+	EVE
+
+COMPONENT_SRCDIRS := \
+	app \
+	modules
+
+COMPONENT_INCDIRS := \
+	include
+
+HOST_NETWORK_OPTIONS := --nonet
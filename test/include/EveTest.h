@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SmingTest.h>
+#include <Graphics/EVE/Display.h>
+#include <Graphics/EVE/Emulator.h>
+#include <Graphics/EVE/Renderer.h>
+#include <Graphics/EVE/Crc.h>
+
+namespace EveTest
+{
+using namespace Graphics;
+using namespace Graphics::EVE;
+
+constexpr uint16_t width{800};
+constexpr uint16_t height{480};
+
+/**
+ * @brief Timings for the 800x480 NHD-5.0 panel
+ */
+constexpr EveDisplay::Config displayConfig{
+	928, 88, width, 0, 48, 525, 32, height, 0, 3, 0, 0, 0, 1, 2,
+};
+
+/**
+ * @brief An EveDisplay driving the emulator, with a rasteriser for checking output
+ */
+struct Fixture {
+	Fixture()
+	{
+		display.setEmulator(&emulator);
+	}
+
+	bool begin()
+	{
+		return display.begin(HSPI::PinSet::normal, 0, 25000000, displayConfig);
+	}
+
+	/**
+	 * @brief Send commands and wait for the co-processor to execute them
+	 */
+	bool run(const CommandList& list)
+	{
+		return display.sendCommands(list) && display.waitCommandsIdle();
+	}
+
+	/**
+	 * @brief Get the word at an offset from the end of the last command
+	 *
+	 * Commands which return values overwrite their trailing parameters.
+	 */
+	uint32_t result(unsigned wordsFromEnd)
+	{
+		auto offset = display.read16(REG_CMD_WRITE) - wordsFromEnd * 4;
+		return display.read32(EVE_RAM_CMD + (offset & (EVE_CMDFIFO_SIZE - 1)));
+	}
+
+	HSPI::Controller controller;
+	EveDisplay display{controller};
+	Emulator emulator;
+};
+
+/**
+ * @brief Compare a rendered frame against its golden value
+ *
+ * Frames are identified by the CRC32 of the colour buffer. On mismatch the new value is logged so
+ * that, once the change in output has been checked visually, the table can be updated.
+ */
+inline bool checkGolden(const char* name, const Renderer& renderer, uint32_t golden)
+{
+	auto crc = crc32(renderer.getColorBuffer(), width * height * sizeof(uint32_t));
+	if(crc != golden) {
+		debug_e("[GOLDEN] '%s' is 0x%08x, expected 0x%08x", name, crc, golden);
+		return false;
+	}
+	return true;
+}
+
+} // namespace EveTest
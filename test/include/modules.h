@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * @brief Test modules, in execution order
+ */
+#define TEST_MAP(XX)                                                                                                   \
+	XX(Renderer)                                                                                                       \
+	XX(Coprocessor)                                                                                                    \
+	XX(RegisterCache)                                                                                                  \
+	XX(Decoder)                                                                                                        \
+	XX(PngWriter)                                                                                                      \
+	XX(Trace)                                                                                                          \
+	XX(Bridge)                                                                                                         \
+	XX(SnippetCache)                                                                                                   \
+	XX(BusScheduler)                                                                                                   \
+	XX(Lifetime)
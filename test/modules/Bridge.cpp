@@ -0,0 +1,202 @@
+#include <EveTest.h>
+#include <Graphics/EVE/Bridge.h>
+#include <vector>
+
+using namespace EveTest;
+using namespace Graphics::EVE::BridgeProtocol;
+
+namespace
+{
+/**
+ * @brief Stands in for the websocket client, collecting replies from the bridge
+ */
+struct Client {
+	struct Frame {
+		std::vector<uint8_t> data;
+		bool binary;
+
+		uint32_t word(unsigned index) const
+		{
+			uint32_t value{0};
+			if((index + 1) * 4 <= data.size()) {
+				memcpy(&value, &data[index * 4], 4);
+			}
+			return value;
+		}
+
+		bool isText(const char* text) const
+		{
+			return !binary && data.size() == strlen(text) && memcmp(data.data(), text, data.size()) == 0;
+		}
+	};
+
+	Bridge::SendDelegate getDelegate()
+	{
+		return [this](const void* data, size_t length, bool binary) {
+			auto p = static_cast<const uint8_t*>(data);
+			frames.push_back({{p, p + length}, binary});
+		};
+	}
+
+	const Frame& last() const
+	{
+		return frames.back();
+	}
+
+	/**
+	 * @brief Highest sequence number acknowledged as successful, 0 if none
+	 */
+	uint32_t ackedSeq() const
+	{
+		uint32_t seq{0};
+		for(auto& f : frames) {
+			if(f.word(0) == magicAck && f.word(2) == uint32_t(Status::ok)) {
+				seq = std::max(seq, f.word(1));
+			}
+		}
+		return seq;
+	}
+
+	std::vector<Frame> frames;
+};
+
+/**
+ * @brief Build a frame from header words and optional data
+ */
+std::vector<uint8_t> makeFrame(std::initializer_list<uint32_t> header, const void* data = nullptr, size_t length = 0)
+{
+	std::vector<uint8_t> frame(header.size() * 4 + length);
+	memcpy(frame.data(), header.begin(), header.size() * 4);
+	if(length != 0) {
+		memcpy(&frame[header.size() * 4], data, length);
+	}
+	return frame;
+}
+
+} // namespace
+
+class BridgeTest : public TestGroup
+{
+public:
+	BridgeTest() : TestGroup(_F("Bridge"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(fixture.begin());
+		auto mem = fixture.emulator.getMemory();
+
+		// Small window and payload so overflow is easy to reach
+		Client client;
+		Bridge bridge(fixture.display, client.getDelegate(), 2, 1024);
+		auto handle = [&](const std::vector<uint8_t>& frame) { bridge.handleFrame(frame.data(), frame.size()); };
+
+		TEST_CASE("Legacy frames")
+		{
+			const uint8_t data[]{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+			handle(makeFrame({magicWrite, 0x1000, sizeof(data)}, data, sizeof(data)));
+			REQUIRE(client.last().isText("OK"));
+			REQUIRE(memcmp(&mem[0x1000], data, sizeof(data)) == 0);
+
+			handle(makeFrame({magicRead, 0x1000, sizeof(data)}));
+			REQUIRE(client.last().binary);
+			REQUIRE(client.last().data == std::vector<uint8_t>(data, data + sizeof(data)));
+		}
+
+		TEST_CASE("Hello")
+		{
+			handle(makeFrame({magicHello}));
+			auto& reply = client.last();
+			REQUIRE_EQ(reply.data.size(), 16U);
+			REQUIRE_EQ(reply.word(0), magicHello);
+			REQUIRE_EQ(reply.word(1), version);
+			REQUIRE_EQ(reply.word(2), 2U);
+			REQUIRE_EQ(reply.word(3), 1024U);
+		}
+
+		TEST_CASE("Pipelined writes with window overflow")
+		{
+			// Task queue doesn't run during the test, so completions are only retired when slots are needed
+			client.frames.clear();
+			uint8_t data[6][256];
+			for(unsigned i = 0; i < 6; ++i) {
+				memset(data[i], 0x10 + i, sizeof(data[i]));
+				handle(makeFrame({magicSeqWrite, 1 + i, 0x2000 + i * 256, 256}, data[i], 256));
+			}
+			REQUIRE(client.ackedSeq() >= 3);
+
+			handle(makeFrame({magicSeqRead, 7, 0x2000 + 2 * 256, 4 * 256}));
+			REQUIRE_EQ(client.ackedSeq(), 6U);
+			auto& reply = client.last();
+			REQUIRE_EQ(reply.word(0), magicData);
+			REQUIRE_EQ(reply.word(1), 7U);
+			REQUIRE_EQ(reply.word(2), uint32_t(Status::ok));
+			REQUIRE_EQ(reply.data.size(), 12 + 4 * 256U);
+			REQUIRE(memcmp(&reply.data[12], data[2], 4 * 256) == 0);
+			REQUIRE(memcmp(&mem[0x2000], data, sizeof(data)) == 0);
+		}
+
+		TEST_CASE("Bad frames")
+		{
+			const uint8_t junk[]{0xde, 0xad, 0xbe, 0xef, 0x00};
+			bridge.handleFrame(junk, sizeof(junk));
+			REQUIRE(client.last().isText("Bad frame"));
+
+			// Length field disagrees with frame size
+			handle(makeFrame({magicSeqWrite, 8, 0x3000, 8}, junk, 4));
+			REQUIRE_EQ(client.last().word(0), magicAck);
+			REQUIRE_EQ(client.last().word(1), 8U);
+			REQUIRE_EQ(client.last().word(2), uint32_t(Status::badFrame));
+
+			// Larger than maxPayload
+			std::vector<uint8_t> big(2048);
+			handle(makeFrame({magicSeqWrite, 9, 0x3000, uint32_t(big.size())}, big.data(), big.size()));
+			REQUIRE_EQ(client.last().word(2), uint32_t(Status::badFrame));
+
+			// Outside device memory
+			handle(makeFrame({magicSeqWrite, 10, EVE_MEMORY_SIZE - 2, 4}, junk, 4));
+			REQUIRE_EQ(client.last().word(2), uint32_t(Status::badAddress));
+
+			handle(makeFrame({magicRead, EVE_MEMORY_SIZE, 4}));
+			REQUIRE(client.last().isText("Bad address"));
+		}
+
+		TEST_CASE("FIFO writes")
+		{
+			const uint32_t commands[]{MAKE_COPROC_CMD_WORD(CMD_MEMSET), 0x4000, 0x5a, 16};
+			handle(makeFrame({magicSeqWrite, 11, REG_CMDB_WRITE, sizeof(commands)}, commands, sizeof(commands)));
+			REQUIRE_EQ(client.last().word(0), magicAck);
+			REQUIRE_EQ(client.last().word(1), 11U);
+			REQUIRE_EQ(client.last().word(2), uint32_t(Status::ok));
+			REQUIRE(fixture.display.waitCommandsIdle());
+			REQUIRE_EQ(mem[0x400f], 0x5a);
+
+			// Co-processor commands are whole words
+			handle(makeFrame({magicSeqWrite, 12, REG_CMDB_WRITE, 6}, commands, 6));
+			REQUIRE_EQ(client.last().word(2), uint32_t(Status::badAddress));
+
+			handle(makeFrame({magicWrite, REG_CMDB_WRITE, sizeof(commands)}, commands, sizeof(commands)));
+			REQUIRE(client.last().isText("OK"));
+		}
+
+		TEST_CASE("Destroy with completion queued")
+		{
+			// Retire task is still queued when the bridge goes away, and must not touch it
+			Client other;
+			auto temp = new Bridge(fixture.display, other.getDelegate(), 2, 256);
+			const uint32_t word{0x12345678};
+			auto frame = makeFrame({magicSeqWrite, 1, 0x5000, 4}, &word, 4);
+			temp->handleFrame(frame.data(), frame.size());
+			delete temp;
+		}
+	}
+
+private:
+	Fixture fixture;
+};
+
+void REGISTER_TEST(Bridge)
+{
+	registerGroup<BridgeTest>();
+}
@@ -0,0 +1,84 @@
+#include <EveTest.h>
+#include <Graphics/EVE/BusScheduler.h>
+
+using namespace EveTest;
+
+/*
+ * Frames are written in chunks which may split a command, so nothing else may be written
+ * to the FIFO between the first and last chunk.
+ */
+class BusSchedulerTest : public TestGroup
+{
+public:
+	BusSchedulerTest() : TestGroup(_F("BusScheduler"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(fixture.begin());
+
+		TEST_CASE("Chunk size")
+		{
+			BusScheduler bad(4, 1022);
+			REQUIRE(!bad.attach(fixture.display));
+		}
+
+		TEST_CASE("FIFO locked during frame")
+		{
+			list.addCommand(CMD_DLSTART);
+			list.add(CLEAR_COLOR_RGB(0, 0, 80));
+			list.add(CLEAR(true, true, true));
+			// Each 64-byte chunk ends part-way through a command
+			for(unsigned i = 0; i < 20; ++i) {
+				list.addCommand(CMD_MEMSET, 0x1000 + i * 4, 0x11 * i, 4);
+			}
+			list.add(DISPLAY());
+			list.addCommand(CMD_SWAP);
+
+			REQUIRE(scheduler.attach(fixture.display));
+			REQUIRE(scheduler.sendFrame(fixture.display, list, [this](bool success) { frameComplete(success); }));
+			// REG_CMDB_SPACE has been requested, so FIFO space must not be taken before the first chunk
+			REQUIRE(fixture.display.isCommandsLocked());
+			const uint32_t word = MAKE_COPROC_CMD_WORD(CMD_LOADIDENTITY);
+			REQUIRE(!fixture.display.sendCommands(&word, 1));
+			// Deadline ahead of the frame so this is sent between its chunks
+			REQUIRE(scheduler.upload(
+				fixture.display, 0x2000, data, sizeof(data), [this](bool success) { uploadComplete(success); }, 0));
+			pending();
+		}
+	}
+
+	void uploadComplete(bool success)
+	{
+		CHECK(success);
+		CHECK(fixture.display.isCommandsLocked());
+		const uint32_t word = MAKE_COPROC_CMD_WORD(CMD_LOADIDENTITY);
+		CHECK(!fixture.display.sendCommands(&word, 1));
+		uploaded = true;
+	}
+
+	void frameComplete(bool success)
+	{
+		CHECK(uploaded);
+		CHECK(success);
+		CHECK(!fixture.display.isCommandsLocked());
+		CHECK(fixture.display.waitCommandsIdle());
+		auto mem = fixture.emulator.getMemory();
+		CHECK_EQ(mem[0x1000 + 19 * 4], uint8_t(0x11 * 19));
+		CHECK(scheduler.getStats(fixture.display)->chunks > 2);
+		complete();
+	}
+
+private:
+	Fixture fixture;
+	BusScheduler scheduler{4, 64};
+	CommandList list{128};
+	uint8_t data[16]{};
+	bool uploaded{false};
+};
+
+void REGISTER_TEST(BusScheduler)
+{
+	registerGroup<BusSchedulerTest>();
+}
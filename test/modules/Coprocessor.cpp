@@ -0,0 +1,233 @@
+#include <EveTest.h>
+
+using namespace EveTest;
+
+namespace
+{
+// zlib stream for 1024 bytes of (i % 61)
+const uint8_t deflated[]{
+	0x78, 0xda, 0x63, 0x60, 0x64, 0x62, 0x66, 0x61, 0x65, 0x63, 0xe7, 0xe0, 0xe4, 0xe2, 0xe6, 0xe1,
+	0xe5, 0xe3, 0x17, 0x10, 0x14, 0x12, 0x16, 0x11, 0x15, 0x13, 0x97, 0x90, 0x94, 0x92, 0x96, 0x91,
+	0x95, 0x93, 0x57, 0x50, 0x54, 0x52, 0x56, 0x51, 0x55, 0x53, 0xd7, 0xd0, 0xd4, 0xd2, 0xd6, 0xd1,
+	0xd5, 0xd3, 0x37, 0x30, 0x34, 0x32, 0x36, 0x31, 0x35, 0x33, 0xb7, 0xb0, 0xb4, 0xb2, 0xb6, 0x61,
+	0x18, 0xd5, 0x3c, 0xaa, 0x79, 0x54, 0xf3, 0x50, 0xd6, 0x0c, 0x00, 0x6e, 0x0d, 0x76, 0xc9,
+};
+constexpr uint32_t inflatedSize{1024};
+constexpr uint32_t inflatedCrc{0xc475e9a0};
+
+/**
+ * @brief Append data following a command, zero-padded to a whole number of words
+ */
+void addBytes(CommandList& list, const void* data, size_t length)
+{
+	auto bytes = static_cast<const uint8_t*>(data);
+	for(size_t i = 0; i < length; i += 4) {
+		uint32_t word{0};
+		memcpy(&word, &bytes[i], std::min(length - i, size_t(4)));
+		list.add(word);
+	}
+}
+
+} // namespace
+
+class CoprocessorTest : public TestGroup
+{
+public:
+	CoprocessorTest() : TestGroup(_F("Coprocessor"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(fixture.begin());
+		auto mem = fixture.emulator.getMemory();
+
+		TEST_CASE("Memory commands")
+		{
+			uint8_t data[301];
+			for(unsigned i = 0; i < sizeof(data); ++i) {
+				data[i] = i * 13;
+			}
+			CommandList list(256);
+			list.addCommand(CMD_MEMWRITE, 0x1000, sizeof(data));
+			addBytes(list, data, sizeof(data));
+			list.addCommand(CMD_MEMCPY, 0x2000, 0x1000, sizeof(data));
+			list.addCommand(CMD_MEMSET, 0x2000, 0x55, 10);
+			list.addCommand(CMD_MEMZERO, 0x1000, 4);
+			list.addCommand(CMD_MEMCRC, 0x2010, 100, 0);
+			REQUIRE(fixture.run(list));
+
+			REQUIRE(memcmp(&mem[0x1004], &data[4], sizeof(data) - 4) == 0);
+			REQUIRE_EQ(mem[0x1003], 0);
+			REQUIRE_EQ(mem[0x2009], 0x55);
+			REQUIRE(memcmp(&mem[0x200a], &data[10], sizeof(data) - 10) == 0);
+			REQUIRE_EQ(fixture.result(1), crc32(&data[0x10], 100));
+		}
+
+		TEST_CASE("CMD_INFLATE")
+		{
+			CommandList list(64);
+			list.addCommand(CMD_INFLATE, 0x10000);
+			addBytes(list, deflated, sizeof(deflated));
+			list.addCommand(CMD_GETPTR, 0);
+			REQUIRE(fixture.run(list));
+			REQUIRE_EQ(fixture.result(1), 0x10000 + inflatedSize);
+			REQUIRE_EQ(crc32(&mem[0x10000], inflatedSize), inflatedCrc);
+		}
+
+		TEST_CASE("Matrix")
+		{
+			CommandList list(32);
+			list.addCommand(CMD_LOADIDENTITY);
+			list.addCommand(CMD_TRANSLATE, 50 << 16, 20 << 16);
+			list.addCommand(CMD_SCALE, 2 << 16, 2 << 16);
+			list.addCommand(CMD_GETMATRIX, 0, 0, 0, 0, 0, 0);
+			REQUIRE(fixture.run(list));
+			const uint32_t expected[]{2 << 16, 0, 50 << 16, 0, 2 << 16, 20 << 16};
+			for(unsigned i = 0; i < 6; ++i) {
+				REQUIRE_EQ(fixture.result(6 - i), expected[i]);
+			}
+		}
+
+		TEST_CASE("CMD_SETBITMAP 800x480")
+		{
+			// Stride (1600) and width (800) need the high bits carried by the _H variants
+			CommandList list(16);
+			list.addCommand(CMD_DLSTART);
+			list.addCommand(CMD_SETBITMAP, 0x20000, MAKE_COPROC_PARAM16(BMF_RGB565, width), height);
+			REQUIRE(fixture.run(list));
+			REQUIRE_EQ(fixture.display.read32(REG_CMD_DL), 5 * 4U);
+
+			uint32_t words[5];
+			fixture.display.read(EVE_RAM_DL, words, sizeof(words));
+			const uint32_t expected[]{
+				0x01020000, // BITMAP_SOURCE(0x20000)
+				0x073c81e0, // BITMAP_LAYOUT(RGB565, 1600 & 0x3ff, 480)
+				0x28000004, // BITMAP_LAYOUT_H: stride bits 11:10 = 1
+				0x080241e0, // BITMAP_SIZE(NEAREST, BORDER, BORDER, 800 & 0x1ff, 480)
+				0x29000004, // BITMAP_SIZE_H: width bits 10:9 = 1
+			};
+			for(unsigned i = 0; i < ARRAY_SIZE(expected); ++i) {
+				REQUIRE_EQ(words[i], expected[i]);
+			}
+
+			// Rows of a full-screen bitmap must line up
+			for(unsigned y = 0; y < 2; ++y) {
+				for(unsigned x = 0; x < width; ++x) {
+					uint16_t pixel = (x == 700) ? 0xf800 : 0;
+					memcpy(&mem[0x20000 + (y * width + x) * 2], &pixel, 2);
+				}
+			}
+			list.clear();
+			list.add(BITMAP_HANDLE(2));
+			list.addCommand(CMD_SETBITMAP, 0x20000, MAKE_COPROC_PARAM16(BMF_RGB565, width), height);
+			list.add(BEGIN(GP_BITMAPS));
+			list.add(VERTEX2II(0, 0, 2, 0));
+			list.add(END());
+			list.add(DISPLAY());
+			list.addCommand(CMD_SWAP);
+			list.addCommand(CMD_DLSTART);
+			REQUIRE(fixture.run(list));
+			renderer.render(fixture.emulator);
+			REQUIRE_EQ(renderer.getPixel(700, 1), 0xff0000U);
+			REQUIRE_EQ(renderer.getPixel(124, 1), 0U);
+		}
+
+		TEST_CASE("Widget frame")
+		{
+			auto swaps = fixture.emulator.getSwapCount();
+			CommandList list(256);
+			list.addCommand(CMD_DLSTART);
+			list.add(CLEAR_COLOR_RGB(30, 30, 30));
+			list.add(CLEAR(true, true, true));
+			list.addCommand(CMD_GRADIENT, MAKE_COPROC_PARAM16(0, 0), 0x000040, MAKE_COPROC_PARAM16(800, 0), 0x004000);
+			list.addCommand(CMD_FGCOLOR, 0x0060c0);
+			list.addCommand(CMD_BUTTON, MAKE_COPROC_PARAM16(20, 20), MAKE_COPROC_PARAM16(160, 50),
+							MAKE_COPROC_PARAM16(28, 0));
+			list.addString("Button");
+			list.addCommand(CMD_PROGRESS, MAKE_COPROC_PARAM16(20, 340), MAKE_COPROC_PARAM16(300, 12),
+							MAKE_COPROC_PARAM16(0, 70), MAKE_COPROC_PARAM16(100, 0));
+			list.addCommand(CMD_SLIDER, MAKE_COPROC_PARAM16(20, 300), MAKE_COPROC_PARAM16(300, 12),
+							MAKE_COPROC_PARAM16(0, 40), MAKE_COPROC_PARAM16(100, 0));
+			list.addCommand(CMD_GAUGE, MAKE_COPROC_PARAM16(500, 200), MAKE_COPROC_PARAM16(100, 0),
+							MAKE_COPROC_PARAM16(10, 5), MAKE_COPROC_PARAM16(30, 100));
+			list.add(DISPLAY());
+			list.addCommand(CMD_SWAP);
+			REQUIRE(fixture.run(list));
+			REQUIRE_EQ(fixture.emulator.getSwapCount(), swaps + 1);
+
+			renderer.render(fixture.emulator);
+			REQUIRE_EQ(renderer.getPixel(100, 45), 0x0060c0U);
+			REQUIRE(checkGolden("widgets", renderer, 0xa4003dcc));
+		}
+
+		TEST_CASE("FIFO progress")
+		{
+			using Progress = EveDisplay::FifoProgress;
+			REQUIRE(EveDisplay::getFifoProgress(0x100, 0x080, 0x200) == Progress::pending);
+			REQUIRE(EveDisplay::getFifoProgress(0x100, 0x100, 0x200) == Progress::passed);
+			REQUIRE(EveDisplay::getFifoProgress(0x100, 0x180, 0x200) == Progress::passed);
+			REQUIRE(EveDisplay::getFifoProgress(0x010, 0xff0, 0x020) == Progress::pending);
+			REQUIRE(EveDisplay::getFifoProgress(0x1010, 0x010, 0x010) == Progress::passed);
+			REQUIRE(EveDisplay::getFifoProgress(0x100, EVE_CMDFIFO_FAULT, 0x200) == Progress::fault);
+
+			CommandList list(8);
+			list.addCommand(CMD_MEMCRC, 0x1000, 64, 0);
+			REQUIRE(fixture.display.sendCommands(list));
+			auto mark = fixture.display.getFifoPosition();
+			REQUIRE(fixture.display.waitCommandsIdle());
+			REQUIRE(fixture.display.getFifoProgress(mark) == Progress::passed);
+			REQUIRE_EQ(fixture.display.readResult(mark), crc32(&mem[0x1000], 64));
+		}
+
+		TEST_CASE("In-band register write")
+		{
+			auto& display = fixture.display;
+			display.write8(REG_PWM_DUTY, 128);
+			CommandList list(6);
+			display.setStream(&list);
+			REQUIRE(display.writeInBand(REG_PWM_DUTY, 64));
+			// A full stream must not fall back to writing the register out of order
+			REQUIRE(!display.writeInBand(REG_PWM_DUTY, 32));
+			display.setStream(nullptr);
+			REQUIRE_EQ(fixture.emulator.getRegister(REG_PWM_DUTY), 128U);
+
+			// List is discarded, so a direct write of the same value must not be elided
+			display.write8(REG_PWM_DUTY, 64);
+			REQUIRE_EQ(fixture.emulator.getRegister(REG_PWM_DUTY), 64U);
+
+			list.clear();
+			display.write8(REG_PWM_DUTY, 128);
+			display.setStream(&list);
+			REQUIRE(display.writeInBand(REG_PWM_DUTY, 64));
+			display.setStream(nullptr);
+			REQUIRE(fixture.run(list));
+			REQUIRE_EQ(fixture.emulator.getRegister(REG_PWM_DUTY), 64U);
+			REQUIRE_EQ(display.read8(REG_PWM_DUTY), 64);
+		}
+
+		TEST_CASE("Fault recovery")
+		{
+			auto faults = fixture.display.getStats().coproFaults;
+			CommandList list(8);
+			list.addCommand(CMD_LOADIMAGE, 0, 0);
+			fixture.display.sendCommands(list);
+			REQUIRE(fixture.display.checkFault());
+			REQUIRE_EQ(fixture.display.getStats().coproFaults, faults + 1);
+
+			list.clear();
+			list.addCommand(CMD_MEMSET, 0x3000, 0xaa, 4);
+			REQUIRE(fixture.run(list));
+			REQUIRE_EQ(mem[0x3003], 0xaa);
+		}
+	}
+
+private:
+	Fixture fixture;
+	Renderer renderer;
+};
+
+void REGISTER_TEST(Coprocessor)
+{
+	registerGroup<CoprocessorTest>();
+}
@@ -0,0 +1,91 @@
+#include <EveTest.h>
+#include <Graphics/EVE/Decoder.h>
+
+using namespace EveTest;
+
+namespace
+{
+class Collector : public Decoder::Handler
+{
+public:
+	void command(const Decoder::Command& cmd) override
+	{
+		++commands;
+		lastLength = cmd.length;
+		lastPayloadLength = cmd.payloadLength;
+	}
+
+	void issue(const Decoder::Command* cmd, uint32_t offset, Decoder::Issue issue) override
+	{
+		++issues;
+		lastIssue = issue;
+	}
+
+	unsigned commands{0};
+	unsigned issues{0};
+	uint32_t lastLength{0};
+	uint32_t lastPayloadLength{0};
+	Decoder::Issue lastIssue{};
+};
+
+} // namespace
+
+class DecoderTest : public TestGroup
+{
+public:
+	DecoderTest() : TestGroup(_F("Decoder"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("Word-aligned CMD_MEMWRITE at end of stream")
+		{
+			const uint32_t stream[]{0xffffff1a, 0, 4, 0x12345678};
+			Collector collector;
+			Decoder decoder(Decoder::Source::commands, &collector);
+			REQUIRE_EQ(decoder.decode(stream, sizeof(stream)), sizeof(stream));
+			decoder.finish();
+			REQUIRE_EQ(collector.issues, 0U);
+			REQUIRE_EQ(collector.commands, 1U);
+			REQUIRE_EQ(collector.lastLength, 16U);
+		}
+
+		TEST_CASE("Padded CMD_MEMWRITE")
+		{
+			const uint32_t stream[]{0xffffff1a, 0, 5, 0x04030201, 0x00000005};
+			Collector collector;
+			Decoder decoder(Decoder::Source::commands, &collector);
+			REQUIRE_EQ(decoder.decode(stream, sizeof(stream)), sizeof(stream));
+			decoder.finish();
+			REQUIRE_EQ(collector.issues, 0U);
+			REQUIRE_EQ(collector.lastLength, 20U);
+			REQUIRE_EQ(collector.lastPayloadLength, 5U);
+		}
+
+		TEST_CASE("Truncated CMD_MEMWRITE")
+		{
+			const uint32_t stream[]{0xffffff1a, 0, 5, 0x04030201};
+			Collector collector;
+			Decoder decoder(Decoder::Source::commands, &collector);
+			REQUIRE_EQ(decoder.decode(stream, sizeof(stream)), 0U);
+			decoder.finish();
+			REQUIRE_EQ(collector.issues, 1U);
+			REQUIRE(collector.lastIssue == Decoder::Issue::truncated);
+		}
+
+		TEST_CASE("Oversized length parameter")
+		{
+			const uint32_t stream[]{0xffffff1a, 0, 0xfffffffe, 0};
+			Collector collector;
+			Decoder decoder(Decoder::Source::commands, &collector);
+			REQUIRE_EQ(decoder.decode(stream, sizeof(stream)), 0U);
+			REQUIRE_EQ(collector.commands, 0U);
+		}
+	}
+};
+
+void REGISTER_TEST(Decoder)
+{
+	registerGroup<DecoderTest>();
+}
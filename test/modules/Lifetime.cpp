@@ -0,0 +1,80 @@
+#include <EveTest.h>
+#include <Graphics/EVE/BusScheduler.h>
+#include <Graphics/EVE/Results.h>
+#include <Graphics/EVE/Screenshot.h>
+
+using namespace EveTest;
+
+namespace
+{
+class NullOutput : public Print
+{
+public:
+	size_t write(const uint8_t* buffer, size_t size) override
+	{
+		return size;
+	}
+};
+
+} // namespace
+
+/*
+ * Request completions continue in a queued task. These objects are destroyed whilst such a task
+ * is pending, which must not then touch them when it runs.
+ */
+class LifetimeTest : public TestGroup
+{
+public:
+	LifetimeTest() : TestGroup(_F("Lifetime"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(fixture.begin());
+
+		TEST_CASE("BusScheduler")
+		{
+			static uint8_t data[4096];
+			auto scheduler = new BusScheduler;
+			REQUIRE(scheduler->attach(fixture.display));
+			REQUIRE(scheduler->upload(fixture.display, 0x1000, data, sizeof(data)));
+			delete scheduler;
+		}
+
+		TEST_CASE("Screenshot")
+		{
+			NullOutput output;
+			auto screenshot = new Screenshot(fixture.display);
+			Screenshot::Config config{};
+			config.scratchAddress = 0x80000;
+			REQUIRE(screenshot->begin(output, config, nullptr));
+			delete screenshot;
+		}
+
+		TEST_CASE("ResultQueue")
+		{
+			auto results = new ResultQueue(fixture.display);
+			REQUIRE(results->getPtr(nullptr));
+			delete results;
+		}
+
+		TEST_CASE("Emulator")
+		{
+			auto emulated = new Fixture;
+			REQUIRE(emulated->begin());
+			emulated->emulator.onInterrupt([]() {});
+			emulated->display.enableInterrupts(EVE_INT_SWAP);
+			emulated->display.write8(REG_DLSWAP, EVE_DLSWAP_FRAME);
+			delete emulated;
+		}
+	}
+
+private:
+	Fixture fixture;
+};
+
+void REGISTER_TEST(Lifetime)
+{
+	registerGroup<LifetimeTest>();
+}
@@ -0,0 +1,74 @@
+#include <EveTest.h>
+#include <Graphics/EVE/PngWriter.h>
+
+using namespace EveTest;
+
+namespace
+{
+/**
+ * @brief Output which drops one write, or none by default
+ */
+class DroppingOutput : public Print
+{
+public:
+	DroppingOutput(unsigned dropIndex = ~0U) : dropIndex(dropIndex)
+	{
+	}
+
+	size_t write(const uint8_t* buffer, size_t size) override
+	{
+		return (writeCount++ == dropIndex) ? 0 : size;
+	}
+
+	unsigned dropIndex;
+	unsigned writeCount{0};
+};
+
+constexpr uint16_t imageWidth{4};
+constexpr uint16_t imageHeight{2};
+
+bool writeImage(Print& out)
+{
+	const uint8_t rgb[imageWidth * 3]{};
+	PngWriter png(out, imageWidth, imageHeight);
+	if(!png.begin()) {
+		return false;
+	}
+	for(unsigned i = 0; i < imageHeight; ++i) {
+		if(!png.writeRow(rgb)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+class PngWriterTest : public TestGroup
+{
+public:
+	PngWriterTest() : TestGroup(_F("PngWriter"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("Output errors")
+		{
+			DroppingOutput out;
+			REQUIRE(writeImage(out));
+
+			// Any write which fails, including those within a chunk, must be reported
+			const unsigned writeCount = out.writeCount;
+			for(unsigned i = 0; i < writeCount; ++i) {
+				DroppingOutput failing(i);
+				REQUIRE(!writeImage(failing));
+			}
+		}
+	}
+};
+
+void REGISTER_TEST(PngWriter)
+{
+	registerGroup<PngWriterTest>();
+}
@@ -0,0 +1,82 @@
+#include <EveTest.h>
+
+using namespace EveTest;
+
+namespace
+{
+// As generated by tools/blob.py: sets REG_PWM_DUTY using CMD_MEMWRITE
+DEFINE_FSTR_ARRAY_LOCAL(blob, uint32_t, MAKE_COPROC_CMD_WORD(CMD_MEMWRITE), REG_PWM_DUTY, 4, 90)
+
+} // namespace
+
+/*
+ * The shadow copy decides whether register writes reach the device and serves reads,
+ * so these check the emulator rather than reading back through the cache.
+ */
+class RegisterCacheTest : public TestGroup
+{
+public:
+	RegisterCacheTest() : TestGroup(_F("RegisterCache"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(fixture.begin());
+		auto& display = fixture.display;
+		auto& emulator = fixture.emulator;
+
+		TEST_CASE("Elided writes and cached reads")
+		{
+			auto stats = display.getStats();
+			display.write8(REG_PWM_DUTY, 10);
+			display.write8(REG_PWM_DUTY, 10);
+			REQUIRE_EQ(display.getStats().elidedWrites, stats.elidedWrites + 1);
+			REQUIRE_EQ(display.read8(REG_PWM_DUTY), 10);
+			REQUIRE_EQ(display.getStats().cachedReads, stats.cachedReads + 1);
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_DUTY), 10U);
+		}
+
+		TEST_CASE("Staged writes")
+		{
+			display.setRegister(REG_PWM_HZ, 300);
+			display.setRegister(REG_PWM_DUTY, 20);
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_DUTY), 10U);
+			display.flushRegisters();
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_HZ), 300U);
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_DUTY), 20U);
+		}
+
+		TEST_CASE("Staged writes survive co-processor fault")
+		{
+			display.setRegister(REG_PWM_DUTY, 77);
+			CommandList list(8);
+			list.addCommand(CMD_LOADIMAGE, 0, 0);
+			display.sendCommands(list);
+			REQUIRE(display.checkFault());
+			display.flushRegisters();
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_DUTY), 77U);
+		}
+
+		TEST_CASE("Boot blob flushes staged writes")
+		{
+			display.setRegister(REG_PWM_HZ, 500);
+			display.setRegister(REG_PWM_DUTY, 30);
+			REQUIRE(display.sendCommands(blob));
+			REQUIRE(display.waitCommandsIdle());
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_HZ), 500U);
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_DUTY), 90U);
+			// Value written by the blob must not be elided from the cache
+			display.write8(REG_PWM_DUTY, 30);
+			REQUIRE_EQ(emulator.getRegister(REG_PWM_DUTY), 30U);
+		}
+	}
+
+private:
+	Fixture fixture;
+};
+
+void REGISTER_TEST(RegisterCache)
+{
+	registerGroup<RegisterCacheTest>();
+}
@@ -0,0 +1,154 @@
+#include <EveTest.h>
+
+using namespace EveTest;
+
+namespace
+{
+constexpr uint32_t background{0x141428};
+
+void addVertex(CommandList& list, int16_t x, int16_t y)
+{
+	list.add(VERTEX2F(x * 16, y * 16));
+}
+
+} // namespace
+
+class RendererTest : public TestGroup
+{
+public:
+	RendererTest() : TestGroup(_F("Renderer"))
+	{
+	}
+
+	void execute() override
+	{
+		TEST_CASE("Primitives")
+		{
+			CommandList list(64);
+			list.add(CLEAR_COLOR_RGB(0x14, 0x14, 0x28));
+			list.add(CLEAR(true, true, true));
+			list.add(COLOR_RGB(255, 0, 0));
+			list.add(LINE_WIDTH(64));
+			list.add(BEGIN(GP_RECTS));
+			addVertex(list, 10, 300);
+			addVertex(list, 200, 400);
+			list.add(END());
+			list.add(COLOR_RGB(255, 255, 0));
+			list.add(POINT_SIZE(320));
+			list.add(BEGIN(GP_POINTS));
+			addVertex(list, 400, 350);
+			list.add(END());
+			list.add(COLOR_RGB(0, 128, 255));
+			list.add(LINE_WIDTH(24));
+			list.add(BEGIN(GP_LINES));
+			addVertex(list, 500, 300);
+			addVertex(list, 780, 470);
+			list.add(END());
+			list.add(COLOR_RGB(255, 255, 255));
+			list.add(BEGIN(GP_EDGE_STRIP_B));
+			addVertex(list, 0, 440);
+			addVertex(list, 400, 420);
+			addVertex(list, 800, 460);
+			list.add(END());
+			list.add(DISPLAY());
+
+			renderer.render(list.data(), emulator.getMemory());
+			REQUIRE_EQ(renderer.getPixel(790, 10), background);
+			REQUIRE_EQ(renderer.getPixel(100, 350), 0xff0000U);
+			REQUIRE_EQ(renderer.getPixel(400, 350), 0xffff00U);
+			REQUIRE_EQ(renderer.getPixel(400, 470), 0xffffffU);
+			REQUIRE(checkGolden("primitives", renderer, 0xb9a06b75));
+		}
+
+		TEST_CASE("L8 bitmap")
+		{
+			auto mem = emulator.getMemory();
+			for(unsigned y = 0; y < 64; ++y) {
+				for(unsigned x = 0; x < 64; ++x) {
+					mem[y * 64 + x] = x * 4;
+				}
+			}
+
+			CommandList list(64);
+			list.add(CLEAR(true, true, true));
+			list.add(BITMAP_HANDLE(1));
+			list.add(BITMAP_SOURCE(0));
+			list.add(BITMAP_LAYOUT(BMF_L8, 64, 64));
+			list.add(BITMAP_SIZE(BitmapFilter::NEAREST, BitmapWrap::BORDER, BitmapWrap::BORDER, 64, 64));
+			list.add(BEGIN(GP_BITMAPS));
+			list.add(VERTEX2II(100, 100, 1, 0));
+			list.add(END());
+			list.add(DISPLAY());
+
+			renderer.render(list.data(), mem);
+			REQUIRE_EQ(renderer.getPixel(110, 105), 0x282828U);
+			REQUIRE_EQ(renderer.getPixel(99, 105), 0U);
+			REQUIRE_EQ(renderer.getPixel(164, 105), 0U);
+			REQUIRE(checkGolden("bitmap", renderer, 0xa8f26bac));
+		}
+
+		TEST_CASE("Stencil and tag")
+		{
+			CommandList list(64);
+			list.add(CLEAR_TAG(0));
+			list.add(CLEAR(true, true, true));
+			list.add(STENCIL_OP(StencilOp::INCR, StencilOp::INCR));
+			list.add(COLOR_MASK(false, false, false, false));
+			list.add(BEGIN(GP_RECTS));
+			addVertex(list, 100, 100);
+			addVertex(list, 300, 300);
+			addVertex(list, 200, 200);
+			addVertex(list, 400, 400);
+			list.add(END());
+			list.add(COLOR_MASK(true, true, true, true));
+			list.add(STENCIL_OP(StencilOp::KEEP, StencilOp::KEEP));
+			list.add(STENCIL_FUNC(TestFunction::EQUAL, 2, 0xff));
+			list.add(TAG(7));
+			list.add(COLOR_RGB(0, 255, 0));
+			list.add(BEGIN(GP_RECTS));
+			addVertex(list, 0, 0);
+			addVertex(list, 800, 480);
+			list.add(END());
+			list.add(DISPLAY());
+
+			renderer.render(list.data(), emulator.getMemory());
+			REQUIRE_EQ(renderer.getStencil(150, 150), 1);
+			REQUIRE_EQ(renderer.getStencil(250, 250), 2);
+			REQUIRE_EQ(renderer.getPixel(150, 150), 0U);
+			REQUIRE_EQ(renderer.getPixel(250, 250), 0x00ff00U);
+			REQUIRE_EQ(renderer.getTag(250, 250), 7);
+			REQUIRE_EQ(renderer.getTag(50, 50), 0);
+			REQUIRE(checkGolden("stencil", renderer, 0x7712ecbc));
+		}
+
+		TEST_CASE("Line cost")
+		{
+			// Full-width rectangles stacked over the middle lines exceed the per-line budget
+			CommandList list(64);
+			list.add(CLEAR(true, true, true));
+			list.add(BEGIN(GP_RECTS));
+			for(unsigned i = 0; i < 4; ++i) {
+				addVertex(list, 0, 200);
+				addVertex(list, 799, 279);
+			}
+			list.add(END());
+			list.add(DISPLAY());
+
+			renderer.render(list.data(), emulator.getMemory());
+			auto& cost = renderer.getCost();
+			REQUIRE_EQ(cost.primitives.size(), 2U);
+			REQUIRE_EQ(cost.maxLineCost, 4 * 800U);
+			REQUIRE_EQ(cost.linesOverBudget, 80);
+			REQUIRE_EQ(cost.lineCost[100], 0U);
+		}
+	}
+
+private:
+	Emulator emulator;
+	Renderer renderer;
+};
+
+void REGISTER_TEST(Renderer)
+{
+	registerGroup<RendererTest>();
+}
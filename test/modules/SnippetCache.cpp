@@ -0,0 +1,110 @@
+#include <EveTest.h>
+#include <Graphics/EVE/SnippetCache.h>
+
+using namespace EveTest;
+
+namespace
+{
+void addButton(CommandList& list, int16_t x, const char* text)
+{
+	list.addCommand(CMD_FGCOLOR, 0x0060c0);
+	list.addCommand(CMD_BUTTON, MAKE_COPROC_PARAM16(x, 20), MAKE_COPROC_PARAM16(160, 50), MAKE_COPROC_PARAM16(28, 0));
+	list.addString(text);
+}
+
+void beginList(CommandList& list)
+{
+	list.clear();
+	list.addCommand(CMD_DLSTART);
+	list.add(CLEAR_COLOR_RGB(30, 30, 30));
+	list.add(CLEAR(true, true, true));
+}
+
+void endList(CommandList& list)
+{
+	list.add(DISPLAY());
+	list.addCommand(CMD_SWAP);
+}
+
+} // namespace
+
+class SnippetCacheTest : public TestGroup
+{
+public:
+	SnippetCacheTest() : TestGroup(_F("SnippetCache"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(fixture.begin());
+
+		CommandList widgets[3]{64, 64, 64};
+		addButton(widgets[0], 20, "One");
+		addButton(widgets[1], 220, "Two");
+		addButton(widgets[2], 420, "Three");
+
+		CommandList list(256);
+		beginList(list);
+		for(auto& widget : widgets) {
+			list.add(widget.data(), widget.length());
+		}
+		endList(list);
+		REQUIRE(fixture.run(list));
+		renderer.render(fixture.emulator);
+		const auto direct = crc32(renderer.getColorBuffer(), width * height * sizeof(uint32_t));
+
+		// Room for two snippets only
+		SnippetCache cache(0x40000, 0x4000, 2);
+
+		TEST_CASE("Full cache during frame")
+		{
+			cache.beginFrame();
+			beginList(list);
+			REQUIRE(cache.add(fixture.display, list, widgets[0]));
+			REQUIRE(cache.add(fixture.display, list, widgets[1]));
+			REQUIRE(!cache.add(fixture.display, list, widgets[2]));
+			REQUIRE_EQ(cache.getCount(), 2);
+			endList(list);
+			REQUIRE(fixture.run(list));
+			renderer.render(fixture.emulator);
+			REQUIRE_EQ(crc32(renderer.getColorBuffer(), width * height * sizeof(uint32_t)), direct);
+		}
+
+		TEST_CASE("Working set exceeds cache")
+		{
+			// Every snippet was used by the last frame so nothing is gained by clearing
+			cache.beginFrame();
+			REQUIRE_EQ(cache.getCount(), 2);
+			beginList(list);
+			REQUIRE(cache.add(fixture.display, list, widgets[0]));
+			REQUIRE(!cache.add(fixture.display, list, widgets[2]));
+			endList(list);
+			REQUIRE(fixture.run(list));
+		}
+
+		TEST_CASE("Reclaim between frames")
+		{
+			cache.beginFrame();
+			REQUIRE_EQ(cache.getCount(), 0);
+			beginList(list);
+			for(auto& widget : widgets) {
+				cache.add(fixture.display, list, widget);
+			}
+			REQUIRE_EQ(cache.getCount(), 2);
+			endList(list);
+			REQUIRE(fixture.run(list));
+			renderer.render(fixture.emulator);
+			REQUIRE_EQ(crc32(renderer.getColorBuffer(), width * height * sizeof(uint32_t)), direct);
+		}
+	}
+
+private:
+	Fixture fixture;
+	Renderer renderer;
+};
+
+void REGISTER_TEST(SnippetCache)
+{
+	registerGroup<SnippetCacheTest>();
+}
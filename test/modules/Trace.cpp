@@ -0,0 +1,73 @@
+#include <EveTest.h>
+#include <Graphics/EVE/Trace.h>
+#include <Data/Stream/MemoryDataStream.h>
+#include <Clock.h>
+
+using namespace EveTest;
+
+/*
+ * Transactions recorded from one emulated display are replayed to another
+ */
+class TraceTest : public TestGroup
+{
+public:
+	TraceTest() : TestGroup(_F("Trace"))
+	{
+	}
+
+	void execute() override
+	{
+		REQUIRE(source.begin());
+		REQUIRE(target.begin());
+
+		TEST_CASE("Record and replay")
+		{
+			for(unsigned i = 0; i < sizeof(data); ++i) {
+				data[i] = i * 7;
+			}
+			TraceRecorder recorder(stream);
+			source.display.setTrace(&recorder);
+			source.display.write(0x1000, data, sizeof(data));
+			// Gap long enough to be replayed with a timer
+			auto start = micros();
+			while(micros() - start < 3000) {
+			}
+			source.display.write(0x2000, data, 16);
+			uint8_t buffer[16];
+			source.display.read(0x1000, buffer, sizeof(buffer));
+			source.display.setTrace(nullptr);
+			REQUIRE_EQ(recorder.getCount(), 3U);
+
+			TraceReplay::Options options;
+			options.verifyReads = true;
+			REQUIRE(replay.begin(stream, options, [this](bool success) { replayComplete(success); }));
+			REQUIRE(replay.isBusy());
+			pending();
+		}
+	}
+
+	void replayComplete(bool success)
+	{
+		CHECK(success);
+		auto& result = replay.getResult();
+		CHECK_EQ(result.records, 3U);
+		CHECK_EQ(result.mismatches, 0U);
+		CHECK(result.elapsed >= 3000);
+		auto mem = target.emulator.getMemory();
+		CHECK(memcmp(&mem[0x1000], data, sizeof(data)) == 0);
+		CHECK(memcmp(&mem[0x2000], data, 16) == 0);
+		complete();
+	}
+
+private:
+	Fixture source;
+	Fixture target;
+	MemoryDataStream stream;
+	TraceReplay replay{target.display};
+	uint8_t data[256];
+};
+
+void REGISTER_TEST(Trace)
+{
+	registerGroup<TraceTest>();
+}
@@ -0,0 +1,155 @@
+'''Build a boot blob from a payload trace
+
+Run the application's setup once (on hardware, or a Host build with the emulator) with a
+payload-mode EVE::TraceRecorder attached after `EveDisplay::begin()`, and stopped once setup is
+complete. This tool converts the writes in that trace into a single co-processor command stream:
+
+- FIFO writes (REG_CMDB_WRITE) are copied as-is
+- Contiguous RAM_G writes are merged and sent using CMD_INFLATE, CMD_MEMWRITE or CMD_MEMZERO,
+  whichever is smallest
+- Register and RAM_DL writes become CMD_MEMWRITE
+
+Reads are dropped. Ordering is preserved so commands which use uploaded data still work.
+Replay the result with `EveDisplay::sendCommands(const FSTR::Array<uint32_t>&)`.
+
+Usage:
+
+    python3 blob.py setup.bin --header bootBlob > BootBlob.h
+    python3 blob.py setup.bin --output blob.bin
+'''
+import argparse
+import struct
+import sys
+import zlib
+import eve
+from eve import align
+import trace
+
+RAM_G_END = eve.EVE_RAM_G_SIZE
+RAM_DL_END = eve.EVE_RAM_DL + eve.EVE_RAM_DL_SIZE
+RAM_REG_END = eve.EVE_RAM_REG + 0x1000
+
+# Writes which only make sense as part of legacy FIFO handling
+UNSUPPORTED = {eve.REG.CMD_READ, eve.REG.CMD_WRITE, eve.REG.CPURESET}
+
+
+def cmd(code: int, *params: int) -> bytes:
+    return struct.pack(f'<{1 + len(params)}L', 0xffffff00 | code, *params)
+
+
+def pad(data: bytes) -> bytes:
+    return data + bytes(align(len(data), 4) - len(data))
+
+
+class Builder:
+    def __init__(self, compress: bool):
+        self.compress = compress
+        self.output = bytearray()
+        self.block_addr = None
+        self.block = bytearray()
+        self.stats = {'fifo': 0, 'ram': 0, 'reg': 0}
+
+    def flush(self):
+        if not self.block:
+            return
+        addr, data = self.block_addr, bytes(self.block)
+        self.block_addr, self.block = None, bytearray()
+        if not any(data):
+            self.output += cmd(0x1C, addr, len(data)) # MEMZERO
+            return
+        raw = cmd(0x1A, addr, len(data)) + pad(data) # MEMWRITE
+        if self.compress:
+            packed = cmd(0x22, addr) + pad(zlib.compress(data, 9)) # INFLATE
+            if len(packed) < len(raw):
+                raw = packed
+        self.output += raw
+
+    def ram_write(self, addr: int, data: bytes):
+        if self.block and addr == self.block_addr + len(self.block):
+            self.block += data
+            return
+        self.flush()
+        self.block_addr, self.block = addr, bytearray(data)
+
+    def memwrite(self, addr: int, data: bytes):
+        self.flush()
+        # Registers are 32 bits, so short writes are zero-extended
+        if len(data) < 4:
+            data += bytes(4 - len(data))
+        self.output += cmd(0x1A, addr, len(data)) + pad(data)
+
+    def add(self, rec: trace.Record):
+        if rec.kind == 'read':
+            return
+        if rec.kind == 'host':
+            print(f'Skipping host command 0x{rec.command:02x}', file=sys.stderr)
+            return
+        if rec.payload is None:
+            raise ValueError('Trace has no payload data, record using Trace::Mode::payload')
+        addr = rec.address
+        if addr == eve.REG.CMDB_WRITE:
+            self.flush()
+            self.output += rec.payload
+            self.stats['fifo'] += rec.length
+        elif addr < RAM_G_END:
+            self.ram_write(addr, rec.payload)
+            self.stats['ram'] += rec.length
+        elif addr in UNSUPPORTED or eve.EVE_RAM_CMD <= addr < eve.EVE_RAM_CMD + eve.EVE_CMDFIFO_SIZE:
+            raise ValueError(f'Cannot convert write to {trace.address_name(addr)}, use REG_CMDB_WRITE')
+        elif eve.EVE_RAM_DL <= addr < RAM_DL_END or eve.EVE_RAM_REG <= addr < RAM_REG_END:
+            self.memwrite(addr, rec.payload)
+            self.stats['reg'] += rec.length
+        else:
+            raise ValueError(f'Cannot convert write to {trace.address_name(addr)}')
+
+    def finish(self) -> bytes:
+        self.flush()
+        return bytes(self.output)
+
+
+def header(name: str, source: str, data: bytes) -> str:
+    words = struct.unpack(f'<{len(data) // 4}L', data)
+    lines = [
+        f'/* Generated by tools/blob.py from {source}. Do not edit. */',
+        '',
+        '#pragma once',
+        '',
+        '#include <FlashString/Array.hpp>',
+        '',
+        f'DEFINE_FSTR_ARRAY_LOCAL({name}, uint32_t,',
+    ]
+    for i in range(0, len(words), 8):
+        sep = ',' if i + 8 < len(words) else ')'
+        lines.append('\t' + ', '.join(f'0x{w:08x}' for w in words[i:i+8]) + sep)
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert an EVE payload trace into a boot command stream')
+    parser.add_argument('input', help='Trace file')
+    parser.add_argument('--output', help='Write raw little-endian stream to file')
+    parser.add_argument('--header', metavar='NAME', help='Print C++ header defining a FlashString array')
+    parser.add_argument('--no-compress', action='store_true', help='Use CMD_MEMWRITE rather than CMD_INFLATE')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        records = list(trace.parse(f.read()))
+
+    builder = Builder(not args.no_compress)
+    for rec in records:
+        builder.add(rec)
+    data = builder.finish()
+
+    s = builder.stats
+    print(f'{len(records)} transactions: FIFO {s["fifo"]} bytes, RAM_G {s["ram"]} bytes, '
+          f'registers/DL {s["reg"]} bytes -> {len(data)} byte stream', file=sys.stderr)
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+    if args.header:
+        print(header(args.header, args.input, data))
+
+
+if __name__ == '__main__':
+    main()
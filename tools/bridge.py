@@ -0,0 +1,164 @@
+'''Pipelined client for EVE::Bridge
+
+Drop-in replacement for `test.Socket` which keeps up to `window` writes in flight instead
+of waiting for a reply to each one. Falls back to the legacy protocol if the server doesn't
+respond to `hello`.
+
+Usage:
+
+    python3 bridge.py ws://192.168.1.175/ws              Benchmark pipelined writes
+    python3 bridge.py ws://192.168.1.175/ws --legacy     Benchmark legacy writes for comparison
+
+The benchmark writes random data to RAM_G, reads it back and checks it.
+
+See `Bridge.h` for the protocol.
+'''
+import argparse
+import os
+import struct
+import time
+from websockets.sync.client import connect
+import eve
+
+MAGIC_WRITE = 0xA7B8FE30
+MAGIC_READ = 0xA7B8FE31
+MAGIC_HELLO = 0xA7B8FE32
+MAGIC_SEQ_WRITE = 0xA7B8FE33
+MAGIC_SEQ_READ = 0xA7B8FE34
+MAGIC_ACK = 0xA7B8FE35
+MAGIC_DATA = 0xA7B8FE36
+
+STATUS = ['OK', 'Bad frame', 'Bad address', 'FIFO timeout']
+
+
+class BridgeError(Exception):
+    pass
+
+
+class BridgeSocket:
+    def __init__(self, pipelined: bool = True):
+        self.pipelined = pipelined
+        self.window = 1
+        self.max_payload = 8192
+        self.seq = 0
+        self.acked = 0
+
+    def connect(self, url: str):
+        self.websocket = connect(url, max_size=None)
+        if not self.pipelined:
+            return
+        self.websocket.send(struct.pack('<L', MAGIC_HELLO))
+        rsp = self.websocket.recv()
+        if isinstance(rsp, bytes) and len(rsp) == 16:
+            magic, version, self.window, self.max_payload = struct.unpack('<LLLL', rsp)
+            print(f'Bridge v{version}, window {self.window}, max payload {self.max_payload}')
+        else:
+            print('Server does not support pipelining')
+            self.pipelined = False
+
+    def _next_seq(self) -> int:
+        self.seq = (self.seq + 1) & 0xffffffff
+        return self.seq
+
+    def _outstanding(self) -> int:
+        return (self.seq - self.acked) & 0xffffffff
+
+    def _process(self, rsp: bytes):
+        magic, seq, status = struct.unpack('<LLL', rsp[:12])
+        if status != 0:
+            raise BridgeError(f'Frame {seq} failed: {STATUS[status] if status < len(STATUS) else status}')
+        if magic == MAGIC_ACK:
+            self.acked = seq
+            return None
+        if magic == MAGIC_DATA:
+            # Reads are executed in order, so everything before has completed
+            self.acked = seq
+            return seq, rsp[12:]
+        raise BridgeError(f'Unexpected reply 0x{magic:08x}')
+
+    def flush(self):
+        '''Wait until all writes have completed'''
+        while self._outstanding() != 0:
+            self._process(self.websocket.recv())
+
+    def recv(self, addr: int, size: int) -> bytes:
+        if not self.pipelined:
+            self.websocket.send(struct.pack('<LLL', MAGIC_READ, addr, size))
+            return self.websocket.recv()
+        result = b''
+        while size > 0:
+            n = min(size, self.max_payload)
+            seq = self._next_seq()
+            self.websocket.send(struct.pack('<LLLL', MAGIC_SEQ_READ, seq, addr, n))
+            while True:
+                res = self._process(self.websocket.recv())
+                if res and res[0] == seq:
+                    result += res[1]
+                    break
+            addr += n
+            size -= n
+        return result
+
+    def send(self, addr: int, data: bytes):
+        if not self.pipelined:
+            return self._send_legacy(addr, data)
+        chunk_size = self.max_payload
+        for i in range(0, len(data), chunk_size):
+            chunk = data[i:i+chunk_size]
+            while self._outstanding() >= self.window:
+                self._process(self.websocket.recv())
+            # The FIFO address doesn't increment
+            dst = addr if addr == eve.REG.CMDB_WRITE else addr + i
+            self.websocket.send(struct.pack('<LLLL', MAGIC_SEQ_WRITE, self._next_seq(), dst, len(chunk)) + chunk)
+        return True
+
+    def _send_legacy(self, addr: int, data: bytes):
+        chunk_size = 8192
+        for i in range(0, len(data), chunk_size):
+            chunk = data[i:i+chunk_size]
+            dst = addr if addr == eve.REG.CMDB_WRITE else addr + i
+            self.websocket.send(struct.pack('<LLL', MAGIC_WRITE, dst, len(chunk)) + chunk)
+            rsp = self.websocket.recv()
+            if rsp != 'OK':
+                raise BridgeError(f'send(0x{dst:x}, {len(chunk)}) failed: {rsp}')
+        return True
+
+    def send_cmdlist(self, cmdlist: list):
+        if isinstance(cmdlist, list):
+            cmdlist = b''.join(cmdlist)
+        self.send(eve.REG.CMDB_WRITE, cmdlist)
+
+    def write_reg(self, addr: int, value: int):
+        self.send(addr, struct.pack('<L', value))
+
+
+def benchmark(url: str, size: int, pipelined: bool):
+    sock = BridgeSocket(pipelined)
+    sock.connect(url)
+    data = os.urandom(size)
+    start = time.perf_counter()
+    sock.send(0, data)
+    if sock.pipelined:
+        sock.flush()
+    elapsed = time.perf_counter() - start
+    print(f'Wrote {size} bytes in {elapsed:.3f}s, {size / elapsed / 1024:.1f} KiB/s')
+    start = time.perf_counter()
+    readback = sock.recv(0, size)
+    elapsed = time.perf_counter() - start
+    print(f'Read {size} bytes in {elapsed:.3f}s, {size / elapsed / 1024:.1f} KiB/s')
+    if readback != data:
+        raise BridgeError('Read back data does not match')
+    print('Verified OK')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='EVE bridge client benchmark')
+    parser.add_argument('url', help='Websocket URL, e.g. ws://192.168.1.175/ws')
+    parser.add_argument('--size', type=int, default=256*1024, help='Bytes to transfer')
+    parser.add_argument('--legacy', action='store_true', help='Use legacy (unpipelined) protocol')
+    args = parser.parse_args()
+    benchmark(args.url, args.size, not args.legacy)
+
+
+if __name__ == '__main__':
+    main()
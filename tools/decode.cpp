@@ -0,0 +1,204 @@
+/****
+ * decode.cpp
+ *
+ * Command-line disassembler and validator for EVE command streams, using Graphics::EVE::Decoder.
+ *
+ * Build from the library root:
+ *
+ *     g++ -O2 -std=c++17 -DARCH_HOST -Isrc/include -o eve-decode \
+ *         tools/decode.cpp src/Decoder.cpp src/Emulator/Inflate.cpp
+ *
+ * Usage:
+ *
+ *     eve-decode [--dl] [--check] [--trace] FILE...
+ *
+ *     --dl       Input is RAM_DL content rather than a co-processor command stream
+ *     --check    Report issues only, no listing
+ *     --trace    Input is an SPI trace recorded by EVE::TraceRecorder in payload mode.
+ *                All writes to REG_CMDB_WRITE and RAM_CMD are decoded as one command stream.
+ *
+ * Exit status is 1 if any issues were found.
+ *
+ ****/
+
+#include <Graphics/EVE/Decoder.h>
+#include <Graphics/EVE/EVE.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+using namespace Graphics::EVE;
+
+namespace
+{
+class Printer : public Decoder::Handler
+{
+public:
+	Printer(bool listing) : listing(listing)
+	{
+	}
+
+	void command(const Decoder::Command& cmd) override
+	{
+		if(!listing) {
+			return;
+		}
+		char buf[256];
+		Decoder::format(cmd, buf, sizeof(buf));
+		printf("%08x  %s\n", unsigned(cmd.offset), buf);
+	}
+
+	void issue(const Decoder::Command* cmd, uint32_t offset, Decoder::Issue issue) override
+	{
+		if(listing || cmd == nullptr) {
+			printf("%08x  ** %s\n", unsigned(offset), Decoder::toString(issue));
+			return;
+		}
+		char buf[256];
+		Decoder::format(*cmd, buf, sizeof(buf));
+		printf("%08x  ** %s: %s\n", unsigned(offset), Decoder::toString(issue), buf);
+	}
+
+private:
+	bool listing;
+};
+
+bool readFile(const char* filename, std::vector<uint8_t>& data)
+{
+	auto f = fopen(filename, "rb");
+	if(f == nullptr) {
+		perror(filename);
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	data.resize(ftell(f));
+	fseek(f, 0, SEEK_SET);
+	bool ok = fread(data.data(), 1, data.size(), f) == data.size();
+	fclose(f);
+	if(!ok) {
+		fprintf(stderr, "%s: read failed\n", filename);
+	}
+	return ok;
+}
+
+uint32_t readVarint(const uint8_t*& ptr, const uint8_t* end)
+{
+	uint32_t value{0};
+	for(unsigned shift = 0; ptr < end && shift < 35; shift += 7) {
+		uint8_t c = *ptr++;
+		value |= uint32_t(c & 0x7f) << shift;
+		if(!(c & 0x80)) {
+			break;
+		}
+	}
+	return value;
+}
+
+/*
+ * Extract command FIFO writes from a payload trace. See Trace.h for format.
+ */
+bool extractCommands(const std::vector<uint8_t>& trace, std::vector<uint8_t>& commands)
+{
+	if(trace.size() < 8 || memcmp(trace.data(), "EVTR", 4) != 0 || trace[4] != 1) {
+		fprintf(stderr, "Not a trace file\n");
+		return false;
+	}
+	if(trace[5] != 1) {
+		fprintf(stderr, "Trace has no payloads\n");
+		return false;
+	}
+	auto ptr = trace.data() + 8;
+	auto end = trace.data() + trace.size();
+	while(ptr < end) {
+		uint8_t flags = *ptr++;
+		readVarint(ptr, end); // time
+		readVarint(ptr, end); // duration
+		if((flags & 0x03) == 0) {
+			ptr += 2;
+			continue;
+		}
+		if(end - ptr < 3) {
+			break;
+		}
+		uint32_t address = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16);
+		ptr += 3;
+		uint32_t length = readVarint(ptr, end);
+		if(flags & 0x08) {
+			if(uint32_t(end - ptr) < length) {
+				break;
+			}
+			bool isCommand = address == REG_CMDB_WRITE ||
+							 (address >= EVE_RAM_CMD && address < EVE_RAM_CMD + EVE_CMDFIFO_SIZE);
+			if((flags & 0x03) == 1 && isCommand) {
+				commands.insert(commands.end(), ptr, ptr + length);
+			}
+			ptr += length;
+		}
+		if(flags & 0x10) {
+			ptr += 4;
+		}
+	}
+	return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+	auto source = Decoder::Source::commands;
+	bool listing{true};
+	bool trace{false};
+	std::vector<const char*> files;
+	for(int i = 1; i < argc; ++i) {
+		if(strcmp(argv[i], "--dl") == 0) {
+			source = Decoder::Source::displayList;
+		} else if(strcmp(argv[i], "--check") == 0) {
+			listing = false;
+		} else if(strcmp(argv[i], "--trace") == 0) {
+			trace = true;
+		} else if(argv[i][0] == '-') {
+			fprintf(stderr, "Usage: %s [--dl] [--check] [--trace] FILE...\n", argv[0]);
+			return 2;
+		} else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	uint32_t totalIssues{0};
+	for(auto filename : files) {
+		std::vector<uint8_t> data;
+		if(!readFile(filename, data)) {
+			return 2;
+		}
+		if(trace) {
+			std::vector<uint8_t> commands;
+			if(!extractCommands(data, commands)) {
+				return 2;
+			}
+			data = std::move(commands);
+		}
+
+		if(files.size() > 1) {
+			printf("%s:\n", filename);
+		}
+		Printer printer(listing);
+		Decoder decoder(source, &printer);
+		auto startTime = std::chrono::steady_clock::now();
+		decoder.decode(data.data(), data.size());
+		decoder.finish();
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+		auto& stats = decoder.getStats();
+		fprintf(stderr, "%s: %llu bytes, %u display list words, %u co-processor commands, %u issues", filename,
+				(unsigned long long)stats.bytes, unsigned(stats.displayListWords),
+				unsigned(stats.coprocessorCommands), unsigned(stats.issues));
+		if(!listing && elapsed.count() > 0) {
+			fprintf(stderr, ", %.0f MB/s", data.size() / elapsed.count() / 1e6);
+		}
+		fprintf(stderr, "\n");
+		totalIssues += stats.issues;
+	}
+
+	return totalIssues ? 1 : 0;
+}
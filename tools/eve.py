@@ -154,6 +154,126 @@ class REG(IntEnum):
 	MEDIAFIFO_WRITE = 0x00309018
 
 
+@dataclass
+class RegisterDef:
+    reg: REG
+    bitcount: int
+    access: str # 'r', 'w' or 'rw'
+    reset: int = 0
+
+    @property
+    def size(self):
+        '''Transfer size in bytes'''
+        return 1 if self.bitcount <= 8 else 2 if self.bitcount <= 16 else 4
+
+
+'''Register width, access and FT812/FT813 reset value. Aliases (e.g. CTOUCH_*) share an entry.'''
+RegisterDefs: list[RegisterDef] = [
+    RegisterDef(REG.ID, 8, 'r', 0x7c),
+    RegisterDef(REG.FRAMES, 32, 'r', 0),
+    RegisterDef(REG.CLOCK, 32, 'r', 0),
+    RegisterDef(REG.FREQUENCY, 28, 'rw', 0x3938700),
+    RegisterDef(REG.RENDERMODE, 1, 'rw', 0),
+    RegisterDef(REG.SNAPY, 11, 'rw', 0),
+    RegisterDef(REG.SNAPSHOT, 1, 'rw', 0),
+    RegisterDef(REG.SNAPFORMAT, 6, 'rw', 0x20),
+    RegisterDef(REG.CPURESET, 3, 'rw', 2),
+    RegisterDef(REG.TAP_CRC, 32, 'r', 0),
+    RegisterDef(REG.TAP_MASK, 32, 'rw', 0xffffffff),
+    RegisterDef(REG.HCYCLE, 12, 'rw', 0x224),
+    RegisterDef(REG.HOFFSET, 12, 'rw', 0x2b),
+    RegisterDef(REG.HSIZE, 12, 'rw', 0x1e0),
+    RegisterDef(REG.HSYNC0, 12, 'rw', 0),
+    RegisterDef(REG.HSYNC1, 12, 'rw', 0x29),
+    RegisterDef(REG.VCYCLE, 12, 'rw', 0x124),
+    RegisterDef(REG.VOFFSET, 12, 'rw', 0xc),
+    RegisterDef(REG.VSIZE, 12, 'rw', 0x110),
+    RegisterDef(REG.VSYNC0, 10, 'rw', 0),
+    RegisterDef(REG.VSYNC1, 10, 'rw', 0xa),
+    RegisterDef(REG.DLSWAP, 2, 'rw', 0),
+    RegisterDef(REG.ROTATE, 3, 'rw', 0),
+    RegisterDef(REG.OUTBITS, 9, 'rw', 0x1b6),
+    RegisterDef(REG.DITHER, 1, 'rw', 1),
+    RegisterDef(REG.SWIZZLE, 4, 'rw', 0),
+    RegisterDef(REG.CSPREAD, 1, 'rw', 1),
+    RegisterDef(REG.PCLK_POL, 1, 'rw', 0),
+    RegisterDef(REG.PCLK, 8, 'rw', 0),
+    RegisterDef(REG.TAG_X, 11, 'rw', 0),
+    RegisterDef(REG.TAG_Y, 11, 'rw', 0),
+    RegisterDef(REG.TAG, 8, 'r', 0),
+    RegisterDef(REG.VOL_PB, 8, 'rw', 0xff),
+    RegisterDef(REG.VOL_SOUND, 8, 'rw', 0xff),
+    RegisterDef(REG.SOUND, 16, 'rw', 0),
+    RegisterDef(REG.PLAY, 1, 'rw', 0),
+    RegisterDef(REG.GPIO_DIR, 8, 'rw', 0x80),
+    RegisterDef(REG.GPIO, 8, 'rw', 0),
+    RegisterDef(REG.GPIOX_DIR, 16, 'rw', 0x8000),
+    RegisterDef(REG.GPIOX, 16, 'rw', 0x8000),
+    RegisterDef(REG.INT_FLAGS, 8, 'r', 0),
+    RegisterDef(REG.INT_EN, 1, 'rw', 0),
+    RegisterDef(REG.INT_MASK, 8, 'rw', 0xff),
+    RegisterDef(REG.PLAYBACK_START, 20, 'rw', 0),
+    RegisterDef(REG.PLAYBACK_LENGTH, 20, 'rw', 0),
+    RegisterDef(REG.PLAYBACK_READPTR, 20, 'r', 0),
+    RegisterDef(REG.PLAYBACK_FREQ, 16, 'rw', 0x1f40),
+    RegisterDef(REG.PLAYBACK_FORMAT, 2, 'rw', 0),
+    RegisterDef(REG.PLAYBACK_LOOP, 1, 'rw', 0),
+    RegisterDef(REG.PLAYBACK_PLAY, 1, 'rw', 0),
+    RegisterDef(REG.PWM_HZ, 14, 'rw', 0xfa),
+    RegisterDef(REG.PWM_DUTY, 8, 'rw', 0x80),
+    RegisterDef(REG.MACRO_0, 32, 'rw', 0),
+    RegisterDef(REG.MACRO_1, 32, 'rw', 0),
+    RegisterDef(REG.CMD_READ, 12, 'rw', 0),
+    RegisterDef(REG.CMD_WRITE, 12, 'rw', 0),
+    RegisterDef(REG.CMD_DL, 13, 'rw', 0),
+    RegisterDef(REG.TOUCH_MODE, 2, 'rw', 3),
+    RegisterDef(REG.TOUCH_ADC_MODE, 1, 'rw', 1),
+    RegisterDef(REG.TOUCH_CHARGE, 16, 'rw', 0x1770),
+    RegisterDef(REG.TOUCH_SETTLE, 4, 'rw', 3),
+    RegisterDef(REG.TOUCH_OVERSAMPLE, 4, 'rw', 7),
+    RegisterDef(REG.TOUCH_RZTHRESH, 16, 'rw', 0xffff),
+    RegisterDef(REG.TOUCH_RAW_XY, 32, 'r', 0xffffffff),
+    RegisterDef(REG.TOUCH_RZ, 16, 'r', 0x7fff),
+    RegisterDef(REG.TOUCH_SCREEN_XY, 32, 'r', 0x80008000),
+    RegisterDef(REG.TOUCH_TAG_XY, 32, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG, 8, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG1_XY, 32, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG1, 8, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG2_XY, 32, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG2, 8, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG3_XY, 32, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG3, 8, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG4_XY, 32, 'r', 0),
+    RegisterDef(REG.TOUCH_TAG4, 8, 'r', 0),
+    RegisterDef(REG.TOUCH_TRANSFORM_A, 32, 'rw', 0x10000),
+    RegisterDef(REG.TOUCH_TRANSFORM_B, 32, 'rw', 0),
+    RegisterDef(REG.TOUCH_TRANSFORM_C, 32, 'rw', 0),
+    RegisterDef(REG.TOUCH_TRANSFORM_D, 32, 'rw', 0),
+    RegisterDef(REG.TOUCH_TRANSFORM_E, 32, 'rw', 0x10000),
+    RegisterDef(REG.TOUCH_TRANSFORM_F, 32, 'rw', 0),
+    RegisterDef(REG.TOUCH_CONFIG, 16, 'rw', 0x8381),
+    RegisterDef(REG.CTOUCH_TOUCH4_X, 16, 'r', 0x8000),
+    RegisterDef(REG.BIST_EN, 1, 'rw', 0),
+    RegisterDef(REG.TRIM, 5, 'rw', 0),
+    RegisterDef(REG.ANA_COMP, 8, 'rw', 0),
+    RegisterDef(REG.SPI_WIDTH, 3, 'rw', 0),
+    RegisterDef(REG.TOUCH_DIRECT_XY, 32, 'r', 0),
+    RegisterDef(REG.TOUCH_DIRECT_Z1Z2, 32, 'r', 0),
+    RegisterDef(REG.DATESTAMP0, 32, 'r', 0),
+    RegisterDef(REG.DATESTAMP1, 32, 'r', 0),
+    RegisterDef(REG.DATESTAMP2, 32, 'r', 0),
+    RegisterDef(REG.DATESTAMP3, 32, 'r', 0),
+    RegisterDef(REG.CMDB_SPACE, 12, 'rw', 0xffc),
+    RegisterDef(REG.CMDB_WRITE, 32, 'w', 0),
+    RegisterDef(REG.TRACKER, 32, 'r', 0),
+    RegisterDef(REG.TRACKER_1, 32, 'r', 0),
+    RegisterDef(REG.TRACKER_2, 32, 'r', 0),
+    RegisterDef(REG.TRACKER_3, 32, 'r', 0),
+    RegisterDef(REG.TRACKER_4, 32, 'r', 0),
+    RegisterDef(REG.MEDIAFIFO_READ, 32, 'rw', 0),
+    RegisterDef(REG.MEDIAFIFO_WRITE, 32, 'rw', 0),
+]
+
 '''Graphics primitives (BEGIN)'''
 class GP(IntEnum):
 	BITMAPS = 1
@@ -188,6 +308,10 @@ class BitmapFormat(IntEnum):
     TEXT8X8 = 9
     TEXTVGA = 10
     BARGRAPH = 11
+    PALETTED565 = 14
+    PALETTED4444 = 15
+    PALETTED8 = 16
+    L2 = 17
 
 
 '''BITMAP_SIZE filter types'''
@@ -206,6 +330,7 @@ class BitmapWrap(IntEnum):
 class Type:
     name: str
     bitcount: int
+    signed: bool = False
 
 
 @dataclass
@@ -215,6 +340,7 @@ class Param:
     desc: str = None
     bitcount: int = None # Takes precedence over type definition
     offset: int = None # Calculated when this unit is initialised
+    align: int = None # Required alignment for addresses and lengths
 
     @property
     def size(self):
@@ -278,20 +404,22 @@ Boolean = Type('Boolean', 1)
 TestFunction = Type('TestFunction', 4)
 BlendFunction = Type('BlendFunction', 3)
 StencilOp = Type('StencilOp', 3)
-Fixed8_8 = Type('Fixed8_8', 17)
+Fixed8_8 = Type('Fixed8_8', 17, True)
+Fixed15_8 = Type('Fixed15_8', 24, True)
 DisplayListOffset = Type('DisplayListOffset', 16)
 Primitive = Type('Primitive', 4)
 
 # Used with co-processor commands
 RGB = Type('RGB', 24)
 UInt8 = Type('uint8_t', 8)
-Int16 = Type('int16_t', 16)
+Int16 = Type('int16_t', 16, True)
 UInt16 = Type('uint16_t', 16)
-Int32 = Type('int32_t', 32)
+Int32 = Type('int32_t', 32, True)
 UInt32 = Type('uint32_t', 32)
+ByteCount = Type('ByteCount', 32) # Length of memory block addressed by command
 CString = Type('CString', 0) # Variable length, NUL terminated
-Fixed16_16 = Type('Fixed16_16', 32)
-Angle = Type('Angle', 32) # Units of 1/65536 of a circle
+Fixed16_16 = Type('Fixed16_16', 32, True)
+Angle = Type('Angle', 32, True) # Units of 1/65536 of a circle
 Options = Type('Options', 16)
 
 class DataBlock(Type):
@@ -421,7 +549,7 @@ The value zero means the tag buffer is set as the default value, rather than the
         Param('b', Fixed8_8)
     ]),
 	DlCmd(0x17, 'BITMAP_TRANSFORM_C',  'Specify the C coefficient of the bitmap transform matrix', [
-        Param('c', Fixed8_8)
+        Param('c', Fixed15_8)
     ]),
 	DlCmd(0x18, 'BITMAP_TRANSFORM_D',  'Specify the D coefficient of the bitmap transform matrix', [
         Param('d', Fixed8_8)
@@ -430,7 +558,7 @@ The value zero means the tag buffer is set as the default value, rather than the
         Param('e', Fixed8_8)
     ]),
 	DlCmd(0x1A, 'BITMAP_TRANSFORM_F',  'Specify the F coefficient of the bitmap transform matrix', [
-        Param('f', Fixed8_8)
+        Param('f', Fixed15_8)
     ]),
 	DlCmd(0x1B, 'SCISSOR_XY', 'Specify the top left corner of the scissor clip rectangle', [
         Param('y', Type(None, 11)),
@@ -483,16 +611,16 @@ It is recommended to have an END for each BEGIN. However, advanced users may avo
         Param('addr', Address)
     ]),
 	DlCmd(0x2B, 'VERTEX_TRANSLATE_X', 'Specify the vertex transformations X translation component', [
-        Param('x', Type(None, 17))
+        Param('x', Type(None, 17, True))
     ]),
 	DlCmd(0x2C, 'VERTEX_TRANSLATE_Y', 'Specify the vertex transformation’s Y translation component', [
-        Param('y', Type(None, 17))
+        Param('y', Type(None, 17, True))
     ]),
 	DlCmd(0x2D, 'NOP', 'No operation'),
 	# Top 2 bits reserved for these commands
     DlCmd(0x40, 'VERTEX2F', 'Start the operation of graphics primitives at the specified screen coordinate, in the pixel precision defined by VERTEX_FORMAT.', [
-        Param('y', Type(None, 15)),
-        Param('x', Type(None, 15)),
+        Param('y', Type(None, 15, True)),
+        Param('x', Type(None, 15, True)),
     ]),
 	DlCmd(0x80, 'VERTEX2II', 'Start the operation of graphics primitive at the specified coordinates in pixel precision', [
         Param('cell', Cell),
@@ -685,7 +813,7 @@ When the coprocessor engine executes this command, it triggers interrupt, which
 	CpCmd(0x17, 'STOP', 'Stop periodic operation (SKETCH, SPINNER, SCREENSAVER)'),
 	CpCmd(0x18, 'MEMCRC', 'Compute CRC32 for block of memory', [
         Param('ptr', Address),
-        Param('num', UInt32),
+        Param('num', ByteCount),
         Param('result', UInt32), # OUT
     ]),
 	CpCmd(0x19, 'REGREAD', 'Read a register value', [
@@ -694,26 +822,26 @@ When the coprocessor engine executes this command, it triggers interrupt, which
     ]),
 	CpCmd(0x1A, 'MEMWRITE', 'Write data into memory or registers', [
         Param('ptr', Address),
-        Param('num', UInt32),
+        Param('num', ByteCount),
         Param('data', DataBlock('num')),
     ]),
 	CpCmd(0x1B, 'MEMSET', '', [
         Param('ptr', Address),
         Param('value', UInt8),
-        Param('num', UInt32),
+        Param('num', ByteCount),
     ]),
 	CpCmd(0x1C, 'MEMZERO', '', [
         Param('ptr', Address),
-        Param('num', UInt32),
+        Param('num', ByteCount),
     ]),
 	CpCmd(0x1D, 'MEMCPY', '', [
         Param('dest', Address),
         Param('src', Address),
-        Param('num', UInt32),
+        Param('num', ByteCount),
     ]),
 	CpCmd(0x1E, 'APPEND', 'Append commands from RAM_G', [
-        Param('ptr', Address),
-        Param('num', UInt32),
+        Param('ptr', Address, align=4),
+        Param('num', ByteCount, align=4),
     ]),
 	CpCmd(0x1F, 'SNAPSHOT', 'Take screen snapshot as ARGB4 bitmap', [
         Param('ptr', Address),
@@ -749,7 +877,7 @@ When the coprocessor engine executes this command, it triggers interrupt, which
 	CpCmd(0x2A, 'SETMATRIX', 'Set current matrix as bitmap transform'),
 	CpCmd(0x2B, 'SETFONT', 'Register custom-defined bitmap font', [
         Param('font', Handle),
-        Param('ptr', Address, 'Must be word-aligned')
+        Param('ptr', Address, 'Must be word-aligned', align=4)
     ]),
 	CpCmd(0x2C, 'TRACK', 'Setup tracking for graphical object', [
         Param('x', Int16),
@@ -802,15 +930,15 @@ When the coprocessor engine executes this command, it triggers interrupt, which
         Param('b', UInt8)
     ]),
 	CpCmd(0x39, 'MEDIAFIFO', 'Setup a streaming media FIFO', [
-        Param('ptr', Address),
-        Param('size', UInt32)
+        Param('ptr', Address, align=4),
+        Param('size', ByteCount, align=4)
     ]),
 	CpCmd(0x3A, 'PLAYVIDEO', 'Play MJPEG-encoded AVI video', [
         Param('options', Options)
     ]),
 	CpCmd(0x3B, 'SETFONT2', 'Setup a custom font', [
         Param('font', Handle),
-        Param('ptr', Address),
+        Param('ptr', Address, align=4),
         Param('firstchar', UInt8),
     ]),
 	CpCmd(0x3C, 'SETSCRATCH', 'Designate scratch bitmap for widgets to use', [
@@ -1,8 +1,9 @@
+import argparse
 import eve
 from eve import align
 
 
-def main():
+def listing():
 	for cmd in eve.CoprocessorCommands:
 		assert isinstance(cmd.description, str), cmd.name
 		print(f'CMD_{cmd.name}')
@@ -16,5 +17,243 @@ def main():
 			print(f'  +{param.offset} {param.typedef.name} {param.name}{s}')
 		print(f'  +{cmd.size}')
 
+
+def schema_params(cmd, coprocessor: bool) -> list[str]:
+	entries = []
+	shift = 0
+	for param in cmd.params or []:
+		bitcount = param.bitcount or param.typedef.bitcount
+		if isinstance(param.typedef, eve.DataBlock):
+			kind = 'dataBlock'
+		elif param.typedef is eve.CString:
+			kind = 'cstring'
+		elif param.typedef is eve.Address:
+			kind = 'address'
+		elif param.typedef is eve.ByteCount:
+			kind = 'length'
+		elif param.typedef is eve.RGB:
+			kind = 'color'
+		else:
+			kind = 'value'
+		flags = []
+		if param.typedef.signed:
+			flags.append('flagSigned')
+		if param.align:
+			flags.append('flagAligned')
+		length_param = -1
+		if kind == 'dataBlock' and param.typedef.length_param:
+			length_param = next(i for i, p in enumerate(cmd.params) if p.name == param.typedef.length_param)
+		if coprocessor:
+			offset = param.offset
+			if kind in ['value', 'address', 'length', 'color']:
+				bitcount = param.size * 8
+		else:
+			offset = shift
+			shift += bitcount
+		flags = ' | '.join(flags) or '0'
+		entries.append(f'{{"{param.name}", {offset}, {bitcount}, Type::{kind}, {flags}, {length_param}}}')
+	return entries
+
+
+def schema_table(prefix: str, commands: list, coprocessor: bool):
+	params = []
+	defs = []
+	for cmd in commands:
+		entries = schema_params(cmd, coprocessor)
+		ptr = f'&{prefix}Params[{len(params)}]' if entries else 'nullptr'
+		size = cmd.size if coprocessor else 4
+		defs.append(f'{{"{cmd.name}", 0x{cmd.code:02x}, {size}, {len(entries)}, {ptr}}}')
+		params += entries
+	print(f'inline constexpr Param {prefix}Params[]{{')
+	for p in params:
+		print(f'\t{p},')
+	print('};\n')
+	print(f'inline constexpr Command {prefix}Commands[]{{')
+	for d in defs:
+		print(f'\t{d},')
+	print('};\n')
+
+
+def schema_index(name: str, desc: str, commands: list, get_code):
+	index = [0xff] * 256
+	for i, cmd in enumerate(commands):
+		for byte in range(256):
+			if get_code(byte) == cmd.code:
+				index[byte] = i
+	print(f'/**\n * @brief Command table index by {desc}, 0xff if invalid\n */')
+	print(f'inline constexpr uint8_t {name}Index[256]{{')
+	for i in range(0, 256, 16):
+		print('\t' + ' '.join(f'{x:3},' for x in index[i:i+16]))
+	print('};\n')
+
+
+def dl_code(byte: int) -> int:
+	if byte & 0x80:
+		return 0x80 if (byte & 0xc0) == 0x80 else None
+	if byte & 0x40:
+		return 0x40
+	return byte
+
+
+def schema():
+	print('''/****
+ * Schema.h
+ *
+ * Command definitions for Decoder, generated from eve.py. Do not edit.
+ *
+ *   python3 tools/gen.py --schema > src/include/Graphics/EVE/Schema.h
+ *
+ ****/
+
+#pragma once
+
+#include <cstdint>
+
+namespace Graphics::EVE::Schema
+{
+enum class Type : uint8_t {
+	value,
+	address,   ///< Memory address, checked against the memory map
+	length,    ///< Size of memory block at preceding address(es)
+	color,     ///< 24-bit RGB value
+	cstring,   ///< NUL-terminated string, padded to 4-byte boundary
+	dataBlock, ///< Variable-length data, padded to 4-byte boundary
+};
+
+constexpr uint8_t flagSigned{0x01};
+constexpr uint8_t flagAligned{0x02}; ///< Value must be a multiple of 4
+
+struct Param {
+	const char* name;
+	uint8_t offset;   ///< Bit position for display list commands, byte offset for co-processor commands
+	uint8_t bitcount; ///< Value width, 0 for variable-length types
+	Type type;
+	uint8_t flags;
+	int8_t lengthParam; ///< For dataBlock, index of parameter giving length or -1 if determined by content
+};
+
+struct Command {
+	const char* name;
+	uint8_t code;
+	uint8_t size; ///< Size in bytes excluding any variable-length payload
+	uint8_t paramCount;
+	const Param* params;
+};
+''')
+	schema_table('displayList', eve.DisplayListCommands, False)
+	schema_table('coprocessor', eve.CoprocessorCommands, True)
+	schema_index('displayList', 'most significant byte of display list word', eve.DisplayListCommands, dl_code)
+	schema_index('coprocessor', 'least significant byte of co-processor command word (0xffffffxx)',
+		eve.CoprocessorCommands, lambda byte: byte)
+	print('} // namespace Graphics::EVE::Schema')
+
+
+def registers():
+	print('''/****
+ * Registers.h
+ *
+ * Register descriptors, generated from eve.py. Do not edit.
+ *
+ *   python3 tools/gen.py --registers > src/include/Graphics/EVE/Registers.h
+ *
+ ****/
+
+#pragma once
+
+#include "EVE.h"
+#include <type_traits>
+
+namespace Graphics::EVE::Registers
+{
+enum class Access : uint8_t {
+	read = 0x01,
+	write = 0x02,
+	readWrite = 0x03,
+};
+
+struct Descriptor {
+	Register address;
+	uint8_t bitcount;
+	Access access;
+	uint32_t reset; ///< Value following reset (FT812/FT813)
+
+	/**
+	 * @brief Transfer size in bytes
+	 */
+	constexpr uint8_t size() const
+	{
+		return (bitcount <= 8) ? 1 : (bitcount <= 16) ? 2 : 4;
+	}
+
+	constexpr bool canRead() const
+	{
+		return uint8_t(access) & uint8_t(Access::read);
+	}
+
+	constexpr bool canWrite() const
+	{
+		return uint8_t(access) & uint8_t(Access::write);
+	}
+
+	/**
+	 * @brief Determine whether a value fits in the register
+	 */
+	constexpr bool fits(uint32_t value) const
+	{
+		return bitcount >= 32 || (value >> bitcount) == 0;
+	}
+};
+''')
+	access = {'r': 'read', 'w': 'write', 'rw': 'readWrite'}
+	print('inline constexpr Descriptor descriptors[]{')
+	for d in eve.RegisterDefs:
+		print(f'\t{{REG_{d.reg.name}, {d.bitcount}, Access::{access[d.access]}, 0x{d.reset:x}}},')
+	print('};\n')
+	print('''constexpr const Descriptor* find(Register reg)
+{
+	for(auto& d : descriptors) {
+		if(d.address == reg) {
+			return &d;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Check that registers form a contiguous run, as required for a burst transfer
+ */
+constexpr bool isContiguous(const Register* regs, unsigned count)
+{
+	for(unsigned i = 1; i < count; ++i) {
+		if(regs[i] != regs[i - 1] + 4) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <Register reg> struct Traits {
+	static_assert(find(reg) != nullptr, "Unknown register");
+	static constexpr Descriptor descriptor = *find(reg);
+	using Value = std::conditional_t<descriptor.size() == 1, uint8_t,
+									 std::conditional_t<descriptor.size() == 2, uint16_t, uint32_t>>;
+};
+
+} // namespace Graphics::EVE::Registers''')
+
+
+def main():
+	parser = argparse.ArgumentParser(description='EVE code generator')
+	parser.add_argument('--schema', action='store_true', help='Generate command tables for Decoder')
+	parser.add_argument('--registers', action='store_true', help='Generate register descriptor table')
+	args = parser.parse_args()
+
+	if args.schema:
+		schema()
+	elif args.registers:
+		registers()
+	else:
+		listing()
+
 if __name__ == '__main__':
     main()
@@ -0,0 +1,170 @@
+'''Analyse SPI transaction traces recorded by EVE::TraceRecorder
+
+Usage:
+
+    python3 trace.py capture.bin            Summary
+    python3 trace.py capture.bin --list     Every transaction
+    python3 trace.py capture.bin --gaps 5   Five longest idle periods
+
+See `Trace.h` for the file format.
+'''
+import argparse
+import struct
+from dataclasses import dataclass
+
+KINDS = ['host', 'write', 'read']
+FLAG_ASYNC = 0x04
+FLAG_PAYLOAD = 0x08
+FLAG_HASH = 0x10
+
+ADDRESS_NAMES = {
+    0x302054: 'REG_DLSWAP',
+    0x3020a8: 'REG_INT_FLAGS',
+    0x3020f8: 'REG_CMD_READ',
+    0x3020fc: 'REG_CMD_WRITE',
+    0x302100: 'REG_CMD_DL',
+    0x302004: 'REG_FRAMES',
+    0x302188: 'REG_SPI_WIDTH',
+    0x302574: 'REG_CMDB_SPACE',
+    0x302578: 'REG_CMDB_WRITE',
+}
+
+
+def address_name(addr: int) -> str:
+    if addr in ADDRESS_NAMES:
+        return ADDRESS_NAMES[addr]
+    if addr < 0x100000:
+        return f'RAM_G+0x{addr:05x}'
+    if 0x300000 <= addr < 0x302000:
+        return f'RAM_DL+0x{addr - 0x300000:04x}'
+    if 0x302000 <= addr < 0x303000:
+        return f'REG+0x{addr - 0x302000:03x}'
+    if 0x308000 <= addr < 0x309000:
+        return f'RAM_CMD+0x{addr - 0x308000:03x}'
+    return f'0x{addr:06x}'
+
+
+@dataclass
+class Record:
+    kind: str
+    asynchronous: bool
+    time: int       # Microseconds since start of trace
+    duration: int   # Microseconds, 0 for asynchronous requests
+    address: int = 0
+    length: int = 0
+    command: int = 0
+    param: int = 0
+    payload: bytes = None
+    crc: int = None
+
+
+class Reader:
+    def __init__(self, data: bytes):
+        self.data = data
+        self.pos = 0
+
+    def bytes(self, count: int) -> bytes:
+        if self.pos + count > len(self.data):
+            raise EOFError('Trace truncated')
+        res = self.data[self.pos:self.pos + count]
+        self.pos += count
+        return res
+
+    def varint(self) -> int:
+        value, shift = 0, 0
+        while True:
+            c = self.bytes(1)[0]
+            value |= (c & 0x7f) << shift
+            if not c & 0x80:
+                return value
+            shift += 7
+
+
+def parse(data: bytes):
+    rd = Reader(data)
+    magic, version, mode = struct.unpack('<4sBBxx', rd.bytes(8))
+    if magic != b'EVTR' or version != 1:
+        raise ValueError('Not a trace file')
+    time = 0
+    while rd.pos < len(data):
+        flags = rd.bytes(1)[0]
+        time += rd.varint()
+        rec = Record(KINDS[flags & 0x03], bool(flags & FLAG_ASYNC), time, rd.varint())
+        if rec.kind == 'host':
+            rec.command, rec.param = rd.bytes(2)
+        else:
+            a = rd.bytes(3)
+            rec.address = a[0] | (a[1] << 8) | (a[2] << 16)
+            rec.length = rd.varint()
+            if flags & FLAG_PAYLOAD:
+                rec.payload = rd.bytes(rec.length)
+            if flags & FLAG_HASH:
+                rec.crc, = struct.unpack('<I', rd.bytes(4))
+        yield rec
+
+
+def describe(rec: Record) -> str:
+    if rec.kind == 'host':
+        return f'host 0x{rec.command:02x} 0x{rec.param:02x}'
+    s = f'{rec.kind:5} {address_name(rec.address):16} {rec.length:6}'
+    if rec.asynchronous:
+        s += ' async'
+    if rec.payload is not None and rec.length <= 4:
+        s += ' = 0x' + rec.payload[::-1].hex()
+    return s
+
+
+def summary(records: list):
+    if not records:
+        print('Empty trace')
+        return
+    span = records[-1].time + records[-1].duration
+    print(f'{len(records)} transactions over {span} us')
+    for kind in KINDS:
+        recs = [r for r in records if r.kind == kind]
+        if not recs:
+            continue
+        nbytes = sum(r.length for r in recs)
+        busy = sum(r.duration for r in recs)
+        print(f'  {kind:5}: {len(recs):7} transactions, {nbytes:9} bytes, {busy:9} us')
+    busy = sum(r.duration for r in records)
+    print(f'  bus busy {busy} us ({100 * busy / max(span, 1):.1f}%)')
+
+    polls = [r for r in records if r.kind == 'read' and r.address == 0x302574]
+    fifo = [r for r in records if r.kind == 'write' and r.address == 0x302578]
+    print(f'  REG_CMDB_SPACE polls {len(polls)}, FIFO bursts {len(fifo)} ({sum(r.length for r in fifo)} bytes)')
+    swaps = [r for r in records if r.kind == 'write' and r.address == 0x302054]
+    if swaps:
+        print(f'  {len(swaps)} REG_DLSWAP writes')
+
+
+def gaps(records: list, count: int):
+    idle = []
+    for prev, rec in zip(records, records[1:]):
+        idle.append((rec.time - prev.time - prev.duration, prev, rec))
+    idle.sort(key=lambda x: x[0], reverse=True)
+    for gap, prev, rec in idle[:count]:
+        print(f'{gap:9} us idle at {prev.time + prev.duration} us, after {describe(prev)}, before {describe(rec)}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='EVE SPI trace analyser')
+    parser.add_argument('input', help='Trace file')
+    parser.add_argument('--list', action='store_true', help='List all transactions')
+    parser.add_argument('--gaps', type=int, metavar='N', help='Show N longest idle periods')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        records = list(parse(f.read()))
+
+    if args.list:
+        for rec in records:
+            print(f'{rec.time:10} {rec.duration:6} {describe(rec)}')
+    if args.gaps:
+        gaps(records, args.gaps)
+    if not (args.list or args.gaps):
+        summary(records)
+
+
+if __name__ == '__main__':
+    main()